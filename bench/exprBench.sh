@@ -0,0 +1,39 @@
+#!/bin/bash
+#
+# Speed of the parse of expressions.
+#
+#   exprBench.sh bC [bC ...]
+#
+# Each compiler compiles the same main of N (default 200000) expression
+# statements from bench/gen.py exprs. Its last statement uses a variable
+# that is not declared, so the compile stops after the semantic checks
+# and the time is the scan, the parse and one walk of the tree. The best
+# wall time of RUNS (default 3) runs is printed with the MB/s it makes.
+#
+
+dir=$(cd "$(dirname "$0")" && pwd)
+n=${N:-200000}
+runs=${RUNS:-3}
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+if [ $# -eq 0 ]; then
+   echo "usage: exprBench.sh bC [bC ...]"
+   exit 2
+fi
+
+python3 "$dir/gen.py" exprs $n | sed '$d' > "$work/in.bC"
+printf '   undeclared = 1;\n}\n' >> "$work/in.bC"
+bytes=$(wc -c < "$work/in.bC")
+
+for bc in "$@"; do
+   best=
+   for ((i = 0; i < runs; i++)); do
+      start=$(date +%s%N)
+      "$bc" "$work/in.bC" > /dev/null 2>&1
+      end=$(date +%s%N)
+      best=$(awk -v a="$best" -v b=$(((end - start) / 1000)) 'BEGIN {print (a == "" || b < a) ? b : a}')
+   done
+   awk -v bc="$bc" -v us="$best" -v bytes="$bytes" \
+       'BEGIN {printf "%-40s %8.3f s %8.2f MB/s\n", bc, us / 1e6, bytes / us}'
+done
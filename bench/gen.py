@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+#
+# Makes the inputs of the benchmarks and stress tests. The same
+# arguments always make the same file.
+#
+#   gen.py scan KB [seed]    tokens of every kind, about KB kilobytes,
+#                            with the odd bad character, for the scanners
+#   gen.py lists N           N globals and a main of N statements, for
+#                            the lists built by the parser
+#   gen.py exprs N [seed]    a main of N expression statements, for the
+#                            parse of expressions
+#   gen.py ops N [seed]      N functions of 40 nested int and bool
+#                            expressions, for the operator type checks
+#   gen.py nest N [seed]     a main nesting if, while, blocks and
+#                            parentheses N deep, then N loops one after
+#                            another, for the stress tests
+#
+
+import random
+import sys
+
+KEYWORDS = ['and', 'or', 'if', 'else', 'break', 'by', 'do', 'to', 'while', 'for', 'then',
+            'return', 'not', 'char', 'int', 'static', 'bool', 'true', 'false']
+OPERATORS = [';', '{', '}', '(', ')', '<', '>', '=', ',', ':', '-', '+', '?', '*', '/', '%',
+             '\\', '[', ']', '!=', '==', '<=', '>=', '--', '++', '+=', '-=', '*=', '/=',
+             ':>:', ':<:']
+BAD = ['$', '@', '`', '!', '&', '|', '~', '^', '.', '"', "'", '#', '\r']
+
+
+def identifier(rng):
+    first = rng.choice('abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ')
+    rest = 'abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_'
+    # long ones run across the 16 and 32 byte blocks of the scanner
+    length = rng.choice([0, 1, 2, 5, 9, 15, 16, 31, 32, 33, 70])
+    word = first + ''.join(rng.choice(rest) for _ in range(length))
+    if rng.random() < 0.2:
+        # a keyword with more after it is an identifier
+        word = rng.choice(KEYWORDS) + rng.choice(['', '_', 'x', '1']) + word
+    return word
+
+
+def token(rng):
+    kind = rng.random()
+    if kind < 0.25:
+        return rng.choice(KEYWORDS)
+    if kind < 0.50:
+        return identifier(rng)
+    if kind < 0.62:
+        return str(rng.choice([0, 7, 42, 1000, rng.randrange(10 ** rng.randrange(1, 12))]))
+    if kind < 0.85:
+        return rng.choice(OPERATORS)
+    if kind < 0.90:
+        return "'" + rng.choice(['a', 'Z', ' ', '\\n', '\\0', "\\'", '\\\\', '"', '\\t']) + "'"
+    if kind < 0.96:
+        body = ''.join(rng.choice(['a', 'b', ' ', '\\n', '\\"', '\\\\', "'", 'x' * 20])
+                       for _ in range(rng.randrange(0, 12)))
+        return '"' + body + '"'
+    return rng.choice(BAD)
+
+
+def space(rng):
+    kind = rng.random()
+    if kind < 0.70:
+        return ' '
+    if kind < 0.80:
+        return ' ' * rng.randrange(2, 40)
+    if kind < 0.85:
+        return '\t' * rng.randrange(1, 5)
+    if kind < 0.92:
+        return '\n' + ' ' * rng.randrange(0, 12)
+    if kind < 0.96:
+        return ' // ' + 'comment ' * rng.randrange(0, 8) + '\n'
+    if kind < 0.98:
+        return '\n' * rng.randrange(2, 5)
+    return '\n#DRBC ' + 'directive ' * rng.randrange(0, 3) + '\n'
+
+
+def scan(kb, seed):
+    rng = random.Random(seed)
+    out = []
+    size = 0
+    while size < kb * 1024:
+        piece = token(rng) + space(rng)
+        out.append(piece)
+        size += len(piece)
+    # a comment running into the end of the file
+    out.append('// no newline at the end')
+    return ''.join(out)
+
+
+def lists(n):
+    out = ['int g%d;\n' % i for i in range(n)]
+    out.append('main()\n{\n')
+    out += ['   g%d = %d;\n' % (i, i) for i in range(n)]
+    out.append('}\n')
+    return ''.join(out)
+
+
+INT_VARS = ['a', 'b', 'c', 'x[1]', 'x[a % 4]']
+BOOL_VARS = ['p', 'q', 'r']
+
+
+def intExp(rng, depth):
+    if depth == 0 or rng.random() < 0.2:
+        return rng.choice(INT_VARS + [str(rng.randrange(1, 100))])
+    kind = rng.random()
+    if kind < 0.7:
+        op = rng.choice(['+', '-', '*', '/', '%', ':<:', ':>:'])
+        return '%s %s %s' % (intExp(rng, depth - 1), op, intExp(rng, depth - 1))
+    if kind < 0.8:
+        return '-' + intExp(rng, 0)
+    if kind < 0.9:
+        return '(' + intExp(rng, depth - 1) + ')'
+    return '?' + str(rng.randrange(2, 50))
+
+
+def boolExp(rng, depth):
+    if depth == 0 or rng.random() < 0.15:
+        return rng.choice(BOOL_VARS + ['true', 'false'])
+    kind = rng.random()
+    if kind < 0.4:
+        op = rng.choice(['<', '<=', '>', '>=', '==', '!='])
+        return '%s %s %s' % (intExp(rng, depth - 1), op, intExp(rng, depth - 1))
+    if kind < 0.8:
+        op = rng.choice(['and', 'or'])
+        return '%s %s %s' % (boolExp(rng, depth - 1), op, boolExp(rng, depth - 1))
+    if kind < 0.9:
+        return 'not ' + boolExp(rng, 0)
+    return '(' + boolExp(rng, depth - 1) + ')'
+
+
+def statement(rng, depth):
+    if rng.random() < 0.6:
+        return '%s %s %s;' % (rng.choice(INT_VARS), rng.choice(['=', '+=', '-=', '*=']), intExp(rng, depth))
+    return '%s = %s;' % (rng.choice(BOOL_VARS), boolExp(rng, depth))
+
+
+DECLS = '   int a, b, c, x[4];\n   bool p, q, r;\n'
+
+
+def exprs(n, seed):
+    rng = random.Random(seed)
+    out = ['main()\n{\n', DECLS]
+    out += ['   %s\n' % statement(rng, 4) for _ in range(n)]
+    out.append('}\n')
+    return ''.join(out)
+
+
+def ops(n, seed):
+    rng = random.Random(seed)
+    out = []
+    for i in range(n):
+        out.append('int f%d(int a, b; bool p)\n{\n   int c, x[4];\n   bool q, r;\n' % i)
+        out += ['   %s\n' % statement(rng, 5) for _ in range(40)]
+        out.append('   return a;\n}\n\n')
+    out.append('main()\n{\n   output(f0(1, 2, true));\n}\n')
+    return ''.join(out)
+
+
+def nest(n, seed):
+    rng = random.Random(seed)
+    out = ['main()\n{\n   int x, y;\n\n   x = 0;\n   y = input();\n   ']
+    closing = []
+    for _ in range(n):
+        kind = rng.random()
+        if kind < 0.35:
+            out.append('if x < y then ')
+        elif kind < 0.7:
+            out.append('while x < y do ')
+        else:
+            out.append('{ ')
+            closing.append('} ')
+        if rng.random() < 0.1:
+            out.append('\n')
+    out.append('x = ' + '(' * n + 'x + y * y' + ')' * n + ';\n')
+    out.append(''.join(reversed(closing)) + '\n')
+    out += ['   while x < %d do { x = x + y * y; }\n' % rng.randrange(1, 100) for _ in range(n)]
+    out.append('   output(x);\n}\n')
+    return ''.join(out)
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__ or 'usage: gen.py kind size [seed]')
+    kind, size = sys.argv[1], int(sys.argv[2])
+    seed = int(sys.argv[3]) if len(sys.argv) > 3 else 1
+    if kind == 'scan':
+        text = scan(size, seed)
+    elif kind == 'lists':
+        text = lists(size)
+    elif kind == 'exprs':
+        text = exprs(size, seed)
+    elif kind == 'ops':
+        text = ops(size, seed)
+    elif kind == 'nest':
+        text = nest(size, seed)
+    else:
+        sys.exit('gen.py: unknown kind ' + kind)
+    sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,42 @@
+#!/bin/bash
+#
+# TM instructions of the test programs at two optimization levels.
+#
+#   instrCount.sh [bC] [options options]
+#
+# Every program in testFiles and testFiles/regress that compiles
+# without errors is compiled with each set of options (default -O0 and
+# -O1) and run on testFiles/tm.py. The static count is the instructions
+# in the code, the executed count the instructions run, with the inputs
+# of the .in file of the program when it has one.
+#
+
+dir=$(cd "$(dirname "$0")" && pwd)
+tests=$dir/../testFiles
+bc=${1:-$dir/../sourceFiles/bC}
+before=${2:--O0}
+after=${3:--O1}
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+total=(0 0 0 0)
+
+# compile and run a program, print its static and executed counts
+count() {
+   local src=$1 opts=$2 inputs=
+
+   [ -f "${src%.bC}.in" ] && inputs=$(cat "${src%.bC}.in")
+   "$bc" $opts "$src" > "$work/p.tm" 2> /dev/null
+   grep -q "^Number of errors: 0" "$work/p.tm" || return 1
+   grep -cE '^ *[0-9]+: +[A-Z]+ ' "$work/p.tm" | tr '\n' ' '
+   python3 "$tests/tm.py" "$work/p.tm" $inputs 2>&1 > /dev/null | awk '/^steps/ {print $2}'
+}
+
+printf '%-24s %18s %18s\n' "" "static" "executed"
+printf '%-24s %8s %9s %8s %9s\n' program "$before" "$after" "$before" "$after"
+for src in "$tests"/*.bC "$tests"/regress/*.bC; do
+   a=($(count "$src" "$before")) || continue
+   b=($(count "$src" "$after")) || continue
+   printf '%-24s %8s %9s %8s %9s\n' "${src#$tests/}" ${a[0]} ${b[0]} ${a[1]} ${b[1]}
+   total=($((total[0] + a[0])) $((total[1] + b[0])) $((total[2] + a[1])) $((total[3] + b[1])))
+done
+printf '%-24s %8s %9s %8s %9s\n' total ${total[0]} ${total[1]} ${total[2]} ${total[3]}
@@ -0,0 +1,54 @@
+#!/bin/bash
+#
+# How the compile time grows with the length of the lists the parser
+# builds.
+#
+#   parseScale.sh bC [bC ...]
+#
+# Each compiler compiles bench/gen.py lists N, N globals and a main of
+# N statements, for each N in SIZES (default 10000 20000 40000 80000).
+# The best wall time of RUNS (default 3) runs is printed with its ratio
+# to the time for the N before. Linear lists double the time when N
+# doubles, quadratic ones quadruple it. Any build of bC can be given,
+# so one from before a change can be compared with one after it.
+#
+
+dir=$(cd "$(dirname "$0")" && pwd)
+sizes=${SIZES:-"10000 20000 40000 80000"}
+runs=${RUNS:-3}
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+if [ $# -eq 0 ]; then
+   echo "usage: parseScale.sh bC [bC ...]"
+   exit 2
+fi
+
+# best wall seconds of compiling a file
+bestWall() {
+   local bc=$1 src=$2 best= start end
+
+   for ((i = 0; i < runs; i++)); do
+      start=$(date +%s%N)
+      "$bc" "$src" > /dev/null 2>&1
+      end=$(date +%s%N)
+      best=$(awk -v a="$best" -v b=$(((end - start) / 1000)) 'BEGIN {print (a == "" || b < a) ? b : a}')
+   done
+   awk -v us="$best" 'BEGIN {printf "%.3f", us / 1e6}'
+}
+
+for n in $sizes; do
+   python3 "$dir/gen.py" lists $n > "$work/lists$n.bC"
+done
+
+for bc in "$@"; do
+   echo "$bc"
+   printf '%10s %10s %8s\n' N seconds ratio
+   last=
+   for n in $sizes; do
+      wall=$(bestWall "$bc" "$work/lists$n.bC")
+      ratio=$(awk -v a="$last" -v b="$wall" 'BEGIN {print (a == "" || a == 0) ? "-" : sprintf("%.2f", b / a)}')
+      printf '%10s %10s %8s\n' $n "$wall" "$ratio"
+      last=$wall
+   done
+done
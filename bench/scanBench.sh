@@ -0,0 +1,33 @@
+#!/bin/bash
+#
+# Speed of the scanner in MB/s.
+#
+#   scanBench.sh bC [bC ...]
+#
+# Each compiler scans the same 4 MB of bench/gen.py tokens with -L,
+# which runs the scanner alone, and the best of RUNS (default 5) runs is
+# printed. Build one compiler with `make CPPFLAGS="-O3 -mavx2"` and one
+# with the default to compare the AVX2 and SSE2 scanners.
+#
+
+dir=$(cd "$(dirname "$0")" && pwd)
+runs=${RUNS:-5}
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+if [ $# -eq 0 ]; then
+   echo "usage: scanBench.sh bC [bC ...]"
+   exit 2
+fi
+
+python3 "$dir/gen.py" scan 4096 1 > "$work/in.bC"
+
+for bc in "$@"; do
+   best=0
+   for ((i = 0; i < runs; i++)); do
+      # Scanned B bytes, T tokens in X ms: Y MB/s
+      speed=$("$bc" -L "$work/in.bC" 2>&1 > /dev/null | awk '/^Scanned/ {print $(NF - 1)}')
+      best=$(awk -v a="$best" -v b="${speed:-0}" 'BEGIN {print (b > a) ? b : a}')
+   done
+   printf '%-40s %8s MB/s\n' "$bc" "$best"
+done
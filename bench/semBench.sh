@@ -0,0 +1,37 @@
+#!/bin/bash
+#
+# Time of the semantic checks on code full of operators.
+#
+#   semBench.sh bC [bC ...]
+#
+# Each compiler compiles the same N (default 3000) functions of 40
+# nested int and bool expressions from bench/gen.py ops with
+# --time-report, so it must be a build that has it. The median of the
+# semantic phase over RUNS (default 11) runs is printed.
+#
+
+dir=$(cd "$(dirname "$0")" && pwd)
+n=${N:-3000}
+runs=${RUNS:-11}
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+if [ $# -eq 0 ]; then
+   echo "usage: semBench.sh bC [bC ...]"
+   exit 2
+fi
+
+python3 "$dir/gen.py" ops $n > "$work/in.bC"
+
+for bc in "$@"; do
+   : > "$work/times"
+   for ((i = 0; i < runs; i++)); do
+      "$bc" --time-report "$work/in.bC" 2>&1 > /dev/null | awk '$1 == "semantic" {print $2; exit}' >> "$work/times"
+   done
+   if [ ! -s "$work/times" ]; then
+      printf '%-40s no semantic phase in --time-report\n' "$bc"
+      continue
+   fi
+   median=$(sort -n "$work/times" | awk '{t[NR] = $1} END {print (NR % 2) ? t[(NR + 1) / 2] : (t[NR / 2] + t[NR / 2 + 1]) / 2}')
+   printf '%-40s %10s ms semantic, median of %d\n' "$bc" "$median" "$(wc -l < "$work/times")"
+done
@@ -0,0 +1,174 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Bump allocator with chunked growth used to hold the
+ * syntax tree, the token records and identifier strings for a
+ * compile so they can be released all at once
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+Arena::Arena() {
+   next = NULL;
+   limit = NULL;
+   bytesUsed = 0;
+   numAllocs = 0;
+   bytesReserved = 0;
+   phaseName = "start";
+   phaseStartBytes = 0;
+   phaseStartAllocs = 0;
+}
+
+Arena::~Arena() {
+   release();
+}
+
+/*
+ * @brief reserve a new chunk big enough for size bytes. Chunks come
+ * from calloc so everything handed out is already zeroed.
+ *
+ * @param size - bytes the caller is about to ask for
+ *
+ * @return void
+ */
+void Arena::grow(size_t size) {
+   Chunk chunk;
+
+   chunk.size = (size > ARENA_CHUNK_SIZE) ? size : ARENA_CHUNK_SIZE;
+   chunk.base = (char *)calloc(1, chunk.size);
+   if (chunk.base == NULL) {
+      printf("ERROR(SYSTEM): out of memory allocating %zu bytes for the arena\n", chunk.size);
+      exit(1);
+   }
+
+   chunks.push_back(chunk);
+   bytesReserved += chunk.size;
+   next = chunk.base;
+   limit = chunk.base + chunk.size;
+}
+
+/*
+ * @brief bump allocate zeroed memory out of the current chunk
+ *
+ * @param size - number of bytes wanted
+ *
+ * @return pointer to the memory
+ */
+void *Arena::alloc(size_t size) {
+   void *mem;
+
+   size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+   if (next == NULL || (size_t)(limit - next) < size) {
+      grow(size);
+   }
+
+   mem = next;
+   next += size;
+   bytesUsed += size;
+   numAllocs++;
+
+   return mem;
+}
+
+/*
+ * @brief copy a null terminated string into the arena
+ */
+char *Arena::copyString(const char *s) {
+   return copyString(s, strlen(s));
+}
+
+/*
+ * @brief copy len characters into the arena and null terminate them
+ */
+char *Arena::copyString(const char *s, size_t len) {
+   char *copy = (char *)alloc(len + 1);
+
+   memcpy(copy, s, len);
+   copy[len] = '\0';
+
+   return copy;
+}
+
+/*
+ * @brief finish recording the current phase and start a new one
+ *
+ * @param name - name of the phase starting now
+ *
+ * @return void
+ */
+void Arena::phase(const char *name) {
+   Phase done;
+
+   done.name = phaseName;
+   done.bytes = bytesUsed - phaseStartBytes;
+   done.allocs = numAllocs - phaseStartAllocs;
+   phases.push_back(done);
+
+   phaseName = name;
+   phaseStartBytes = bytesUsed;
+   phaseStartAllocs = numAllocs;
+}
+
+/*
+ * @brief print the bytes handed out during each phase
+ *
+ * @param out - stream to print to
+ *
+ * @return void
+ */
+void Arena::report(FILE *out) {
+   fprintf(out, "===========  Arena Usage  ===========\n");
+   for (size_t i = 0; i < phases.size(); i++) {
+      if (phases[i].allocs == 0) {
+         continue;
+      }
+      fprintf(out, "%-15s %12zu bytes %10zu allocs\n", phases[i].name, phases[i].bytes, phases[i].allocs);
+   }
+   if (numAllocs != phaseStartAllocs) {
+      fprintf(out, "%-15s %12zu bytes %10zu allocs\n", phaseName,
+            bytesUsed - phaseStartBytes, numAllocs - phaseStartAllocs);
+   }
+   fprintf(out, "%-15s %12zu bytes %10zu allocs\n", "total", bytesUsed, numAllocs);
+   fprintf(out, "%-15s %12zu bytes %10zu chunks\n", "reserved", bytesReserved, chunks.size());
+   fprintf(out, "=========== ============= ===========\n");
+}
+
+/*
+ * @brief bytes handed out since the arena was created or released
+ */
+size_t Arena::used() {
+   return bytesUsed;
+}
+
+/*
+ * @brief allocations handed out since the arena was created or released
+ */
+size_t Arena::allocs() {
+   return numAllocs;
+}
+
+/*
+ * @brief free every chunk in one shot. Every pointer handed out by
+ * the arena is invalid after this.
+ *
+ * @return void
+ */
+void Arena::release() {
+   for (size_t i = 0; i < chunks.size(); i++) {
+      free(chunks[i].base);
+   }
+   chunks.clear();
+   phases.clear();
+
+   next = NULL;
+   limit = NULL;
+   bytesUsed = 0;
+   numAllocs = 0;
+   bytesReserved = 0;
+   phaseName = "start";
+   phaseStartBytes = 0;
+   phaseStartAllocs = 0;
+}
@@ -0,0 +1,64 @@
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Bump allocator that owns every tree node, token record and
+ * identifier string made during a compile. Nothing allocated from
+ * the arena is freed on its own, the whole arena is released in one
+ * shot when the compile is finished.
+ *
+ */
+
+#include <new>
+#include <vector>
+#include <stdio.h>
+#include <stddef.h>
+
+#define ARENA_CHUNK_SIZE (64 * 1024)       // size of a normal chunk
+#define ARENA_ALIGN 16                     // every allocation is aligned to this
+
+class Arena {
+private:
+    struct Chunk {
+        char *base;                        // start of the chunk
+        size_t size;                       // bytes in the chunk
+    };
+
+    struct Phase {
+        const char *name;                  // name of the compiler phase
+        size_t bytes;                      // bytes handed out during the phase
+        size_t allocs;                     // number of allocations during the phase
+    };
+
+    std::vector<Chunk> chunks;             // every chunk ever reserved
+    char *next;                            // next free byte in the current chunk
+    char *limit;                           // end of the current chunk
+    size_t bytesUsed;                      // bytes handed out in total
+    size_t numAllocs;                      // allocations handed out in total
+    size_t bytesReserved;                  // bytes reserved from malloc in total
+    std::vector<Phase> phases;             // finished phases
+    const char *phaseName;                 // phase currently being recorded
+    size_t phaseStartBytes;                // bytesUsed when the phase started
+    size_t phaseStartAllocs;               // numAllocs when the phase started
+
+    void grow(size_t size);                // reserve a new chunk that can hold size bytes
+
+public:
+    Arena();
+    ~Arena();
+    void *alloc(size_t size);              // returns size bytes of zeroed memory
+    char *copyString(const char *s);       // copy a C string into the arena
+    char *copyString(const char *s, size_t len);  // copy len chars plus a null into the arena
+    template <class T> T *make() {         // value initialized object living in the arena
+        return new (alloc(sizeof(T))) T();
+    }
+    void phase(const char *name);          // end the current phase and start recording name
+    void report(FILE *out);                // print bytes used per phase
+    size_t used();                         // bytes handed out so far
+    size_t allocs();                       // allocations handed out so far
+    void release();                        // free everything in one shot
+};
+
+#endif
@@ -2,40 +2,25 @@
  * @author Lance Townsend
  *
  * @brief functions for code generation targeted
- * at the Tiny Virtual Machine
+ * at the Tiny Virtual Machine. The IR made by irgen is lowered an
+ * instruction at a time: each value is made in AC and pushed on the
+ * temporaries of the frame when something else has to run before it
+ * is used, or once the regalloc pass has ordered the expressions, kept
+ * in AC to AC3 and only spilled when they run out.
  */
 
 #include <stdio.h>
-#include "emitcode.h"
-#include "treeUtils.h"
-#include "semantics.h"
+#include <vector>
+#include "codegen.h"
+#include "compilerContext.h"
 #include "scanType.h"
-#include "symbolTable.h"
 #include "parser.tab.h"
 
-extern int numErrors;
-extern int numWarnings;
-extern int yyparse();
-extern int yydebug;
-extern TreeNode *syntree;
-extern char **largerTokens;
-extern void initTokenStrings();
+using namespace bc;
 
 #define OFPOFF 0
 #define RETURNOFFSET -1
 
-// Prototypes
-void codegenGeneral(TreeNode *current);
-void codegenExpression(TreeNode *current);
-void codegenDecl(TreeNode *current);
-void codegenStatement(TreeNode *current);
-
-int toffset;                    // next available termporary space
-FILE *code;                     // shared global code
-static bool linenumFlag;        // mark with line numbers
-static int breakloc;            // which while to break ot
-static SymbolTable *globals;    // global symbol table 
-
 /*
  * @brief Output basic header information about compiler
  */
@@ -46,849 +31,1118 @@ void codegenHeader(char *srcFile) {
 }
 
 /*
- * @brief Comment out line number for node
+ * @brief get offset register for different variable kinds
  */
-void commentLineNum(TreeNode *current) {
-   char buff[16];
-
-   if (linenumFlag) {
-      snprintf(buff, 16, "%d", current->lineno);
-      emitComment((char *)"Line: ", buff);
+int offsetRegister(VarKind v) {
+   switch (v) {
+      case Local:
+         return FP;
+      case Parameter:
+         return FP;
+      case Global:
+         return GP;
+      case LocalStatic:
+         return GP;
+      default:
+         diagnose(InternalError, 0, {"codegen: no offset register for the kind of a variable"});
+         return 666;
    }
-   return;
 }
 
 /*
- * @brief Generate code for library functions
+ * @brief emit the instruction of an operator
+ *
+ * @param oper - the operator token
+ * @param rd - register for the result
+ * @param ra - lhs, or the operand of a unary operator
+ * @param rb - rhs. :<: and :>: leave the result here, rd must be rb.
+ * @param rs - scratch register for NOT
+ *
+ * @return void
  */
-void codegenLibraryFun(TreeNode *current) {
-   emitComment((char *)"");
-   emitComment((char *)"** ** ** ** ** ** ** ** ** ** ** **");
-   emitComment((char *)"FUNCTION", current->attr.name);
-
-   // remember where this function is
-   current->offset = emitSkip(0);
-
-   // store return address
-   emitRM((char *)"ST", AC, RETURNOFFSET, FP, (char *)"Store return address");
-
-   if (strcmp(current->attr.name, (char *)"input") == 0) {
-      emitRO((char *)"IN", RT, RT, RT, (char *)"Grab int input");
-   } else if (strcmp(current->attr.name, (char *)"inputb") == 0) {
-      emitRO((char *)"INB", RT, RT, RT, (char *)"Grab bool input");
-   } else if (strcmp(current->attr.name, (char *)"inputc") == 0) {
-      emitRO((char *)"INC", RT, RT, RT, (char *)"Grab char input");
-   } else if (strcmp(current->attr.name, (char *)"output")==0) {
-      emitRM((char *)"LD", AC, -2, FP, (char *)"Load parameter");
-      emitRO((char *)"OUT", AC, AC, AC, (char *)"Output integer");
-   } else if (strcmp(current->attr.name, (char *)"outputb")==0) {
-      emitRM((char *)"LD", AC, -2, FP, (char *)"Load parameter");
-      emitRO((char *)"OUTB", AC, AC, AC, (char *)"Output bool");
-   } else if (strcmp(current->attr.name, (char *)"outputc")==0) {
-      emitRM((char *)"LD", AC, -2, FP, (char *)"Load parameter");
-      emitRO((char *)"OUTC", AC, AC, AC, (char *)"Output char");
-   } else if (strcmp(current->attr.name, (char *)"outnl")==0) {
-      emitRO((char *)"OUTNL", AC, AC, AC, (char *)"Output a newline");
-   } else {
-      emitComment((char *)"ERROR(LINKER): No support for special function");
-      emitComment(current->attr.name);
+static void emitOperator(int oper, int rd, int ra, int rb, int rs) {
+   switch(oper) {
+      case '+':
+         emitRO((char *)"ADD", rd, ra, rb, (char*)"Op +");
+         break;
+
+      case AND:
+         emitRO((char *)"AND", rd, ra, rb, (char*)"Op AND");
+         break;
+
+      case OR:
+         emitRO((char *)"OR", rd, ra, rb, (char*)"Op OR");
+         break;
+
+      case '-':
+         emitRO((char *)"SUB", rd, ra, rb, (char*)"Op -");
+         break;
+
+      case '*':
+         emitRO((char *)"MUL", rd, ra, rb, (char*)"Op *");
+         break;
+
+      case '/':
+         emitRO((char *)"DIV", rd, ra, rb, (char*)"Op /");
+         break;
+
+      case '%':
+         emitRO((char *)"MOD", rd, ra, rb, (char*)"Op %");
+         break;
+
+      case NEQ:
+         emitRO((char *)"TNE", rd, ra, rb, (char*)"Op !=");
+         break;
+
+      case EQ:
+         emitRO((char *)"TEQ", rd, ra, rb, (char*)"Op ==");
+         break;
+
+      case GEQ:
+         emitRO((char *)"TGE", rd, ra, rb, (char*)"Op >=");
+         break;
+
+      case LEQ:
+         emitRO((char *)"TLE", rd, ra, rb, (char*)"Op <=");
+         break;
+
+      case '<':
+         emitRO((char *)"TLT", rd, ra, rb, (char*)"Op <");
+         break;
+
+      case '>':
+         emitRO((char *)"TGT", rd, ra, rb, (char*)"Op >");
+         break;
+
+      case MIN:
+         emitRO((char *)"SWP", rb, ra, rb, (char*)"Op :<:");
+         break;
+
+      case MAX:
+         emitRO((char *)"SWP", ra, rb, rb, (char*)"Op :>:");
+         break;
+
+      case NOT:
+         emitRM((char *)"LDC", rs, 1, 6, (char *)"Load 1");
+         emitRO((char *)"XOR", rd, ra, rs, (char *)"Op XOR to get logical not");
+         break;
+
+      case '?':
+         emitRO((char *)"RND", rd, ra, 6, (char *)"Op ?");
+         break;
+
+      case SIZEOF:
+         emitRM((char *)"LD", rd, 1, ra, (char *)"Load array size");
+         break;
+
+      case CHSIGN:
+         emitRO((char *)"NEG", rd, ra, ra, (char *)"Op unary -");
+         break;
    }
+}
 
-   emitRM((char *)"LD", AC, RETURNOFFSET, FP, (char *)"Load return address");
-   emitRM((char *)"LD", FP, OFPOFF, FP, (char *)"Adjust fp");
-   emitGoto(0, AC, (char *)"Return");
+// Lowers the functions of a program one after another, the temporary
+// offset is ctx->toffset. Without the regalloc pass each value is made
+// in AC and pushed on the temporaries when something else has to run
+// before it is used. With it the values are kept in AC to AC3 and a
+// value is only spilled to the temporaries when all four are taken or
+// a call is made.
+class Lowering {
+private:
+   // a jump emitted before the block it goes to
+   struct Fixup {
+      int addr;                              // slot left for the jump
+      const IrInstr *jump;                   // the jump
+      int reg;                               // register tested by a branch
+   };
+
+   // the registers an instruction works in
+   struct Regs {
+      int d;                                 // result
+      int a, b;                              // operands
+      int s1, s2, s3;                        // scratch
+   };
+
+   const IrFunction *fn;                     // function being lowered
+   bool registers;                           // keep values in AC to AC3
+   std::vector<int> uses;                    // uses of each value not lowered yet
+   std::vector<bool> indexOf;                // value is the index of an array assignment
+   std::vector<bool> pushed;                 // value is on the temporaries rather than in AC
+   int inAC;                                 // value in AC, IR_NONE for none
+   std::vector<int> regOf;                   // register of each value, -1 if it is in none
+   std::vector<int> slotOf;                  // temporary of each spilled value
+   int holder[PC];                           // value in each register, IR_NONE for none
+   std::vector<int> spills;                  // spilled values, the last is lowest on the temporaries
+   std::vector<int> blockAddr;               // address of each block, -1 until it is reached
+   std::vector<std::vector<Fixup>> fixups;   // jumps waiting for each block
+   std::vector<int> callToffset;             // temporary offset of each call being made
+
+   const IrInstr *nextInstr(const IrBlock &block, size_t index);
+   void push(const IrBlock &block, size_t index);
+   void pop(const IrInstr &instr);
+   bool dies(const IrInstr &instr, int value);
+   void spill(int reg);
+   int take(unsigned &locked);
+   int operand(int value, unsigned &locked);
+   int reuse(const IrInstr &instr, int value, unsigned &locked);
+   int writable(const IrInstr &instr, int value, int reg, unsigned &locked);
+   Regs stackRegs(const IrInstr &instr);
+   Regs allocRegs(const IrInstr &instr);
+   void release(const IrInstr &instr, const Regs &r);
+   void jump(const IrInstr &instr, int reg);
+   void patch(const Fixup &fixup);
+   void update(const IrInstr &instr, const Regs &r);
+   void updateElem(const IrInstr &instr, const Regs &r);
+   void lowerInstr(const IrInstr &instr, const Regs &r);
+
+public:
+   Lowering(bool registers) : fn(NULL), registers(registers), inAC(IR_NONE) {}
+   void lowerFunction(const IrFunction &function);
+};
 
-   emitComment((char *)"END FUNCTION", current->attr.name);
+/*
+ * @brief next instruction of a block that makes code
+ *
+ * @param block - block being lowered
+ * @param index - instruction to start after
+ *
+ * @return the instruction, NULL at the end of the block
+ */
+const IrInstr *Lowering::nextInstr(const IrBlock &block, size_t index) {
+   for (size_t i = index + 1; i < block.instrs.size(); i++) {
+      if (block.instrs[i].op != IrComment && block.instrs[i].op != IrCommentInt) {
+         return &block.instrs[i];
+      }
+   }
 
-   return;
+   return NULL;
 }
 
 /*
- * @brief generate code and emit all parameters for function calls
+ * @brief push the value in AC on the temporaries if it is still needed
+ * and the next instruction does not use it from AC. The operand taken
+ * from AC is the second of two, or the only one.
+ *
+ * @param block - block being lowered
+ * @param index - instruction just lowered
+ *
+ * @return void
  */
-void emitParams(TreeNode *current) {
-   int params = 1;
-   char paramsStr[10];
-   TreeNode *tmp = current;
-
-   while (tmp != NULL) {
-      snprintf(paramsStr, 10, "%d", params);
-      emitComment((char *)"Param", paramsStr);
-      codegenExpression(tmp);
-      emitRM((char *)"ST", AC, toffset, FP, (char *)"Push parameter");
-      toffset--;
-      emitComment((char *)"TOFF dec:", toffset);
-      params++;
-      
-      tmp = tmp->sibling;
+void Lowering::push(const IrBlock &block, size_t index) {
+   const IrInstr *next;
+   int used[2], count;
+
+   if (inAC == IR_NONE || uses[inAC] == 0) {
+      return;
+   }
+   next = nextInstr(block, index);
+   if (next != NULL) {
+      count = irUses(*next, used);
+      if (count > 0 && used[count - 1] == inAC) {
+         return;
+      }
    }
 
-   return;
+   emitRM((char *)"ST", AC, ctx->toffset, FP, (char *)(indexOf[inAC] ? "Push index" : "Push left side"));
+   ctx->toffset--;
+   emitComment((char *)"TOFF dec:", ctx->toffset);
+   pushed[inAC] = true;
+   inAC = IR_NONE;
 }
 
 /*
- * @brief get offset register for different variable kinds
+ * @brief pop the first of two operands into AC1
+ *
+ * @param instr - instruction using it
+ *
+ * @return void
  */
-int offsetRegister(VarKind v) {
-   switch (v) {
-      case Local:
-         return FP;
-      case Parameter:
-         return FP;
-      case Global:
-         return GP;
-      case LocalStatic:
-         return GP;
-      default:
-         printf("ERROR(codegen): looking up offset register for a variable of type %d\n", v);
-         return 666;
+void Lowering::pop(const IrInstr &instr) {
+   if (!pushed[instr.a]) {
+      diagnose(InternalError, 0, {"codegen: left operand was not pushed"});
+      return;
    }
+   pushed[instr.a] = false;
+
+   ctx->toffset++;
+   emitComment((char *)"TOFF inc:", ctx->toffset);
+   emitRM((char *)"LD", AC1, ctx->toffset, FP,
+          (char *)((instr.op == IrUpdateElem) ? "Pop index" : "Pop left into ac1"));
 }
 
 /*
- * @brief Generate code for functions
+ * @brief is an instruction the last use of a value
  */
-void codegenFun(TreeNode *current) {
-   emitComment((char *)"");
-   emitComment((char *)"** ** ** ** ** ** ** ** ** ** ** **");
-   emitComment((char *)"FUNCTION", current->attr.name);
-   toffset = current->size;
-   emitComment((char *)"TOFF set:", toffset);
-
-   // IMPORTANT: For function nodes, the offset is defined to be the
-   // position of the function in the code space. This is accesible
-   // via the symbol table.
-   current->offset = emitSkip(0); // offset holds the instruction address
-
-   // store return address
-   emitRM((char *)"ST", AC, RETURNOFFSET, FP, (char *)"Store return address");
-
-   // generate code for the statements
-   codegenGeneral(current->child[1]);
-
-   // in case there was no return statement, set return register to 0 and return
-   emitComment((char *)"Add standard closing in case there is no return statement");
-   emitRM((char *)"LDC", RT, 0, 6, (char *)"Set return value to 0");
-   emitRM((char *)"LD", AC, RETURNOFFSET, FP, (char *)"Load return address");
-   emitRM((char *)"LD", FP, OFPOFF, FP, (char *)"Adjust fp");
-   emitGoto(0, AC, (char *)"Return");
-   emitComment((char *)"END FUNCTION", current->attr.name);
+bool Lowering::dies(const IrInstr &instr, int value) {
+   return uses[value] == (instr.a == value) + (instr.b == value);
+}
 
-   return;
+/*
+ * @brief move the value in a register onto the temporaries
+ *
+ * @param reg - register to free
+ *
+ * @return void
+ */
+void Lowering::spill(int reg) {
+   int value = holder[reg];
+
+   emitRM((char *)"ST", reg, ctx->toffset, FP, (char *)"Spill value");
+   slotOf[value] = ctx->toffset;
+   spills.push_back(value);
+   ctx->toffset--;
+   emitComment((char *)"TOFF dec:", ctx->toffset);
+
+   regOf[value] = -1;
+   holder[reg] = IR_NONE;
 }
 
 /*
- * @brief Generate code for statements 
+ * @brief a free register, the value made earliest is spilled when all
+ * are taken. The register is locked for the rest of the instruction.
+ *
+ * @param locked - registers the instruction has taken, by bit
+ *
+ * @return the register
  */
-void codegenStatement(TreeNode *current) {
-   commentLineNum(current);
-   int savedToffset;
-   int currloc, skiploc, skiploc2;
-
-   switch (current->kind.stmt) {
-      case IfK:
-         emitComment((char *)"IF");
-         codegenExpression(current->child[0]);
-         skiploc = emitSkip(1);
-         emitComment((char *)"THEN");
-         codegenGeneral(current->child[1]);
-
-         if (current->child[2] != NULL) {
-            skiploc2 = emitSkip(1);
-         }
+int Lowering::take(unsigned &locked) {
+   int victim = -1;
 
-         backPatchAJumpToHere((char *)"JZR", AC, skiploc, (char *)"Jump around the THEN if false [backpatch]");
+   for (int reg = AC; reg <= AC3; reg++) {
+      if (locked & (1u << reg)) {
+         continue;
+      }
+      if (holder[reg] == IR_NONE) {
+         locked |= 1u << reg;
+         return reg;
+      }
+      if (victim < 0 || holder[reg] < holder[victim]) {
+         victim = reg;
+      }
+   }
 
-         if (current->child[2] != NULL) {
-            emitComment((char *)"ELSE");
-            codegenGeneral(current->child[2]);
-            backPatchAJumpToHere(skiploc2, (char *)"Jump around the ELSE [backpatch]");
-         }
-         
-         emitComment((char *)"END IF");
+   if (victim < 0) {
+      diagnose(InternalError, 0, {"codegen: out of registers"});
+      return AC;
+   }
+   spill(victim);
+   locked |= 1u << victim;
+
+   return victim;
+}
+
+/*
+ * @brief the register of an operand, reloading it if it was spilled
+ *
+ * @param value - the operand
+ * @param locked - registers the instruction has taken, by bit
+ *
+ * @return the register
+ */
+int Lowering::operand(int value, unsigned &locked) {
+   int reg = regOf[value];
+
+   if (reg >= 0) {
+      locked |= 1u << reg;
+      return reg;
+   }
+
+   reg = take(locked);
+   for (size_t i = 0; i < spills.size(); i++) {
+      if (spills[i] == value) {
+         spills[i] = IR_NONE;
          break;
+      }
+   }
+   emitRM((char *)"LD", reg, slotOf[value], FP, (char *)"Reload value");
+   while (!spills.empty() && spills.back() == IR_NONE) {
+      spills.pop_back();
+      ctx->toffset++;
+      emitComment((char *)"TOFF inc:", ctx->toffset);
+   }
+   regOf[value] = reg;
+   holder[reg] = value;
+
+   return reg;
+}
 
-      case WhileK:
+/*
+ * @brief register for a result written after the operands are read,
+ * the register of an operand this is the last use of if there is one
+ *
+ * @param instr - instruction making the result
+ * @param value - operand to reuse, IR_NONE to take a free register
+ * @param locked - registers the instruction has taken, by bit
+ *
+ * @return the register
+ */
+int Lowering::reuse(const IrInstr &instr, int value, unsigned &locked) {
+   if (value != IR_NONE && dies(instr, value)) {
+      return regOf[value];
+   }
 
-         emitComment((char *)"WHILE");
+   return take(locked);
+}
 
-         // return here to do the test 
-         currloc = emitSkip(0);
-         
-         // test expression
-         codegenExpression(current->child[0]); 
+/*
+ * @brief register of an operand the instruction writes, a copy if the
+ * value is used again
+ *
+ * @param instr - instruction writing it
+ * @param value - the operand
+ * @param reg - its register
+ * @param locked - registers the instruction has taken, by bit
+ *
+ * @return the register
+ */
+int Lowering::writable(const IrInstr &instr, int value, int reg, unsigned &locked) {
+   int copy;
 
-         emitRM((char *)"JNZ", AC, 1, PC, (char *)"Jump to while part");
-         emitComment((char *)"DO");
+   if (dies(instr, value)) {
+      return reg;
+   }
+   copy = take(locked);
+   emitRM((char *)"LDA", copy, 0, reg, (char *)"Copy value");
 
-         // save old break statement return point
-         skiploc = breakloc;
+   return copy;
+}
 
-         // address of instruction that jumps to end of loop, 
-         // also the backpatch point
-         breakloc = emitSkip(1);
+/*
+ * @brief registers of an instruction without the regalloc pass, the
+ * first of two operands is popped into AC1
+ */
+Lowering::Regs Lowering::stackRegs(const IrInstr &instr) {
+   Regs r = {AC, AC, AC, AC1, AC2, AC3};
 
-         // do body of loop
-         codegenGeneral(current->child[1]);
+   if (instr.b != IR_NONE) {
+      r.a = AC1;
+   }
+   switch (instr.op) {
+      case IrUpdateElem:
+         r.s1 = AC2;
+         r.s2 = AC1;
+         break;
 
-         emitGotoAbs(currloc, (char *)"go to beginning of loop");
+      case IrForTest:
+         r.s1 = (instr.a == IR_NONE) ? AC1 : AC2;
+         r.s2 = AC2;
+         break;
 
-         // backpatch jump to end of loop
-         backPatchAJumpToHere(breakloc, (char *)"Jump past loop [backpatch]");
+      case IrForStep:
+         r.s1 = AC;
+         r.s2 = AC2;
+         break;
 
-         // restore break statement
-         breakloc = skiploc;
-         emitComment((char *)"END WHILE");
+      case IrForNext:
+         r.s1 = AC2;
+         break;
 
+      default:
          break;
+   }
 
-      case ForK:
-         int startoff, stopoff, stepoff;
-         TreeNode *loopindex;
+   return r;
+}
 
-         savedToffset = toffset;
-         toffset = current->size;
+/*
+ * @brief choose the registers of an instruction, reloading the
+ * operands that were spilled and spilling what is in the way
+ *
+ * @param instr - instruction to lower
+ *
+ * @return its registers
+ */
+Lowering::Regs Lowering::allocRegs(const IrInstr &instr) {
+   Regs r = {-1, -1, -1, -1, -1, -1};
+   unsigned locked = 0;
 
-         emitComment((char *)"TOFF set:", toffset);
-         emitComment((char *)"FOR");
+   if (instr.a != IR_NONE) {
+      r.a = operand(instr.a, locked);
+   }
+   if (instr.b != IR_NONE) {
+      r.b = operand(instr.b, locked);
+   }
 
-         loopindex = current->child[0];
-         if (loopindex == NULL) {
-            printf("ERROR(codegen) loop index is null");
-            break;
-         }
+   switch (instr.op) {
+      case IrConst:
+      case IrString:
+      case IrLoad:
+      case IrAddr:
+      case IrCall:
+      case IrInlineExit:
+         r.d = take(locked);
+         break;
 
-         startoff = loopindex->offset;
-         stopoff = startoff-1;
-         stepoff = startoff-2;
+      case IrUnary:
+         if (instr.oper == NOT) {
+            r.s1 = take(locked);
+         }
+         r.d = reuse(instr, instr.a, locked);
+         break;
 
-         // handle range statement TODO turn into function
-         if (current->child[1] == NULL) {
-            printf("ERROR(codegen) no range in loop");
-            break;
+      case IrBinary:
+         if (instr.oper == MIN || instr.oper == MAX) {
+            // SWP writes both
+            r.a = writable(instr, instr.a, r.a, locked);
+            r.b = writable(instr, instr.b, r.b, locked);
+            r.d = r.b;
          } else {
-            TreeNode *rangeNode = current->child[1];
-            codegenExpression(rangeNode->child[0]);
-            emitRM((char *)"ST", AC, startoff, FP, (char *)"save starting value in index variable");
-            codegenExpression(rangeNode->child[1]);
-            emitRM((char *)"ST", AC, stopoff, FP, (char *)"save stop value");
-
-            if (rangeNode->child[2] != NULL) {
-               codegenExpression(rangeNode->child[2]);
-            } else {
-               emitRM((char *)"LDC", AC, 1, 6, (char *)"default increment by 1");
-            }
-
-            emitRM((char *)"ST", AC, stepoff, FP, (char *)"save step value");
+            r.d = dies(instr, instr.b) ? r.b : reuse(instr, instr.a, locked);
          }
+         break;
 
-         currloc = emitSkip(0); // return here to do the test
-         emitRM((char *)"LD", AC1, startoff, FP, (char *)"loop index");
-         emitRM((char *)"LD", AC2, stopoff, FP, (char *)"stop value");
-         emitRM((char *)"LD", AC, stepoff, FP, (char *)"step value");
+      case IrElem:
+         r.d = dies(instr, instr.b) ? r.b : reuse(instr, instr.a, locked);
+         break;
 
-         emitRO((char *)"SLT", 3, 4, 5, (char *)"Op <");
+      case IrUpdate:
+         r.d = take(locked);
+         r.s1 = r.d;
+         break;
+
+      case IrUpdateElem:
+         r.s1 = take(locked);
+         if (instr.b == IR_NONE) {
+            r.d = reuse(instr, instr.a, locked);
+         } else if (instr.oper == '=') {
+            r.d = (dies(instr, instr.b) || uses[instr.dst] == 0) ? r.b : take(locked);
+         } else {
+            r.s2 = reuse(instr, instr.a, locked);
+            r.d = r.s2;
+         }
+         break;
 
-         emitRM((char *)"JNZ", 3, 1, 7, (char *)"Jump to loop body");
+      case IrArrayCopy:
+         r.s1 = take(locked);
+         r.s2 = take(locked);
+         r.s3 = take(locked);
+         break;
 
-         skiploc = breakloc;
-         breakloc = emitSkip(1);
+      case IrCallBegin:
+         // the call uses every register
+         for (int reg = AC; reg <= AC3; reg++) {
+            if (holder[reg] != IR_NONE) {
+               spill(reg);
+            }
+         }
+         break;
 
-         if (current->child[2] == NULL) {
-            printf("ERROR(codegen) compound for statement empty\n");
+      case IrForTest:
+      case IrForNext:
+         if (instr.a != IR_NONE && instr.b == IR_NONE) {
+            // a constant step, the test is read before it is written
+            r.s1 = take(locked);
+            r.d = dies(instr, instr.a) ? r.a : take(locked);
+            break;
+         }
+         if (instr.a != IR_NONE) {
+            // the test leaves its result in the step, which has the sign SLT needs
+            r.s1 = take(locked);
+            r.d = writable(instr, instr.b, r.b, locked);
             break;
          }
+         r.s1 = take(locked);
+         r.s2 = take(locked);
+         r.d = take(locked);
+         break;
 
-         codegenGeneral(current->child[2]);
+      case IrIn:
+         if (instr.dst >= 0) {
+            r.d = take(locked);
+         }
+         break;
 
-         emitComment((char *)"Bottom of loop increment and jump");
+      case IrForStep:
+         r.s1 = take(locked);
+         r.s2 = take(locked);
+         break;
 
-         emitRM((char *)"LD", AC, startoff, FP, (char *)"Load index");
-         emitRM((char *)"LD", AC2, stepoff, FP, (char *)"Load step");
+      default:
+         break;
+   }
 
-         emitRO((char *)"ADD", AC, AC, AC2, (char *)"increment");
+   return r;
+}
+
+/*
+ * @brief free the registers of the operands an instruction was the last
+ * use of and give its result its register
+ *
+ * @param instr - instruction lowered
+ * @param r - its registers
+ *
+ * @return void
+ */
+void Lowering::release(const IrInstr &instr, const Regs &r) {
+   int operands[2] = {instr.a, instr.b};
+
+   for (int value : operands) {
+      if (value != IR_NONE && uses[value] == 0 && regOf[value] >= 0) {
+         holder[regOf[value]] = IR_NONE;
+         regOf[value] = -1;
+      }
+   }
+   if (instr.dst >= 0 && uses[instr.dst] > 0) {
+      holder[r.d] = instr.dst;
+      regOf[instr.dst] = r.d;
+   }
+}
 
-         emitRM((char *)"ST", AC, startoff, FP, (char *)"store back to index");
+/*
+ * @brief emit a jump to a block. A jump back goes straight to the
+ * block, a jump ahead leaves a slot that is backpatched when the block
+ * is reached.
+ *
+ * @param instr - IrJump, IrBranchZ or IrBranchNZ
+ * @param reg - register a branch tests
+ *
+ * @return void
+ */
+void Lowering::jump(const IrInstr &instr, int reg) {
+   int addr = blockAddr[instr.target];
 
-         emitGotoAbs(currloc, (char *)"go to beginning of loop");
-         backPatchAJumpToHere(breakloc, (char *)"Jump past loop [backpatch]");
+   if (addr < 0) {
+      fixups[instr.target].push_back(Fixup{emitSkip(1), &instr, reg});
+   } else if (instr.op == IrJump) {
+      emitGotoAbs(addr, (char *)instr.c);
+   } else {
+      emitRMAbs((char *)((instr.op == IrBranchZ) ? "JZR" : "JNZ"), reg, addr, (char *)instr.c);
+   }
+}
 
-         breakloc = skiploc;
+/*
+ * @brief fill in the slot of a jump ahead to here
+ *
+ * @param fixup - the slot and the jump
+ *
+ * @return void
+ */
+void Lowering::patch(const Fixup &fixup) {
+   const IrInstr &instr = *fixup.jump;
 
-         emitComment((char *)"END LOOP");
+   if (instr.op == IrJump) {
+      backPatchAJumpToHere(fixup.addr, (char *)instr.c);
+   } else {
+      backPatchAJumpToHere((char *)((instr.op == IrBranchZ) ? "JZR" : "JNZ"), fixup.reg, fixup.addr,
+                           (char *)instr.c);
+   }
+}
 
+/*
+ * @brief emit an assignment operator on a simple variable
+ *
+ * @param instr - the IrUpdate
+ * @param r - the value is in r.a, the variable is loaded into r.s1 and
+ * the result left in r.d
+ *
+ * @return void
+ */
+void Lowering::update(const IrInstr &instr, const Regs &r) {
+   int offReg = offsetRegister(instr.var.kind);
+   int offset = instr.var.offset;
+   char *name = (char *)instr.var.name;
+
+   switch (instr.oper) {
+      case ADDASS:
+         emitRM((char *)"LD", r.s1, offset, offReg, (char *)"load lhs variable", name);
+         emitRO((char *)"ADD", r.d, r.s1, r.a, (char *)"op +=");
+         emitRM((char *)"ST", r.d, offset, offReg, (char *)"Store variable", name);
+         break;
+      case SUBASS:
+         emitRM((char *)"LD", r.s1, offset, offReg, (char *)"load lhs variable", name);
+         emitRO((char *)"SUB", r.d, r.s1, r.a, (char *)"op -=");
+         emitRM((char *)"ST", r.d, offset, offReg, (char *)"Store variable", name);
          break;
 
-      case CompoundK:
+      case DIVASS:
+         emitRM((char *)"LD", r.s1, offset, offReg, (char *)"load lhs variable", name);
+         emitRO((char *)"DIV", r.d, r.s1, r.a, (char *)"op /=");
+         emitRM((char *)"ST", r.d, offset, offReg, (char *)"Store variable", name);
+         break;
 
-         savedToffset = toffset;
-         toffset = current->size;
-         emitComment((char *)"COMPOUND");
-         emitComment((char *)"TOFF set:", toffset);
-         codegenGeneral(current->child[0]); // process inits
-         emitComment((char *)"Compound Body");
-         codegenGeneral(current->child[1]); 
-         toffset = savedToffset;
-         emitComment((char *)"TOFF set:", toffset);
-         emitComment((char *)"END COMPOUND");
+      case MULASS:
+         emitRM((char *)"LD", r.s1, offset, offReg, (char *)"load lhs variable", name);
+         emitRO((char *)"MUL", r.d, r.s1, r.a, (char *)"op *=");
+         emitRM((char *)"ST", r.d, offset, offReg, (char *)"Store variable", name);
+         break;
 
+      case DEC:
+         emitRM((char *)"LD", r.d, offset, offReg, (char *)"load lhs variable", name);
+         emitRM((char *)"LDA", r.d, -1, r.d, (char *)"decrement value of", name);
+         emitRM((char *)"ST", r.d, offset, offReg, (char *)"Store variable", name);
+         break;
 
+      case INC:
+         emitRM((char *)"LD", r.d, offset, offReg, (char *)"load lhs variable", name);
+         emitRM((char *)"LDA", r.d, 1, r.d, (char *)"increment value of", name);
+         emitRM((char *)"ST", r.d, offset, offReg, (char *)"Store variable", name);
          break;
 
-      case ReturnK:
-         emitComment((char *)"RETURN");
-         if (current->child[0] != NULL) {
-            codegenExpression(current->child[0]);
-            emitRM((char *)"LDA", 2, 0, AC, (char *)"Copy result to return register");
-         }
+      default:
+         // ERROR
+         break;
+   }
+}
 
-         emitRM((char *)"LD", AC, -1, FP, (char *)"Load return address");
-         emitRM((char *)"LD", FP, GP, FP, (char *)"Adjust fp");
-         emitGoto(GP, AC, (char *)"Return");
+/*
+ * @brief emit an assignment to an array element
+ *
+ * @param instr - the IrUpdateElem
+ * @param r - the index is in r.a and the value in r.b, the address of
+ * the element is made in r.s1, the element loaded into r.s2 and the
+ * result left in r.d
+ *
+ * @return void
+ */
+void Lowering::updateElem(const IrInstr &instr, const Regs &r) {
+   const IrVar &var = instr.var;
+   char *name = (char *)var.name;
+
+   if (var.kind == Parameter) {
+      emitRM((char *)"LD", r.s1, var.offset, FP, (char *)"Load address of base of array", name);
+   } else if (var.kind == Local) {
+      emitRM((char *)"LDA", r.s1, var.offset, FP, (char *)"Load address of base of array", name);
+   } else if (var.kind == LocalStatic || var.kind == Global) {
+      emitRM((char *)"LDA", r.s1, var.offset, GP, (char *)"Load address of base of array", name);
+   }
+
+   int op = instr.oper;
+
+   emitRO((char *)"SUB", r.s1, r.s1, r.a, (char *)"Compute offset of value");
+
+   switch(op) {
+      case INC:
+         emitRM((char *)"LD", r.d, 0, r.s1, (char *)"load lhs variable", name);
+         emitRM((char *)"LDA", r.d, 1, r.d, (char *)"increment value of", name);
+         emitRM((char *)"ST", r.d, 0, r.s1, (char *)"Store variable", name);
          break;
 
-      case BreakK:
-         emitComment((char *)"BREAK");
-         emitGotoAbs(breakloc, (char *)"break");
+      case DEC:
+         emitRM((char *)"LD", r.d, 0, r.s1, (char *)"load lhs variable", name);
+         emitRM((char *)"LDA", r.d, -1, r.d, (char *)"decrement value of", name);
+         emitRM((char *)"ST", r.d, 0, r.s1, (char *)"Store variable", name);
+         break;
 
+      case ADDASS:
+         emitRM((char *)"LD", r.s2, 0, r.s1, (char *)"load lhs variable", name);
+         emitRO((char *)"ADD", r.d, r.s2, r.b, (char *)"op +=");
+         emitRM((char *)"ST", r.d, 0, r.s1, (char *)"Store variable", name);
          break;
 
-      case RangeK:
-         // do nothing
+      case SUBASS:
+         emitRM((char *)"LD", r.s2, 0, r.s1, (char *)"load lhs variable", name);
+         emitRO((char *)"SUB", r.d, r.s2, r.b, (char *)"op -=");
+         emitRM((char *)"ST", r.d, 0, r.s1, (char *)"Store variable", name);
          break;
 
-      default:
+      case DIVASS:
+         emitRM((char *)"LD", r.s2, 0, r.s1, (char *)"load lhs variable", name);
+         emitRO((char *)"DIV", r.d, r.s2, r.b, (char *)"op /=");
+         emitRM((char *)"ST", r.d, 0, r.s1, (char *)"Store variable", name);
          break;
 
-   }    
+      case MULASS:
+         emitRM((char *)"LD", r.s2, 0, r.s1, (char *)"load lhs variable", name);
+         emitRO((char *)"MUL", r.d, r.s2, r.b, (char *)"op *=");
+         emitRM((char *)"ST", r.d, 0, r.s1, (char *)"Store variable", name);
+         break;
 
-   return;
+      default:
+         emitRM((char *)"ST", r.b, 0, r.s1, (char *)"Store variable", name);
+         if (r.d != r.b) {
+            emitRM((char *)"LDA", r.d, 0, r.b, (char *)"Copy value");
+         }
+         break;
+   }
 }
 
 /*
- * @brief Generate code for expressions
+ * @brief emit the code of one instruction
+ *
+ * @param instr - instruction to lower
+ * @param r - registers it works in
+ *
+ * @return void
  */
-void codegenExpression(TreeNode *current) {
-   commentLineNum(current);
-
-   switch (current->kind.exp) {
-      case AssignK:
-         {
-            TreeNode *lhs = current->child[0], *rhs = current->child[1];
-            int offReg;
-
-            if (lhs->attr.op == '[') {
-               // TODO
-               lhs->isArray = true;
-               TreeNode *var = lhs->child[0], *index = lhs->child[1];
-               offReg = offsetRegister(var->varKind);
-
-               if (var == NULL) {
-                  printf("ERROR(codegenExpression) var is NULL\n");
-                  break;
-               }
-               if (index == NULL) {
-                  printf("ERROR(codegenExpression) var is NULL\n");
-                  break;
-               }
-
-               codegenExpression(index);
-
-               if (rhs != NULL) {
-                  emitRM((char *)"ST", AC, toffset, FP, (char *)"Push index");
-                  toffset--;
-                  emitComment((char *)"TOFF dec:", toffset);
-                  codegenExpression(rhs);
-                  toffset++;
-                  emitComment((char *)"TOFF inc:", toffset);
-                  emitRM((char *)"LD", AC1, toffset, FP, (char *)"Pop index");
-               }
-               
-               if (var->varKind == Parameter) {
-                  emitRM((char *)"LD", AC2, var->offset, FP, (char *)"Load address of base of array", var->attr.name);
-               } else if (var->varKind == Local) {
-                  emitRM((char *)"LDA", AC2, var->offset, FP, (char *)"Load address of base of array", var->attr.name);
-               } else if (var->varKind == LocalStatic || var->varKind == Global) {
-                  emitRM((char *)"LDA", AC2, var->offset, GP, (char *)"Load address of base of array", var->attr.name);
-               }
-               
-               int op = current->attr.op;
-
-               if (op == INC || op == DEC) {
-                  emitRO((char *)"SUB", AC2, AC2, AC, (char *)"Compute offset of value");
-               } else {
-                  emitRO((char *)"SUB", AC2, AC2, AC1, (char *)"Compute offset of value");
-               }
-               
-               switch(op) {
-                  case INC:
-                     emitRM((char *)"LD", AC, 0, 5, (char *)"load lhs variable", var->attr.name);
-                     emitRM((char *)"LDA", AC, 1, AC, (char *)"increment value of", var->attr.name);
-                     emitRM((char *)"ST", AC, 0, AC2, (char *)"Store variable", var->attr.name);
-                     break;
-
-                  case DEC:
-                     emitRM((char *)"LD", AC, 0, 5, (char *)"load lhs variable", var->attr.name);
-                     emitRM((char *)"LDA", AC, -1, AC, (char *)"decrement value of", var->attr.name);
-                     emitRM((char *)"ST", AC, 0, AC2, (char *)"Store variable", var->attr.name);
-                     break;
-
-                  case ADDASS:
-                     emitRM((char *)"LD", AC1, 0, 5, (char *)"load lhs variable", var->attr.name);
-                     emitRO((char *)"ADD", AC, AC1, AC, (char *)"op +=");
-                     emitRM((char *)"ST", AC, 0, 5, (char *)"Store variable", var->attr.name);
-                     break;
-
-                  case SUBASS:
-                     emitRM((char *)"LD", AC1, 0, 5, (char *)"load lhs variable", var->attr.name);
-                     emitRO((char *)"SUB", AC, AC1, AC, (char *)"op -=");
-                     emitRM((char *)"ST", AC, 0, 5, (char *)"Store variable", var->attr.name);
-                     break;
-
-                  case DIVASS:
-                     emitRM((char *)"LD", AC1, 0, 5, (char *)"load lhs variable", var->attr.name);
-                     emitRO((char *)"DIV", AC, AC1, AC, (char *)"op /=");
-                     emitRM((char *)"ST", AC, 0, 5, (char *)"Store variable", var->attr.name);
-                     break;
-
-                  case MULASS:
-                     emitRM((char *)"LD", AC1, 0, 5, (char *)"load lhs variable", var->attr.name);
-                     emitRO((char *)"MUL", AC, AC1, AC, (char *)"op *=");
-                     emitRM((char *)"ST", AC, 0, 5, (char *)"Store variable", var->attr.name);
-                     break;
-
-                  default:
-                     emitRM((char *)"ST", AC, 0, 5, (char *)"Store variable", var->attr.name);
-                     break;
-               }
-               
-
-            } else {
-               offReg = offsetRegister(lhs->varKind);
-
-               if (rhs) {
-                  codegenExpression(rhs);
-               }
-   
-               switch (current->attr.op) {
-                  case ADDASS:
-                     emitRM((char *)"LD", AC1, lhs->offset, offReg, (char *)"load lhs variable", lhs->attr.name);
-                     emitRO((char *)"ADD", AC, AC1, AC, (char *)"op +=");
-                     emitRM((char *)"ST", AC, lhs->offset, offReg, (char *)"Store variable", lhs->attr.name);
-                     break;
-                  case SUBASS:
-                     emitRM((char *)"LD", AC1, lhs->offset, offReg, (char *)"load lhs variable", lhs->attr.name);
-                     emitRO((char *)"SUB", AC, AC1, AC, (char *)"op -=");
-                     emitRM((char *)"ST", AC, lhs->offset, offReg, (char *)"Store variable", lhs->attr.name);
-                     break;
-                  
-                  case DIVASS:
-                     emitRM((char *)"LD", AC1, lhs->offset, offReg, (char *)"load lhs variable", lhs->attr.name);
-                     emitRO((char *)"DIV", AC, AC1, AC, (char *)"op /=");
-                     emitRM((char *)"ST", AC, lhs->offset, offReg, (char *)"Store variable", lhs->attr.name);
-                     break;
-   
-                  case MULASS:
-                     emitRM((char *)"LD", AC1, lhs->offset, offReg, (char *)"load lhs variable", lhs->attr.name);
-                     emitRO((char *)"MUL", AC, AC1, AC, (char *)"op *=");
-                     emitRM((char *)"ST", AC, lhs->offset, offReg, (char *)"Store variable", lhs->attr.name);
-                     break;
-
-                  case '=':
-                     emitRM((char *)"ST", AC, lhs->offset, offReg, (char *)"Store variable", lhs->attr.name);
-                     break;
-
-                  case DEC:
-                     emitRM((char *)"LD", AC, lhs->offset, offReg, (char *)"load lhs variable", lhs->attr.name);
-                     emitRM((char *)"LDA", AC, -1, AC, (char *)"decrement value of", lhs->attr.name);
-                     emitRM((char *)"ST", AC, lhs->offset, offReg, (char *)"Store variable", lhs->attr.name);
-                     break;
-
-                  case INC:
-                     emitRM((char *)"LD", AC, lhs->offset, offReg, (char *)"load lhs variable", lhs->attr.name);
-                     emitRM((char *)"LDA", AC, 1, AC, (char *)"increment value of", lhs->attr.name);
-                     emitRM((char *)"ST", AC, lhs->offset, offReg, (char *)"Store variable", lhs->attr.name);
-                     break;
-
-                  default:
-                     // ERROR
-                     break;
-               }
-               
-            }
-            break;
+void Lowering::lowerInstr(const IrInstr &instr, const Regs &r) {
+   static const char *inOps[] = {"IN", "IN", "INB", "INC", "IN"};
+   static const char *outOps[] = {"OUT", "OUT", "OUTB", "OUTC", "OUT"};
+   char *c = (char *)(instr.c ? instr.c : "");
+   char *cc = (char *)(instr.cc ? instr.cc : "");
+   char *funcName = instr.func ? instr.func->attr.name : NULL;
+   int saved, reg;
+
+   switch (instr.op) {
+      case IrComment:
+         if (instr.cc == NULL) {
+            emitComment(c);
+         } else {
+            emitComment(c, cc);
          }
+         break;
 
-      case CallK:
-      {
-         emitComment((char *)"CALL", current->attr.name);
-         
-         TreeNode *funcNode = (TreeNode *)globals->lookup(current->attr.name);
-         int savedToffset = toffset;
-         int callLoc = funcNode->offset;
-
-         emitRM((char *)"ST", FP, toffset, FP, (char *)"Store fp in ghost frame for", current->attr.name);
-         toffset--;
-         emitComment((char *)"TOFF dec:", toffset);
-         toffset--;
-         emitComment((char *)"TOFF dec:", toffset);
+      case IrCommentInt:
+         emitComment(c, (int)instr.imm);
+         break;
 
-         emitParams(current->child[0]);
+      case IrTempTop:
+         ctx->toffset = instr.imm;
+         if (instr.c != NULL) {
+            emitComment(c, ctx->toffset);
+         }
+         break;
 
-         emitComment((char *)"Param end", current->attr.name);
+      case IrEnter:
+         // IMPORTANT: For function nodes, the offset is defined to be the
+         // position of the function in the code space. This is accesible
+         // via the symbol table.
+         fn->decl->offset = emitSkip(0);
 
-         emitRM((char *)"LDA", FP, savedToffset, FP, (char *)"Ghost frame becomes new active frame");
-         emitRM((char *)"LDA", AC, FP, 7, (char *)"Return address in ac");
-         emitRMAbs((char *)"JMP", PC, callLoc, (char *)"CALL", current->attr.name);
-         emitRM((char *)"LDA", AC, 0, 2, (char *)"Save the result in ac");
+         // store return address
+         emitRM((char *)"ST", AC, RETURNOFFSET, FP, c);
+         break;
 
-         emitComment((char *)"Call end", current->attr.name);
-         toffset = savedToffset;
+      case IrInit:
+         emitRM((char *)"LDA", FP, instr.imm, GP, (char *)"set first frame at end of globals");
+         emitRM((char *)"ST", FP, 0, FP, (char *)"store old fp (point to self)");
+         break;
 
-         emitComment((char *)"TOFF set:", toffset);
+      case IrConst:
+         emitRM((char *)"LDC", r.d, instr.imm, AC3, c, cc);
+         break;
 
+      case IrString:
+         emitStrLit(instr.var.offset, (char *)instr.string);
+         emitRM((char *)"LDA", r.d, instr.var.offset, GP, c, cc);
          break;
-      }
 
-      case ConstantK:
-         if (current->type == Char) {
-            if (current->isArray) {
-               emitStrLit(current->offset, current->attr.string);
-               emitRM((char *)"LDA", AC, current->offset, GP, (char *)"Load address of char array");
-            } else {
-               emitRM((char *)"LDC", AC, int(current->attr.cvalue), AC3, (char *)"Load char constant");
-            }
-         } else if (current->type == Boolean) {
-            emitRM((char *)"LDC", AC, current->attr.value, AC3, (char *)"Load Boolean constant");
-         } else if (current->type == Integer) {
-            emitRM((char *)"LDC", AC, current->attr.value, AC3, (char *)"Load integer constant");
-         }
+      case IrLoad:
+         emitRM((char *)"LD", r.d, instr.var.offset, offsetRegister(instr.var.kind), c, cc);
+         break;
 
+      case IrAddr:
+         emitRM((char *)((instr.var.kind == Parameter) ? "LD" : "LDA"), r.d, instr.var.offset,
+                offsetRegister(instr.var.kind), c, cc);
          break;
 
-      case IdK:
-         if (current->isArray) {
-            int offReg = offsetRegister(current->varKind);
+      case IrStore:
+         emitRM((char *)"ST", r.a, instr.var.offset, offsetRegister(instr.var.kind), c, cc);
+         break;
 
-            if (current->varKind == Parameter) {
-               emitRM((char *)"LD", AC, current->offset, offReg, (char *)"Load address of base of array", current->attr.name);
-            } else {
-               emitRM((char *)"LDA", AC, current->offset, offReg, (char *)"Load address of base of array", current->attr.name);
-            }
-         } else {
-            int offReg = offsetRegister(current->varKind);
-            emitRM((char *)"LD", AC, current->offset, offReg, (char *)"Load variable", current->attr.name);
-         }
+      case IrUnary:
+         emitOperator(instr.oper, r.d, r.a, r.a, r.s1);
          break;
 
-      case OpK:
-         if (current->child[0]) {
-            codegenExpression(current->child[0]);
+      case IrBinary:
+         if (!registers) {
+            pop(instr);
          }
+         emitOperator(instr.oper, r.d, r.a, r.b, r.s1);
+         break;
 
-         if (current->child[1]) {
-            emitRM((char *)"ST", AC, toffset, FP, (char *)"Push left side");
-            toffset--; 
-            emitComment((char *)"TOFF dec:", toffset);
-            codegenExpression(current->child[1]);
-            toffset++;
-            emitComment((char *)"TOFF inc:", toffset);
-            emitRM((char *)"LD", AC1, toffset, FP, (char *)"Pop left into ac1");
-
-            if (current->isArray) {
-               emitRO((char *)"SUB", AC, AC1, AC, (char *)"compute location from index");
-               emitRM((char *)"LD", AC, GP, AC, (char *)"Load array element");
-            }
+      case IrElem:
+         if (!registers) {
+            pop(instr);
          }
+         emitRO((char *)"SUB", r.d, r.a, r.b, (char *)"compute location from index");
+         emitRM((char *)"LD", r.d, GP, r.d, (char *)"Load array element");
+         break;
 
-          switch(current->attr.op) {
-            case '+':
-               emitRO((char *)"ADD", AC, AC1, AC, (char*)"Op +");
-               break;
+      case IrUpdate:
+         update(instr, r);
+         break;
 
-            case AND:
-               emitRO((char *)"AND", AC, AC1, AC, (char*)"Op AND");
-               break;
+      case IrUpdateElem:
+         if (!registers && instr.b != IR_NONE) {
+            pop(instr);
+         }
+         updateElem(instr, r);
+         break;
 
-            case OR:
-               emitRO((char *)"OR", AC, AC1, AC, (char*)"Op OR");
-               break;
+      case IrArrayCopy:
+         emitRM((char *)"LDA", r.s1, instr.var.offset, offsetRegister(instr.var.kind),
+               (char *)"address of lhs");
+         emitRM((char *)"LD", r.s2, 1, r.a, (char *)"size of rhs");
+         emitRM((char *)"LD", r.s3, 1, r.s1, (char *)"size of lhs");
+         emitRO((char *)"SWP", r.s2, r.s3, 6, (char *)"pick smallest size");
+         emitRO((char *)"MOV", r.s1, r.a, r.s2, (char *)"array op =");
+         break;
 
-            case '-':
-               emitRO((char *)"SUB", AC, AC1, AC, (char*)"Op -");
-               break;
+      case IrCallBegin:
+         // the parameters are pushed one by one into the ghost frame
+         emitComment((char *)"CALL", funcName);
+         callToffset.push_back(ctx->toffset);
 
-            case '*':
-               emitRO((char *)"MUL", AC, AC1, AC, (char*)"Op *");
-               break;
+         emitRM((char *)"ST", FP, ctx->toffset, FP, (char *)"Store fp in ghost frame for", funcName);
+         ctx->toffset--;
+         emitComment((char *)"TOFF dec:", ctx->toffset);
+         ctx->toffset--;
+         emitComment((char *)"TOFF dec:", ctx->toffset);
+         break;
 
-            case '/':
-               emitRO((char *)"DIV", AC, AC1, AC, (char*)"Op /");
-               break;
+      case IrArg:
+         emitRM((char *)"ST", r.a, ctx->toffset, FP, (char *)"Push parameter");
+         ctx->toffset--;
+         emitComment((char *)"TOFF dec:", ctx->toffset);
+         break;
 
-            case '%':
-               emitRO((char *)"MOD", AC, AC1, AC, (char*)"Op %");
-               break;
+      case IrCall:
+         saved = callToffset.back();
+         callToffset.pop_back();
 
-            case NEQ:
-               emitRO((char *)"TNE", AC, AC1, AC, (char*)"Op !=");
-               break;
+         emitComment((char *)"Param end", funcName);
 
-            case EQ:
-               emitRO((char *)"TEQ", AC, AC1, AC, (char*)"Op ==");
-               break;
+         emitRM((char *)"LDA", FP, saved, FP, (char *)"Ghost frame becomes new active frame");
+         emitRM((char *)"LDA", AC, 1, PC, (char *)"Return address in ac");
+         emitRMAbs((char *)"JMP", PC, instr.func->offset, (char *)"CALL", funcName);
+         emitRM((char *)"LDA", r.d, 0, RT, (char *)"Save the result in ac");
 
-            case GEQ:
-               emitRO((char *)"TGE", AC, AC1, AC, (char*)"Op >=");
-               break;
+         emitComment((char *)"Call end", funcName);
+         ctx->toffset = saved;
 
-            case LEQ:
-               emitRO((char *)"TLE", AC, AC1, AC, (char*)"Op <=");
-               break;
+         emitComment((char *)"TOFF set:", ctx->toffset);
+         break;
 
-            case '<':
-               emitRO((char *)"TLT", AC, AC1, AC, (char*)"Op <");
-               break;
+      case IrInlineEnter:
+         // the body of the function follows in place of the jump to it
+         emitComment((char *)"Param end", funcName);
+         emitRM((char *)"LDA", FP, callToffset.back(), FP, (char *)"Ghost frame becomes new active frame");
+         emitComment((char *)"INLINE", funcName);
+         break;
 
-            case '>':
-               emitRO((char *)"TGT", AC, AC1, AC, (char*)"Op >");
-               break;
+      case IrInlineExit:
+         saved = callToffset.back();
+         callToffset.pop_back();
 
-            case MIN:
-               emitRO((char *)"SWP", AC, AC1, AC, (char*)"Op :<:");
-               break;
+         emitComment((char *)"END INLINE", funcName);
+         emitRM((char *)"LD", FP, OFPOFF, FP, (char *)"Adjust fp");
+         emitRM((char *)"LDA", r.d, 0, RT, (char *)"Save the result in ac");
+         ctx->toffset = saved;
 
-            case MAX:
-               emitRO((char *)"SWP", AC1, AC, AC, (char*)"Op :>:");
-               break;
+         emitComment((char *)"TOFF set:", ctx->toffset);
+         break;
 
-            case NOT:
-               emitRM((char *)"LDC", AC1, 1, 6, (char *)"Load 1");
-               emitRO((char *)"XOR", AC, AC, AC1, (char *)"Op XOR to get logical not");
-               break;
+      case IrIn:
+         // the body of a library function reads into its return value
+         reg = (instr.dst == IR_RESULT) ? RT : r.d;
+         emitRO((char *)inOps[instr.type], reg, reg, reg, c);
+         break;
 
-            case '?':
-               emitRO((char *)"RND", AC, AC, 6, (char *)"Op ?");
-               break;
+      case IrOut:
+         emitRO((char *)outOps[instr.type], r.a, r.a, r.a, c);
+         break;
 
-            case SIZEOF:
-               emitRM((char *)"LD", AC, 1, AC, (char *)"Load array size");
-               break;
+      case IrOutNl:
+         emitRO((char *)"OUTNL", AC, AC, AC, c);
+         break;
 
-            case CHSIGN:
-               emitRO((char *)"NEG", AC, AC, AC, (char *)"Op unary -");
-               break;
+      case IrForTest:
+         if (instr.a != IR_NONE && instr.b == IR_NONE) {
+            emitRM((char *)"LD", r.s1, instr.var.offset, FP, (char *)"loop index");
+            emitRO((char *)((instr.imm > 0) ? "TLE" : "TGE"), r.d, r.s1, r.a, (char *)"Op <");
+            break;
+         }
+         if (instr.a != IR_NONE) {
+            if (!registers) {
+               pop(instr);
+            }
+            emitRM((char *)"LD", r.s1, instr.var.offset, FP, (char *)"loop index");
+            emitRO((char *)"SLT", r.d, r.s1, r.a, (char *)"Op <");
+            break;
          }
+         emitRM((char *)"LD", r.s1, instr.var.offset, FP, (char *)"loop index");
+         emitRM((char *)"LD", r.s2, instr.var.offset - 1, FP, (char *)"stop value");
+         emitRM((char *)"LD", r.d, instr.var.offset - 2, FP, (char *)"step value");
 
+         emitRO((char *)"SLT", r.d, r.s1, r.s2, (char *)"Op <");
          break;
-   }    
 
-   return;
-}
+      case IrForStep:
+         emitRM((char *)"LD", r.s1, instr.var.offset, FP, (char *)"Load index");
+         emitRM((char *)"LD", r.s2, instr.var.offset - 2, FP, (char *)"Load step");
 
-/*
- * @brief Generate code for declarations
- */
-void codegenDecl(TreeNode *current) {
-   commentLineNum(current);
-
-   switch (current->kind.decl) {
-      case VarK:
-         {
-            if (current->isArray) {
-               switch(current->varKind) {
-                  case Local:
-                     {
-                        emitRM((char *)"LDC", AC, current->size-1, 6, 
-                              (char *)"load size of array", current->attr.name);
-                        emitRM((char *)"ST", AC, current->offset+1, 
-                              offsetRegister(current->varKind), (char *)"save size of array", 
-                              current->attr.name);
-                        break;
-                     }
-
-                  case LocalStatic:
-                  case Parameter:
-                  case Global:
-                     // do nothing
-                     break;
-                  case None:
-                     // ERROR
-                     break;
-               }
-
-               // ARRAY VALUE initializatin
-               if (current->child[0]) {
-                  codegenExpression(current->child[0]);
-                  emitRM((char *)"LDA", AC1, current->offset, offsetRegister(current->varKind), 
-                        (char *)"address of lhs");
-                  emitRM((char *)"LD", AC2, 1, AC, (char *)"size of rhs");
-                  emitRM((char *)"LD", AC3, 1, AC1, (char *)"size of lhs");
-                  emitRO((char *)"SWP", AC2, AC3, 6, (char *)"pick smallest size");
-                  emitRO((char *)"MOV", AC1, AC, AC2, (char *)"array op =");
-               }
-
-            } else { /* !current->isArray */
-               // SCALAR VALUE initialization
-               if (current->child[0]) {
-                  if (current->varKind == Local) {
-                     // compute rhs -> AC
-                     codegenExpression(current->child[0]);
-
-                     // save it
-                     emitRM((char *)"ST", AC, current->offset, FP, (char *)"Store variable", current->attr.name);
-                  } else if (current->varKind == None) {
-                     // ERROR CONDITION
-                  }
-               }
-            }
+         emitRO((char *)"ADD", r.s1, r.s1, r.s2, (char *)"increment");
 
+         emitRM((char *)"ST", r.s1, instr.var.offset, FP, (char *)"store back to index");
+         break;
+
+      case IrForNext:
+         if (instr.b == IR_NONE) {
+            // the step is added as the displacement of LDA
+            emitRM((char *)"LD", r.s1, instr.var.offset, FP, (char *)"Load index");
+            emitRM((char *)"LDA", r.s1, instr.imm, r.s1, (char *)"increment");
+            emitRM((char *)"ST", r.s1, instr.var.offset, FP, (char *)"store back to index");
+            emitRO((char *)((instr.imm > 0) ? "TLE" : "TGE"), r.d, r.s1, r.a, (char *)"Op <");
             break;
          }
+         if (!registers) {
+            pop(instr);
+         }
+         emitRM((char *)"LD", r.s1, instr.var.offset, FP, (char *)"Load index");
+         emitRO((char *)"ADD", r.s1, r.s1, r.d, (char *)"increment");
+         emitRM((char *)"ST", r.s1, instr.var.offset, FP, (char *)"store back to index");
+         emitRO((char *)"SLT", r.d, r.s1, r.a, (char *)"Op <");
+         break;
 
-      case FuncK:
-         if (current->lineno == -1) {
-            codegenLibraryFun(current);
+      case IrSetRet:
+         if (instr.a != IR_NONE) {
+            emitRM((char *)"LDA", RT, 0, r.a, c);
          } else {
-            codegenFun(current);
+            emitRM((char *)"LDC", RT, instr.imm, 6, c);
          }
          break;
 
-      case ParamK:
-         // IMPORTANT: no instructions need to be made
-         // for parameters
+      case IrStart:
+         emitRM((char *)"LDA", AC, 1, PC, (char *)"Return address in ac");
+         if (instr.func != NULL) {
+            emitGotoAbs(instr.func->offset, (char *)"Jump to main");
+         } else {
+            diagnose(NoMainProcedure, 0);
+         }
          break;
-   }    
-
-   return;
-}
-
-/*
- * @brief Generate code for the 3 kinds of nodes
- */
-void codegenGeneral(TreeNode *current) {
-   TreeNode *tmp = current;
-   while (tmp) {
-      switch (tmp->nodekind) {
-         case StmtK:
-            codegenStatement(tmp);
-            break;
-         case ExpK:
-            emitComment((char *)"EXPRESSION");
-            codegenExpression(tmp);
-            break;
-         case DeclK:
-            codegenDecl(tmp);
-            break;
-      }
-      tmp = tmp->sibling;
-   }
 
-   return;
-}
+      case IrJump:
+      case IrBranchZ:
+      case IrBranchNZ:
+         jump(instr, r.a);
+         break;
 
-void initAGlobalSymbol(std::string stm, void *ptr) {
-   TreeNode *current;
-   
-   // printf("Symbol: %s\n", sym.c_str()); // dump the symbol table
-   current = (TreeNode *)ptr;
+      case IrRet:
+         emitRM((char *)"LD", AC, RETURNOFFSET, FP, (char *)"Load return address");
+         emitRM((char *)"LD", FP, OFPOFF, FP, (char *)"Adjust fp");
+         emitGoto(0, AC, (char *)"Return");
+         break;
 
-   // printf("lineno: %d\n", current->lineno); // dump the symbol table
+      case IrHalt:
+         emitRO((char *)"HALT", 0, 0, 0, c);
+         break;
 
-   if (current->lineno != -1) {
-      if (current->isArray) {
-         emitRM((char *)"LDC", AC, current->size-1, 6, (char *)"load size of array", current->attr.name);
-         emitRM((char *)"ST", AC, current->offset+1, GP, (char *)"save size of array", current->attr.name);
-      }
-      if (current->kind.decl==VarK && (current->varKind == Global || current->varKind == LocalStatic)) {
-         if (current->child[0]) {
-            // compute rhs -> AC;
-            codegenExpression(current->child[0]);
+      case IrRestart:
+         emitGotoAbs(0, c);
+         break;
 
-            // save it
-            emitRM((char *)"ST", AC, current->offset, GP, (char *)"Store variable", current->attr.name);
-         }
-      }
+      default:
+         break;
    }
-
-   return;
 }
 
 /*
- * @brief initialize global array sizes
+ * @brief lower the blocks of a function in order, the jumps ahead to a
+ * block are backpatched when it is reached
+ *
+ * @param function - function to lower
+ *
+ * @return void
  */
-void initGlobalArraySizes() {
-   emitComment((char *)"INIT GLOBALS AND STATICS");
-   globals->applyToAllGlobal(initAGlobalSymbol);
-   emitComment((char *)"END INIT GLOBALS AND STATICS");
+void Lowering::lowerFunction(const IrFunction &function) {
+   int used[2];
+
+   fn = &function;
+   uses.assign(function.numValues, 0);
+   indexOf.assign(function.numValues, false);
+   pushed.assign(function.numValues, false);
+   regOf.assign(function.numValues, -1);
+   slotOf.assign(function.numValues, 0);
+   blockAddr.assign(function.blocks.size(), -1);
+   spills.clear();
+   fixups.assign(function.blocks.size(), std::vector<Fixup>());
+   inAC = IR_NONE;
+
+   for (const IrBlock &block : function.blocks) {
+      for (const IrInstr &instr : block.instrs) {
+         int count = irUses(instr, used);
+
+         for (int j = 0; j < count; j++) {
+            uses[used[j]]++;
+         }
+         if (instr.op == IrUpdateElem && instr.a != IR_NONE) {
+            indexOf[instr.a] = true;
+         }
+      }
+   }
 
-   return;
-}
+   for (size_t b = 0; b < function.blocks.size(); b++) {
+      const IrBlock &block = function.blocks[b];
 
-/*
- * @brief Generate init code
- */
-void codegenInit(int initJump, int globalOffset) {
-   backPatchAJumpToHere(initJump, (char *)"Jump to init [backpatch]");
+      blockAddr[b] = emitSkip(0);
+      for (const Fixup &fixup : fixups[b]) {
+         patch(fixup);
+      }
+      // no value lives from one block into the next in a register, a
+      // value used after an inlined call was spilled at its callbegin
+      // and stays on spills, under those of the body, until it is
+      // reloaded past the join block
+      for (int reg = 0; reg < PC; reg++) {
+         holder[reg] = IR_NONE;
+      }
 
-   emitComment((char *)"INIT");
-   //OLD pre 4.6 TM emitRM((char *)"LD", GP, 0, 0, (char *)"Set the global pointer");
-   emitRM((char *)"LDA", FP, globalOffset, GP, (char *)"set first frame at end of globals");
-   emitRM((char *)"ST", FP, 0, FP, (char *)"store old fp (point to self)");
+      for (size_t i = 0; i < block.instrs.size(); i++) {
+         const IrInstr &instr = block.instrs[i];
+         int count = irUses(instr, used);
+         Regs r;
 
-   initGlobalArraySizes();
+         if (instr.op == IrComment || instr.op == IrCommentInt) {
+            lowerInstr(instr, stackRegs(instr));
+            continue;
+         }
 
-   emitRM((char *)"LDA", AC, 1, PC, (char *)"Return address in ac");
+         if (registers) {
+            r = allocRegs(instr);
+         } else {
+            if (count > 0 && used[count - 1] != inAC) {
+               diagnose(InternalError, 0, {"codegen: operand is not in ac"});
+            }
+            r = stackRegs(instr);
+         }
 
-   {
-      // Jump to main
-      TreeNode *funcNode;
+         lowerInstr(instr, r);
+         for (int j = 0; j < count; j++) {
+            uses[used[j]]--;
+         }
 
-      funcNode = (TreeNode *)globals->lookup((char *)"main");
-      if (funcNode) {
-         emitGotoAbs(funcNode->offset, (char *)"Jump to main");
-      } else {
-         printf("ERROR(LINKER): Procedure main is not defined.\n");
-         numErrors++;
+         if (registers) {
+            release(instr, r);
+            continue;
+         }
+         if (instr.dst >= 0) {
+            inAC = instr.dst;
+         } else if (instr.op != IrStore && instr.op != IrArg && instr.op != IrCallBegin) {
+            inAC = IR_NONE;
+         }
+         push(block, i);
       }
    }
-
-   emitRO((char *)"HALT", 0, 0, 0, (char *)"DONE!");
-   emitComment((char *)"END INIT");
-
-   return;
 }
 
 /*
- * @brief top level code generator call
+ * @brief top level code generator call. The code is left in
+ * ctx->emitted for later passes and emitFlush.
  *
  * @param codeIn - Where the code will be outputted
  * @param srcFile - name of file compiled
- * @param syntaxTree - tree to process
- * @param globalsIn - globals so function info can be found
- * @param globalOffset - size of the global frame
- * @param linenumFlagIn - comment with line numbers
+ * @param program - IR of the program
  *
  */
-void codegen(FILE *codeIn, char *srcFile, 
-         TreeNode *syntaxTree, SymbolTable *globalsIn, 
-         int globalOffset, bool linenumFlagIn) {
+void codegen(FILE *codeIn, char *srcFile, const IrProgram &program) {
+   Lowering lowering(program.registers);
    int initJump;
 
-   code = codeIn;
-   globals = globalsIn;
-   linenumFlag = linenumFlagIn;
-   breakloc = 0;
+   ctx->out = codeIn;
+
+   startPhase("codegen");
 
    // save a plave for the jump to init
    initJump = emitSkip(1);
 
    // generate comments describing what is compiled
    codegenHeader(srcFile);
-   
-   // general code generation including IO Library
-   codegenGeneral(syntaxTree);
-   
-   // generation of initialization for run
-   codegenInit(initJump, globalOffset);
+
+   // the functions including the IO Library, then the init code
+   for (const IrFunction &function : program.functions) {
+      if (function.kind == IrInitCode) {
+         startPhase("init");
+         backPatchAJumpToHere(initJump, (char *)"Jump to init [backpatch]");
+      }
+      lowering.lowerFunction(function);
+   }
 }
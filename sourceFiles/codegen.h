@@ -16,11 +16,11 @@
 #include "treeUtils.h"
 #include "symbolTable.h"
 #include "emitcode.h"
+#include "ir.h"
 
 /*
  * @brief top level code generator call
  */
-void codegen(FILE *codeIn, char *srcFile, TreeNode *syntaxTree, 
-      SymbolTable *globalsIn, int globalOffset, bool linenumFlagIn);
+void codegen(FILE *codeIn, char *srcFile, const bc::IrProgram &program);
 
 #endif
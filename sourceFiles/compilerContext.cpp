@@ -0,0 +1,108 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief The compiler context and the phases run on it. Both the bC
+ * driver (main.cpp) and bc::compile() (libbc.cpp) compile through
+ * these and bc::runPasses() so they produce the same output.
+ *
+ */
+
+#include <mutex>
+#include "compilerContext.h"
+#include "passManager.h"
+#include "treeUtils.h"
+#include "yyerror.h"
+#include "parser.tab.h"
+
+thread_local bc::CompilerContext *ctx = NULL;
+
+namespace bc {
+
+CompilerContext::CompilerContext(FILE *out, FILE *diag) : stringPool(&arena), timeReport(&arena) {
+   this->out = out;
+   this->diag = diag;
+
+   numErrors = 0;
+   numWarnings = 0;
+   tokenErrors = 0;
+
+   diagnostics = &messages;
+   messagesWritten = 0;
+   holdMessages = false;
+
+   line = 1;
+   lastToken = (char *)"";
+   syntaxTree = NULL;
+
+   goffset = 0;
+   foffset = 0;
+   varCounter = 0;
+   newScope = 0;
+   foundReturn = false;
+   funcInside = NULL;
+   mainFunc = NULL;
+   semanticThreads = 1;
+   semItem = NULL;
+
+   toffset = 0;
+   linenumFlag = false;
+   globals = NULL;
+   emitLoc = 0;
+   litLoc = 1;
+
+   optLevel = 0;
+   passList = NULL;
+   printAfter = NULL;
+   optReport = false;
+   inlineLimit = INLINE_LIMIT;
+}
+
+/*
+ * @brief fill in the token name tables used to print messages and
+ * register the compiler's passes
+ */
+static void initTablesOnce() {
+   initErrorProcessing();
+   initTokenStrings();
+   registerBuiltinPasses();
+}
+
+/*
+ * @brief build the read only tables shared by every compile. Only the
+ * first call does anything.
+ *
+ * @return void
+ */
+void initTables() {
+   static std::once_flag once;
+
+   std::call_once(once, initTablesOnce);
+}
+
+/*
+ * @brief end the current phase of the compile and start another
+ *
+ * @param name - name of the phase starting now
+ *
+ * @return void
+ */
+void startPhase(const char *name) {
+   ctx->arena.phase(name);
+   ctx->timeReport.phase(name);
+}
+
+/*
+ * @brief scan and parse a source in place with its own scanner
+ *
+ * @param src - source to parse, must stay alive until the compile ends
+ *
+ * @return void
+ */
+void parseSource(SourceBuffer *src) {
+   void *scanner = scannerBegin(src);
+
+   yyparse(scanner);
+   scannerEnd(scanner);
+}
+
+}
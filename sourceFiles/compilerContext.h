@@ -0,0 +1,99 @@
+#ifndef _COMPILERCONTEXT_H_
+#define _COMPILERCONTEXT_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief All of the state for one compile. Every phase of the compiler
+ * used to keep its state in globals, now it lives in a context that is
+ * bound to the thread running the compile so any number of compiles
+ * can run at the same time in one process.
+ *
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "arena.h"
+#include "diagnostics.h"
+#include "emitcode.h"
+#include "stringPool.h"
+#include "timeReport.h"
+#include "source.h"
+#include "treeNodes.h"
+
+class SymbolTable;
+struct SemanticItem;
+
+namespace bc {
+
+struct CompilerContext {
+    FILE *out;                             // generated code is written here
+    FILE *diag;                            // errors and warnings are written here as text
+
+    // memory owned by the compile
+    Arena arena;                           // tree nodes, token records and strings
+    StringPool stringPool;                 // interned names, stored in the arena
+    TimeReport timeReport;                 // time and memory of each phase, off unless enabled
+
+    // counts printed at the end of the compile
+    int numErrors;                         // number of errors
+    int numWarnings;                       // number of warnings
+    int tokenErrors;                       // errors found by the scanner
+
+    // diagnostics, reported with diagnose() and written by flushDiagnostics()
+    Diagnostics messages;                  // errors and warnings of the compile in the order found
+    Diagnostics *diagnostics;              // where diagnose() puts them, messages or a semantic item's
+    size_t messagesWritten;                // messages already written to diag
+    bool holdMessages;                     // keep messages for the caller rather than writing them
+
+    // scanner and parser
+    int line;                              // line number of the last token scanned
+    char *lastToken;                       // text of the last token scanned
+    TreeNode *syntaxTree;                  // tree built by the last parse
+
+    // semantic analysis
+    int goffset;                           // next free global offset
+    int foffset;                           // next free offset in the current frame
+    int varCounter;                        // numbers the global names given to statics
+    int newScope;                          // does the next compound statement open a scope
+    bool foundReturn;                      // has the current function returned
+    TreeNode *funcInside;                  // function the traversal is currently inside
+    TreeNode *mainFunc;                    // declaration of main, found by semantic analysis
+    int semanticThreads;                   // threads to check functions on, 0 one per core, 1 in order
+    SemanticItem *semItem;                 // declaration being checked on its own, NULL when in order
+
+    // code generation
+    int toffset;                           // next available temporary space
+    bool linenumFlag;                      // mark the code with line numbers
+    SymbolTable *globals;                  // global symbol table
+    int emitLoc;                           // next empty slot in Imem growing to lower memory
+    int litLoc;                            // next empty slot in Dmem growing to higher memory
+    EmitBuffer emitted;                    // code waiting to be written by emitFlush
+
+    // pass manager
+    int optLevel;                          // -O level choosing the passes run
+    const char *passList;                  // comma separated passes to run instead, NULL to use optLevel
+    const char *printAfter;                // pass to print the tree after, NULL for none
+    bool optReport;                        // keep the remarks of the optimization passes
+    int inlineLimit;                       // instructions of a function the inliner always inlines
+    std::vector<std::string> optRemarks;   // what the optimization passes did, a line each
+
+    CompilerContext(FILE *out, FILE *diag);
+};
+
+// Build the shared read only tables, safe to call from any thread
+void initTables();
+
+// End the current phase of the compile and start name, for the arena
+// and time reports
+void startPhase(const char *name);
+
+// Parse src, the tree is left in ctx->syntaxTree
+void parseSource(SourceBuffer *src);
+
+}
+
+extern thread_local bc::CompilerContext *ctx;   // context of the compile running on this thread
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Whole program dead function elimination. The call graph is
+ * walked from the init code, which initializes the globals and starts
+ * main, and from the code made for the global declarations. A function
+ * the walk never reaches is removed before codegen lays out the code,
+ * so a program only carries the IO library functions it calls. Calls
+ * are the only way to reach a function in bC, there are no function
+ * values.
+ *
+ */
+
+#include <unordered_map>
+#include <vector>
+#include "deadFunc.h"
+#include "compilerContext.h"
+#include "passManager.h"
+
+using namespace bc;
+
+/*
+ * @brief remove every function not reachable through calls from main
+ * or the code that initializes the globals
+ *
+ * @param program - IR to cut down
+ *
+ * @return void
+ */
+void removeDeadFunctions(IrProgram &program) {
+   std::vector<IrFunction> &functions = program.functions;
+   std::unordered_map<const TreeNode *, int> indexOf;   // function of each declaration
+   std::vector<bool> reached(functions.size(), false);
+   std::vector<int> work;
+   std::vector<IrFunction> kept;
+
+   // without main nothing is called, leave the code for codegen to report
+   if (ctx->mainFunc == NULL) {
+      return;
+   }
+
+   for (size_t i = 0; i < functions.size(); i++) {
+      if (functions[i].kind == IrUser || functions[i].kind == IrLibrary) {
+         indexOf[functions[i].decl] = (int)i;
+      } else {
+         reached[i] = true;
+         work.push_back((int)i);
+      }
+   }
+
+   while (!work.empty()) {
+      const IrFunction &function = functions[work.back()];
+
+      work.pop_back();
+      for (const IrBlock &block : function.blocks) {
+         for (const IrInstr &instr : block.instrs) {
+            if ((instr.op != IrCall && instr.op != IrStart) || instr.func == NULL) {
+               continue;
+            }
+
+            auto callee = indexOf.find(instr.func);
+
+            if (callee != indexOf.end() && !reached[callee->second]) {
+               reached[callee->second] = true;
+               work.push_back(callee->second);
+            }
+         }
+      }
+   }
+
+   for (size_t i = 0; i < functions.size(); i++) {
+      if (reached[i]) {
+         kept.push_back(std::move(functions[i]));
+      } else {
+         optRemark("deadfunc", "removed %s", functions[i].name);
+      }
+   }
+   optRemark("deadfunc", "%zu of %zu functions removed", functions.size() - kept.size(), indexOf.size());
+   functions.swap(kept);
+}
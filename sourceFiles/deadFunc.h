@@ -0,0 +1,20 @@
+#ifndef _DEADFUNC_H_
+#define _DEADFUNC_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Drops the functions of the IR that no run of the program can
+ * call, the IO library functions included.
+ *
+ */
+
+#include "ir.h"
+
+/*
+ * @brief remove every function not reachable through calls from main
+ * or the code that initializes the globals
+ */
+void removeDeadFunctions(bc::IrProgram &program);
+
+#endif
@@ -0,0 +1,533 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Keeps the diagnostics of a compile as records and formats
+ * them when they are written. A message is a template from the table
+ * below filled in with the arguments of the record:
+ *
+ *    %d  a number
+ *    %c  a character
+ *    %s  text
+ *    %q  a token, put in double quotes unless it is already quoted
+ *    %l  the rest of the arguments joined with " or "
+ *
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <charconv>
+#include "diagnostics.h"
+#include "compilerContext.h"
+
+namespace bc {
+
+// What kind of message a code is, it picks the prefix of the text
+enum DiagKind {KindToken, KindSyntax, KindSemantic, KindLinker, KindArgList, KindInternal};
+
+struct DiagInfo {
+   const char *name;                      // stable name for JSON and SARIF
+   DiagKind kind;
+   DiagSeverity severity;
+   const char *text;                      // template of the message
+};
+
+// indexed by DiagCode
+static const DiagInfo diagInfo[] = {
+   {"bad-character", KindToken, DiagError, "invalid or misplaced input character: '%c'. Character Ignored."},
+   {"syntax-error", KindSyntax, DiagError, "syntax error."},
+   {"unexpected", KindSyntax, DiagError, "unexpected %s."},
+   {"unexpected-token", KindSyntax, DiagError, "unexpected %s %q."},
+   {"unexpected-expecting", KindSyntax, DiagError, "unexpected %s, expecting %l."},
+   {"unexpected-token-expecting", KindSyntax, DiagError, "unexpected %s %q, expecting %l."},
+   {"nested-too-deeply", KindSyntax, DiagError, "program is nested too deeply to parse."},
+   {"missing-child", KindSyntax, DiagError, "child 0 cannot be NULL"},
+
+   {"operands-not-int", KindSemantic, DiagError, "'%s' requires operands of type int but %s is of %s."},
+   {"operands-not-bool", KindSemantic, DiagError, "'%s' requires operands of type bool but %s is of %s."},
+   {"operands-not-same-type", KindSemantic, DiagError,
+      "'%s' requires operands of the same type but lhs is %s and rhs is %s."},
+   {"operands-array-mismatch", KindSemantic, DiagError,
+      "'%s' requires both operands be arrays or not but lhs is %s array and rhs is %s array."},
+   {"operation-on-array", KindSemantic, DiagError, "The operation '%s' does not work with arrays."},
+   {"sizeof-not-array", KindSemantic, DiagError, "The operation 'sizeof' only works with arrays."},
+   {"unary-not-int", KindSemantic, DiagError, "Unary '%s' requires an operand of type int but was given %s."},
+   {"index-non-array", KindSemantic, DiagError, "Cannot index nonarray '%s'."},
+   {"index-not-int", KindSemantic, DiagError, "Array '%s' should be indexed by type int but got %s."},
+   {"index-is-array", KindSemantic, DiagError, "Array index is the unindexed array '%s'."},
+   {"test-not-bool", KindSemantic, DiagError, "Expecting Boolean test condition in %s statement but got %s."},
+   {"test-is-array", KindSemantic, DiagError, "Cannot use array as test condition in %s statement."},
+   {"return-missing-value", KindSemantic, DiagError,
+      "Function '%s' at line %d is expecting to return %s but return has no value."},
+   {"return-array", KindSemantic, DiagError, "Cannot return an array."},
+   {"return-unexpected-value", KindSemantic, DiagError,
+      "Function '%s' at line %d is expecting no return value, but return has a value."},
+   {"return-wrong-type", KindSemantic, DiagError, "Function '%s' at line %d is expecting to return %s but returns %s."},
+   {"break-outside-loop", KindSemantic, DiagError, "Cannot have a break statement outside of loop."},
+   {"range-not-int", KindSemantic, DiagError, "Expecting type int in position %d in range of for statement but got %s."},
+   {"range-is-array", KindSemantic, DiagError, "Cannot use array in position %d in range of for statement."},
+   {"param-wrong-type", KindSemantic, DiagError,
+      "Expecting %s in parameter %d of call to '%s' declared on line %d but got %s."},
+   {"param-not-array", KindSemantic, DiagError, "Expecting array in parameter %d of call to '%s' declared on line %d."},
+   {"param-is-array", KindSemantic, DiagError, "Not expecting array in parameter %d of call to '%s' declared on line %d."},
+   {"too-many-params", KindSemantic, DiagError, "Too many parameters passed for function '%s' declared on line %d."},
+   {"too-few-params", KindSemantic, DiagError, "Too few parameters passed for function '%s' declared on line %d."},
+   {"undeclared", KindSemantic, DiagError, "Symbol '%s' is not declared."},
+   {"call-simple-variable", KindSemantic, DiagError, "'%s' is a simple variable and cannot be called."},
+   {"function-as-variable", KindSemantic, DiagError, "Cannot use function '%s' as a variable."},
+   {"initializer-wrong-type", KindSemantic, DiagError, "Initializer for variable '%s' of %s is of %s"},
+   {"initializer-not-constant", KindSemantic, DiagError, "Initializer for variable '%s' is not a constant expression."},
+   {"initializer-array-mismatch", KindSemantic, DiagError,
+      "Initializer for variable '%s' requires both operands be arrays or not but variable is %s array and rhs is %s array."},
+   {"already-declared", KindSemantic, DiagError, "Symbol '%s' is already declared at line %d."},
+
+   {"maybe-uninitialized", KindSemantic, DiagWarning, "Variable '%s' may be uninitialized when used here."},
+   {"no-return", KindSemantic, DiagWarning, "Expecting to return %s but function '%s' has no return statement."},
+   {"unused-variable", KindSemantic, DiagWarning, "The variable '%s' seems not to be used."},
+   {"unused-parameter", KindSemantic, DiagWarning, "The parameter '%s' seems not to be used."},
+   {"unused-function", KindSemantic, DiagWarning, "The function '%s' seems not to be used."},
+
+   {"no-main", KindLinker, DiagError, "A function named 'main' with no parameters must be defined."},
+   {"no-main-procedure", KindLinker, DiagError, "Procedure main is not defined."},
+
+   {"source-not-opened", KindArgList, DiagError, "source file \"%s\" could not be opened."},
+   {"source-not-read", KindArgList, DiagError, "source could not be read from standard input."},
+   {"output-not-written", KindArgList, DiagError, "output file \"%s\" could not be written."},
+   {"unknown-pass", KindArgList, DiagError, "unknown pass \"%s\" in --passes."},
+   {"unknown-print-after", KindArgList, DiagError, "unknown pass \"%s\" in --print-after."},
+   {"unknown-diagnostic-format", KindArgList, DiagError, "unknown format \"%s\" in --diagnostics, use text, json or sarif."},
+   {"bad-thread-count", KindArgList, DiagError, "bad thread count \"%s\" in -j, use 0 to %d."},
+   {"bad-inline-limit", KindArgList, DiagError, "bad size \"%s\" in --inline-limit, use 0 to %d."},
+   {"bad-opt-level", KindArgList, DiagError, "bad optimization level \"%s\" in -O, use 0 to %d."},
+   {"unknown-time-report-format", KindArgList, DiagError, "unknown format \"%s\" in --time-report, use text or json."},
+
+   {"internal-error", KindInternal, DiagError, "%s"},
+};
+
+static_assert(sizeof(diagInfo) / sizeof(diagInfo[0]) == NUM_DIAG_CODES, "a DiagCode is missing from diagInfo");
+
+DiagArg::DiagArg(const char *text) : text((text != NULL) ? text : ""), length(0), number(0) {
+   length = strlen(this->text);
+}
+
+const char *diagName(DiagCode code) {
+   return diagInfo[code].name;
+}
+
+DiagSeverity diagSeverity(DiagCode code) {
+   return diagInfo[code].severity;
+}
+
+/*
+ * @brief the format named by --diagnostics=
+ *
+ * @param name - text, json or sarif
+ * @param format - set to the format named
+ *
+ * @return false if name is not a format
+ */
+bool parseDiagFormat(const char *name, DiagFormat &format) {
+   if (strcmp(name, "text") == 0) format = DiagText;
+   else if (strcmp(name, "json") == 0) format = DiagJson;
+   else if (strcmp(name, "sarif") == 0) format = DiagSarif;
+   else return false;
+
+   return true;
+}
+
+/*
+ * @brief add a diagnostic, its text arguments are copied so they only
+ * have to live until this returns
+ *
+ * @param code - what was found
+ * @param line - source line, 0 for none
+ * @param list - arguments of the message template
+ * @param count - number of arguments
+ *
+ * @return void
+ */
+void Diagnostics::add(DiagCode code, int line, const DiagArg *list, size_t count) {
+   records.push_back(Record{code, line, (unsigned)args.size(), (unsigned)count});
+   for (size_t i = 0; i < count; i++) {
+      const DiagArg &a = list[i];
+
+      if (a.text != NULL) {
+         args.push_back(Arg{(unsigned)strings.size(), (unsigned)a.length, 0, true});
+         strings.append(a.text, a.length);
+      } else {
+         args.push_back(Arg{0, 0, a.number, false});
+      }
+   }
+}
+
+/*
+ * @brief add records [begin, end) of another list to the end of this one
+ *
+ * @return void
+ */
+void Diagnostics::append(const Diagnostics &from, size_t begin, size_t end) {
+   for (size_t i = begin; i < end; i++) {
+      const Record &r = from.records[i];
+
+      records.push_back(Record{r.code, r.line, (unsigned)args.size(), r.numArgs});
+      for (unsigned j = 0; j < r.numArgs; j++) {
+         Arg a = from.args[r.firstArg + j];
+
+         if (a.isText) {
+            unsigned offset = (unsigned)strings.size();
+
+            strings.append(from.strings, a.offset, a.length);
+            a.offset = offset;
+         }
+         args.push_back(a);
+      }
+   }
+}
+
+void Diagnostics::clear() {
+   records.clear();
+   args.clear();
+   strings.clear();
+}
+
+/*
+ * @brief append a number to out
+ */
+static void appendNumber(std::string &out, int n) {
+   char digits[16];
+   std::to_chars_result end = std::to_chars(digits, digits + sizeof(digits), n);
+
+   out.append(digits, end.ptr - digits);
+}
+
+/*
+ * @brief append the message of a record, without its prefix, to out
+ *
+ * @param index - record to format
+ * @param out - where the text goes
+ *
+ * @return void
+ */
+void Diagnostics::formatMessage(size_t index, std::string &out) const {
+   const Record &r = records[index];
+   const char *t = diagInfo[r.code].text;
+   unsigned next = 0;
+
+   while (*t != '\0') {
+      const char *percent = strchr(t, '%');
+
+      if (percent == NULL) {
+         out.append(t);
+         break;
+      }
+      out.append(t, percent - t);
+      t = percent + 2;
+      if (next >= r.numArgs) {
+         continue;   // a template asking for more than was reported
+      }
+
+      const Arg &a = args[r.firstArg + next++];
+      const char *text = strings.data() + a.offset;
+
+      switch (percent[1]) {
+         case 'd':
+            appendNumber(out, a.number);
+            break;
+         case 'c':
+            out.push_back((char)a.number);
+            break;
+         case 'q':
+            if (a.length > 0 && (text[0] == '\'' || text[0] == '"')) {
+               out.append(text, a.length);
+            } else {
+               out.push_back('"');
+               out.append(text, a.length);
+               out.push_back('"');
+            }
+            break;
+         case 'l':
+            out.append(text, a.length);
+            while (next < r.numArgs) {
+               const Arg &b = args[r.firstArg + next++];
+
+               out.append(" or ");
+               out.append(strings, b.offset, b.length);
+            }
+            break;
+         default:
+            out.append(text, a.length);
+            break;
+      }
+   }
+}
+
+/*
+ * @brief append the classic text of a record to out, the message after
+ * a prefix saying what kind it is and where it is
+ *
+ * @param index - record to format
+ * @param out - where the text goes
+ *
+ * @return void
+ */
+void Diagnostics::format(size_t index, std::string &out) const {
+   const Record &r = records[index];
+   const DiagInfo &info = diagInfo[r.code];
+
+   switch (info.kind) {
+      case KindToken:
+         out.append("TOKEN ERROR(");
+         break;
+      case KindSyntax:
+         out.append("SYNTAX ERROR(");
+         break;
+      case KindSemantic:
+         out.append((info.severity == DiagWarning) ? "SEMANTIC WARNING(" : "SEMANTIC ERROR(");
+         break;
+      case KindLinker:
+         out.append("LINKER ERROR: ");
+         break;
+      case KindArgList:
+         out.append("ERROR(ARGLIST): ");
+         break;
+      case KindInternal:
+         out.append("ERROR(SYSTEM): ");
+         break;
+   }
+   if (info.kind == KindToken || info.kind == KindSyntax || info.kind == KindSemantic) {
+      appendNumber(out, r.line);
+      out.append("): ");
+   }
+   formatMessage(index, out);
+}
+
+/*
+ * @brief write records [begin, end) as text, one per line
+ *
+ * @param out - stream to write to
+ * @param begin, end - records to write
+ * @param prefix - put with ": " in front of every line, NULL for none
+ *
+ * @return void
+ */
+void Diagnostics::writeText(FILE *out, size_t begin, size_t end, const char *prefix) const {
+   std::string line;
+
+   for (size_t i = begin; i < end; i++) {
+      line.clear();
+      if (prefix != NULL) {
+         line.append(prefix);
+         line.append(": ");
+      }
+      format(i, line);
+      line.push_back('\n');
+      fwrite(line.data(), 1, line.size(), out);
+   }
+}
+
+/*
+ * @brief every record as text, one per line
+ */
+std::string Diagnostics::text() const {
+   std::string out;
+
+   for (size_t i = 0; i < records.size(); i++) {
+      format(i, out);
+      out.push_back('\n');
+   }
+
+   return out;
+}
+
+/*
+ * @brief indexes of the records sorted by line, records on the same
+ * line stay in the order they were found
+ */
+std::vector<size_t> Diagnostics::byLine() const {
+   std::vector<size_t> order(records.size());
+
+   for (size_t i = 0; i < order.size(); i++) {
+      order[i] = i;
+   }
+   std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+      return records[a].line < records[b].line;
+   });
+
+   return order;
+}
+
+/*
+ * @brief write text as a JSON string
+ *
+ * @return void
+ */
+static void writeJsonString(FILE *out, const char *text, size_t length) {
+   fputc('"', out);
+   for (size_t i = 0; i < length; i++) {
+      unsigned char c = (unsigned char)text[i];
+
+      if (c == '"' || c == '\\') {
+         fputc('\\', out);
+         fputc(c, out);
+      } else if (c < 0x20) {
+         fprintf(out, "\\u%04x", c);
+      } else {
+         fputc(c, out);
+      }
+   }
+   fputc('"', out);
+}
+
+/*
+ * @brief write the records of one file as JSON objects
+ *
+ * @param out - stream to write to
+ * @param file - file they were found in, NULL for standard input
+ * @param first - is nothing written yet, so no comma goes first
+ *
+ * @return void
+ */
+void Diagnostics::writeJsonList(FILE *out, const char *file, bool &first) const {
+   std::string message;
+
+   if (file == NULL) file = "-";
+   for (size_t i : byLine()) {
+      const DiagInfo &info = diagInfo[records[i].code];
+
+      message.clear();
+      formatMessage(i, message);
+      fprintf(out, first ? "  {\"file\": " : ",\n  {\"file\": ");
+      writeJsonString(out, file, strlen(file));
+      fprintf(out, ", \"line\": %d, \"severity\": \"%s\", \"code\": \"%s\", \"message\": ", records[i].line,
+              (info.severity == DiagWarning) ? "warning" : "error", info.name);
+      writeJsonString(out, message.data(), message.size());
+      fputc('}', out);
+      first = false;
+   }
+}
+
+/*
+ * @brief write the records of one file as SARIF results
+ *
+ * @param out - stream to write to
+ * @param file - file they were found in, NULL for standard input
+ * @param first - is nothing written yet, so no comma goes first
+ *
+ * @return void
+ */
+void Diagnostics::writeSarifList(FILE *out, const char *file, bool &first) const {
+   std::string message;
+
+   for (size_t i : byLine()) {
+      const Record &r = records[i];
+      const DiagInfo &info = diagInfo[r.code];
+
+      message.clear();
+      formatMessage(i, message);
+      fprintf(out, first ? "    " : ",\n    ");
+      fprintf(out, "{\"ruleId\": \"%s\", \"ruleIndex\": %d, \"level\": \"%s\", \"message\": {\"text\": ", info.name,
+              (int)r.code, (info.severity == DiagWarning) ? "warning" : "error");
+      writeJsonString(out, message.data(), message.size());
+      fprintf(out, "}");
+      if (file != NULL) {
+         fprintf(out, ", \"locations\": [{\"physicalLocation\": {\"artifactLocation\": {\"uri\": ");
+         writeJsonString(out, file, strlen(file));
+         fprintf(out, "}");
+         if (r.line > 0) {
+            fprintf(out, ", \"region\": {\"startLine\": %d}", r.line);
+         }
+         fprintf(out, "}}]");
+      }
+      fputc('}', out);
+      first = false;
+   }
+}
+
+/*
+ * @brief write the diagnostics of a set of files
+ *
+ * @param out - stream to write to
+ * @param format - text puts the name of the file in front of each line
+ * and keeps them in the order found, json and sarif sort each file's
+ * diagnostics by line
+ * @param files - name of each file, NULL for standard input
+ * @param lists - diagnostics of each file
+ *
+ * @return void
+ */
+void writeDiagnostics(FILE *out, DiagFormat format, const std::vector<const char *> &files,
+                      const std::vector<const Diagnostics *> &lists) {
+   bool first = true;
+   int numErrors = 0, numWarnings = 0;
+
+   switch (format) {
+      case DiagText:
+         for (size_t i = 0; i < lists.size(); i++) {
+            lists[i]->writeText(out, 0, lists[i]->size(), files[i]);
+         }
+         break;
+
+      case DiagJson:
+         fprintf(out, "{\"diagnostics\": [\n");
+         for (size_t i = 0; i < lists.size(); i++) {
+            lists[i]->writeJsonList(out, files[i], first);
+            for (const Diagnostics::Record &r : lists[i]->records) {
+               if (diagInfo[r.code].severity == DiagWarning) numWarnings++;
+               else numErrors++;
+            }
+         }
+         fprintf(out, "%s ],\n \"warnings\": %d,\n \"errors\": %d\n}\n", first ? "" : "\n", numWarnings, numErrors);
+         break;
+
+      case DiagSarif:
+         fprintf(out, "{\"$schema\": \"https://json.schemastore.org/sarif-2.1.0.json\",\n");
+         fprintf(out, " \"version\": \"2.1.0\",\n");
+         fprintf(out, " \"runs\": [{\n  \"tool\": {\"driver\": {\"name\": \"bC\", \"rules\": [");
+         for (int code = 0; code < NUM_DIAG_CODES; code++) {
+            fprintf(out, "%s\n    {\"id\": \"%s\"}", (code > 0) ? "," : "", diagInfo[code].name);
+         }
+         fprintf(out, "\n  ]}},\n  \"results\": [\n");
+         for (size_t i = 0; i < lists.size(); i++) {
+            lists[i]->writeSarifList(out, files[i], first);
+         }
+         fprintf(out, "%s  ]\n }]\n}\n", first ? "" : "\n");
+         break;
+   }
+   fflush(out);
+}
+
+/*
+ * @brief report a diagnostic in the compile on this thread, it goes to
+ * ctx->diagnostics and is counted in ctx
+ *
+ * @param code - what was found
+ * @param line - source line, 0 for none
+ * @param list - arguments of the message
+ * @param count - number of arguments
+ *
+ * @return void
+ */
+void diagnose(DiagCode code, int line, const DiagArg *list, size_t count) {
+   ctx->diagnostics->add(code, line, list, count);
+   if (diagInfo[code].severity == DiagWarning) {
+      ctx->numWarnings++;
+   } else {
+      ctx->numErrors++;
+   }
+}
+
+/*
+ * @brief write the diagnostics found since the last flush to ctx->diag
+ * as text. Nothing is written while they are held for --diagnostics=
+ * json or sarif or for the caller of libbc.
+ *
+ * @return void
+ */
+void flushDiagnostics() {
+   if (ctx->holdMessages || ctx->diag == NULL) {
+      return;
+   }
+   ctx->messages.writeText(ctx->diag, ctx->messagesWritten, ctx->messages.size());
+   ctx->messagesWritten = ctx->messages.size();
+}
+
+}
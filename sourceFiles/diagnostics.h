@@ -0,0 +1,192 @@
+#ifndef _DIAGNOSTICS_H_
+#define _DIAGNOSTICS_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Errors and warnings of a compile. A diagnostic is kept as its
+ * code, line and arguments and only turned into text when it is
+ * written, as the classic bC messages (--diagnostics=text), as JSON or
+ * as SARIF. The code of a diagnostic says what it is, how bad it is and
+ * the text it is written as.
+ *
+ */
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stddef.h>
+
+namespace bc {
+
+enum DiagSeverity {DiagError, DiagWarning};
+
+// One code for each message the compiler can give
+enum DiagCode {
+    // scanner and parser
+    BadCharacter,
+    SyntaxError,
+    Unexpected,
+    UnexpectedToken,
+    UnexpectedExpecting,
+    UnexpectedTokenExpecting,
+    NestedTooDeeply,
+    MissingChild,
+
+    // semantic errors
+    OperandsNotInt,
+    OperandsNotBool,
+    OperandsNotSameType,
+    OperandsArrayMismatch,
+    OperationOnArray,
+    SizeofNotArray,
+    UnaryNotInt,
+    IndexNonArray,
+    IndexNotInt,
+    IndexIsArray,
+    TestNotBool,
+    TestIsArray,
+    ReturnMissingValue,
+    ReturnArray,
+    ReturnUnexpectedValue,
+    ReturnWrongType,
+    BreakOutsideLoop,
+    RangeNotInt,
+    RangeIsArray,
+    ParamWrongType,
+    ParamNotArray,
+    ParamIsArray,
+    TooManyParams,
+    TooFewParams,
+    Undeclared,
+    CallSimpleVariable,
+    FunctionAsVariable,
+    InitializerWrongType,
+    InitializerNotConstant,
+    InitializerArrayMismatch,
+    AlreadyDeclared,
+
+    // semantic warnings
+    MaybeUninitialized,
+    NoReturn,
+    UnusedVariable,
+    UnusedParameter,
+    UnusedFunction,
+
+    // linker
+    NoMain,
+    NoMainProcedure,
+
+    // command line
+    SourceNotOpened,
+    SourceNotRead,
+    OutputNotWritten,
+    UnknownPass,
+    UnknownPrintAfter,
+    UnknownDiagnosticFormat,
+    BadThreadCount,
+    BadInlineLimit,
+    BadOptLevel,
+    UnknownTimeReportFormat,
+
+    // faults in the compiler itself
+    InternalError,
+
+    NUM_DIAG_CODES
+};
+
+enum DiagFormat {DiagText, DiagJson, DiagSarif};
+
+// An argument as it is reported, a number or text that is copied
+struct DiagArg {
+    const char *text;                      // NULL for a number
+    size_t length;                         // bytes of text
+    int number;                            // the number, or a single character for %c
+
+    DiagArg(int number) : text(NULL), length(0), number(number) {}
+    DiagArg(const char *text);
+    DiagArg(const char *text, size_t length) : text(text), length(length), number(0) {}
+};
+
+class Diagnostics {
+private:
+    struct Record {
+        DiagCode code;                     // what was found
+        int line;                          // source line, 0 for none
+        unsigned firstArg;                 // index of its first argument in args
+        unsigned numArgs;                  // number of arguments
+    };
+
+    struct Arg {
+        unsigned offset;                   // start of its text in strings
+        unsigned length;                   // bytes of text, 0 for a number
+        int number;                        // the number
+        bool isText;                       // text or number
+    };
+
+    std::vector<Record> records;           // in the order they were reported
+    std::vector<Arg> args;                 // arguments of every record
+    std::string strings;                   // text of every argument
+
+    void formatMessage(size_t index, std::string &out) const;
+    void writeJsonList(FILE *out, const char *file, bool &first) const;
+    void writeSarifList(FILE *out, const char *file, bool &first) const;
+    std::vector<size_t> byLine() const;
+
+public:
+    // Add a diagnostic, nothing is formatted until it is written
+    void add(DiagCode code, int line, const DiagArg *list, size_t count);
+    void add(DiagCode code, int line, std::initializer_list<DiagArg> list) {
+        add(code, line, list.begin(), list.size());
+    }
+
+    // Add records [begin, end) of another list
+    void append(const Diagnostics &from, size_t begin, size_t end);
+
+    size_t size() const { return records.size(); }
+    DiagCode code(size_t index) const { return records[index].code; }
+    int line(size_t index) const { return records[index].line; }
+    void clear();
+
+    // The classic text of a diagnostic: "SEMANTIC ERROR(3): ..."
+    void format(size_t index, std::string &out) const;
+
+    // Write records [begin, end) as text, each line after prefix and
+    // ": " if prefix is not NULL
+    void writeText(FILE *out, size_t begin, size_t end, const char *prefix = NULL) const;
+
+    // All of the records as text
+    std::string text() const;
+
+    friend void writeDiagnostics(FILE *out, DiagFormat format, const std::vector<const char *> &files,
+                                 const std::vector<const Diagnostics *> &lists);
+};
+
+// Write the diagnostics of each file sorted by line, in a structured
+// format, or as text in the order they were found
+void writeDiagnostics(FILE *out, DiagFormat format, const std::vector<const char *> &files,
+                      const std::vector<const Diagnostics *> &lists);
+
+// Name of a --diagnostics= format, false if it is not one
+bool parseDiagFormat(const char *name, DiagFormat &format);
+
+// Stable name of a code, used by JSON and SARIF
+const char *diagName(DiagCode code);
+
+DiagSeverity diagSeverity(DiagCode code);
+
+// Report a diagnostic in the compile running on this thread and count
+// it as an error or a warning
+void diagnose(DiagCode code, int line, const DiagArg *list, size_t count);
+inline void diagnose(DiagCode code, int line, std::initializer_list<DiagArg> list = {}) {
+    diagnose(code, line, list.begin(), list.size());
+}
+
+// Write the diagnostics of the compile found since the last call to
+// ctx->diag as text, unless they are being held for the caller
+void flushDiagnostics();
+
+}
+
+#endif
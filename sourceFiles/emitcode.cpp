@@ -12,15 +12,57 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
+#include <string>
 #include "emitcode.h"
+#include "compilerContext.h"
 
-//extern FILE *code;
-#define code stdout
+//  TM location numbers for current instruction emission are kept in
+//  the compiler context: ctx->emitLoc and ctx->litLoc.  The code
+//  itself waits in ctx->emitted until emitFlush.
 
 
-//  TM location number for current instruction emission
-static int emitLoc = 0;   // next empty slot in Imem growing to lower memory
-static int litLoc = 1;    // next empty slot in Dmem growing to higher memory
+// copy a comment into the arena since callers often build them in
+// buffers on the stack
+static const char *keep(const char *s)
+{
+    if (s == NULL) return "(null)";   // what printf showed for it
+
+    return (s[0] == '\0') ? "" : ctx->arena.copyString(s);
+}
+
+
+// record a note to be printed before the instruction at emitLoc
+static void addNote(EmitNoteKind kind, const char *c, const char *cc, long long int n)
+{
+    EmitNote note;
+
+    note.loc = ctx->emitLoc;
+    note.kind = kind;
+    note.c = keep(c);
+    note.cc = keep(cc);
+    note.n = n;
+    ctx->emitted.notes.push_back(note);
+}
+
+
+// put an instruction at emitLoc, replacing whatever was there
+static void addInstr(const char *op, bool isRM, long long int r, long long int s, long long int t,
+                     const char *c, const char *cc)
+{
+    std::vector<EmitInstr> &instrs = ctx->emitted.instrs;
+    EmitInstr &instr = ((size_t)ctx->emitLoc < instrs.size()) ? instrs[ctx->emitLoc] :
+        (instrs.resize(ctx->emitLoc + 1, EmitInstr()), instrs[ctx->emitLoc]);
+
+    instr.op = op;
+    instr.isRM = isRM;
+    instr.r = r;
+    instr.s = s;
+    instr.t = t;
+    instr.c = keep(c);
+    instr.cc = keep(cc);
+    ctx->emitLoc++;
+}
 
 
 //  Procedure emitComment prints a comment line 
@@ -28,13 +70,13 @@ static int litLoc = 1;    // next empty slot in Dmem growing to higher memory
 // 
 void emitComment(char *c, char *cc)
 {
-    fprintf(code, "* %s %s\n", c, cc);
+    addNote(NoteCommentPair, c, cc, 0);
 }
 
 
 void emitComment(char *c, int n)
 {
-    fprintf(code, "* %s %d\n", c, n);
+    addNote(NoteCommentInt, c, "", n);
 }
 
 
@@ -43,7 +85,7 @@ void emitComment(char *c, int n)
 // 
 void emitComment(char *c)
 {
-    fprintf(code, "* %s\n", c);
+    addNote(NoteComment, c, "", 0);
 }
 
 
@@ -57,9 +99,7 @@ void emitComment(char *c)
 // 
 void emitRO(char *op, long long int r, long long int s, long long int t, char *c, char *cc)
 {
-    fprintf(code, "%3d:  %5s  %lld,%lld,%lld\t%s %s\n", emitLoc, op, r, s, t, c, cc);
-    fflush(code);
-    emitLoc++;
+    addInstr(op, false, r, s, t, c, cc);
 }
 
 void emitRO(char *op,long long int r,long long int s,long long int t, char *c)
@@ -78,9 +118,7 @@ void emitRO(char *op,long long int r,long long int s,long long int t, char *c)
 // 
 void emitRM(char *op, long long int r, long long int d, long long int s, char *c, char *cc)
 {
-    fprintf(code, "%3d:  %5s  %lld,%lld(%lld)\t%s %s\n", emitLoc, op, r, d, s, c, cc);
-    fflush(code);
-    emitLoc++;
+    addInstr(op, true, r, d, s, c, cc);
 }
 
 void emitRM(char *op,long long int r,long long int d,long long int s, char *c)
@@ -112,10 +150,7 @@ void emitGoto(int d,long long int s, char *c)
 // 
 void emitRMAbs(char *op, long long int r, long long int a, char *c, char *cc)
 {
-    fprintf(code, "%3d:  %5s  %lld,%lld(%lld)\t%s %s\n", emitLoc, op, r, a - (long long int)(emitLoc + 1),
-	    (long long int)PC, c, cc);
-    fflush(code);
-    emitLoc++;
+    addInstr(op, true, r, a - (long long int)(ctx->emitLoc + 1), (long long int)PC, c, cc);
 }
 
 
@@ -163,7 +198,7 @@ void emitGotoAbs(int a, char *c)
 
 int emitStrLit(int goffset, char *s)
 {
-    fprintf(code, "%3d:  %5s  \"%s\"\n", -goffset, (char *)"LIT", s);
+    addNote(NoteLit, s, "", -goffset);
     return goffset;
 }
 
@@ -176,7 +211,7 @@ int emitStrLit(int goffset, char *s)
 // asks where the next instruction will go.   Same as emitSkip(0).
 int emitWhereAmI()
 {
-    return emitLoc;
+    return ctx->emitLoc;
 }
 
 
@@ -189,8 +224,8 @@ int emitWhereAmI()
 
 int emitSkip(int howMany)
 {
-    int i = emitLoc;
-    emitLoc += howMany;
+    int i = ctx->emitLoc;
+    ctx->emitLoc += howMany;
 
     return i;
 }
@@ -201,7 +236,7 @@ int emitSkip(int howMany)
 // 
 void emitNewLoc(int loc)
 {
-    emitLoc = loc;
+    ctx->emitLoc = loc;
 }
 
 
@@ -232,3 +267,123 @@ void backPatchAJumpToHere(char *cmd, int reg, int addr, char *comment)
 }
 
 
+// 
+//  Writing the listing
+// 
+
+
+// append n in decimal right justified in width columns
+static void putInt(std::string &out, long long int n, int width)
+{
+    char digits[24];
+    int len = 0;
+    unsigned long long int u = (n < 0) ? -(unsigned long long int)n : n;
+
+    do {
+        digits[len++] = '0' + u % 10;
+        u /= 10;
+    } while (u != 0);
+    if (n < 0) digits[len++] = '-';
+
+    for (int i = len; i < width; i++) out += ' ';
+    while (len > 0) out += digits[--len];
+}
+
+
+// append s right justified in width columns
+static void putStr(std::string &out, const char *s, int width)
+{
+    int len = strlen(s);
+
+    for (int i = len; i < width; i++) out += ' ';
+    out.append(s, len);
+}
+
+
+// the same text the notes used to be printed with:
+// "* %s\n", "* %s %s\n", "* %s %d\n" or "%3d:  %5s  \"%s\"\n"
+static void putNote(std::string &out, const EmitNote &note)
+{
+    switch (note.kind) {
+    case NoteComment:
+        out += "* ";
+        out += note.c;
+        break;
+    case NoteCommentPair:
+        out += "* ";
+        out += note.c;
+        out += ' ';
+        out += note.cc;
+        break;
+    case NoteCommentInt:
+        out += "* ";
+        out += note.c;
+        out += ' ';
+        putInt(out, note.n, 0);
+        break;
+    case NoteLit:
+        putInt(out, note.n, 3);
+        out += ":  ";
+        putStr(out, "LIT", 5);
+        out += "  \"";
+        out += note.c;
+        out += '"';
+        break;
+    }
+    out += '\n';
+}
+
+
+// the same text as "%3d:  %5s  %lld,%lld,%lld\t%s %s\n" for RO
+// and "%3d:  %5s  %lld,%lld(%lld)\t%s %s\n" for RM instructions
+static void putInstr(std::string &out, int loc, const EmitInstr &instr)
+{
+    putInt(out, loc, 3);
+    out += ":  ";
+    putStr(out, instr.op, 5);
+    out += "  ";
+    putInt(out, instr.r, 0);
+    out += ',';
+    putInt(out, instr.s, 0);
+    out += instr.isRM ? '(' : ',';
+    putInt(out, instr.t, 0);
+    if (instr.isRM) out += ')';
+    out += '\t';
+    out += instr.c;
+    out += ' ';
+    out += instr.cc;
+    out += '\n';
+}
+
+
+// write every instruction in address order, each preceded by the
+// comments and LIT lines emitted just before it, in one write to out.
+// Slots that were skipped and never filled in are left out.
+void emitFlush(FILE *out)
+{
+    EmitBuffer &emitted = ctx->emitted;
+    std::vector<EmitNote> &notes = emitted.notes;
+    std::string listing;
+    size_t note = 0;
+
+    // notes are emitted in address order except around a backpatch
+    std::stable_sort(notes.begin(), notes.end(),
+                     [](const EmitNote &a, const EmitNote &b) { return a.loc < b.loc; });
+
+    listing.reserve(emitted.instrs.size() * 64 + notes.size() * 32);
+    for (size_t loc = 0; loc < emitted.instrs.size(); loc++) {
+        while (note < notes.size() && notes[note].loc <= (int)loc) {
+            putNote(listing, notes[note++]);
+        }
+        if (emitted.instrs[loc].op != NULL) {
+            putInstr(listing, loc, emitted.instrs[loc]);
+        }
+    }
+    while (note < notes.size()) {
+        putNote(listing, notes[note++]);
+    }
+
+    fwrite(listing.data(), 1, listing.size(), out);
+    emitted.instrs.clear();
+    notes.clear();
+}
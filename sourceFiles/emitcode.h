@@ -1,6 +1,9 @@
 #ifndef EMIT_CODE_H__
 #define EMIT_CODE_H__
 
+#include <stdio.h>
+#include <vector>
+
 //
 //  REGISTER DEFINES for optional use in calling the 
 //  routines below.
@@ -20,6 +23,34 @@
 #define NO_COMMENT (char *)""
 
 
+//
+//  Instructions are not written as they are emitted.  They are kept
+//  in an array indexed by address so backpatches overwrite them in
+//  place, and the whole listing is written in address order by
+//  emitFlush() when code generation is done.
+//
+struct EmitInstr {
+    const char *op;               // opcode, NULL for a skipped slot never filled in
+    bool isRM;                    // r,d(s) form rather than r,s,t
+    long long int r, s, t;        // operands in the order they are printed
+    const char *c, *cc;           // comment, copied into the arena
+};
+
+enum EmitNoteKind { NoteComment, NoteCommentPair, NoteCommentInt, NoteLit };
+
+struct EmitNote {
+    int loc;                      // printed just before the instruction at loc
+    EmitNoteKind kind;            // comment (one or two parts, or with a number) or LIT line
+    const char *c, *cc;           // text, copied into the arena
+    long long int n;              // number for NoteCommentInt, address for NoteLit
+};
+
+struct EmitBuffer {
+    std::vector<EmitInstr> instrs;    // instruction at each address
+    std::vector<EmitNote> notes;      // comments and LIT lines in the order emitted
+};
+
+
 //
 //  The following functions were borrowed from Tiny compiler code generator
 //
@@ -49,4 +80,6 @@ void backPatchAJumpToHere(char *cmd, int reg, int addr, char *comment);
 
 int emitStrLit(int goffset, char *s); // for char arrays
 
+void emitFlush(FILE *out);    // write the listing in address order and empty the buffer
+
 #endif
@@ -0,0 +1,288 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Tightens the for loops. irgen keeps the index, stop and step
+ * of a for loop in three frame slots and tests at the top, so every
+ * trip loads all three for the test, loads the index and step again to
+ * step it and jumps back up to the test. Here the step at the bottom
+ * of the loop becomes IrForNext, which steps the index and tests it
+ * with the index still in its register, and the jump back up becomes a
+ * branch straight to the body. The stop and step values are operands
+ * of the test rather than loaded by it, so when irgen stored a
+ * constant in their slot the constant is used and the slot dropped. A
+ * constant step is kept in imm, codegen adds it with LDA and tests with
+ * TLE or TGE as its sign says. When the start, stop and step are all
+ * constants and the loop runs at least once the test at the top is
+ * dropped as well.
+ *
+ * The index is not kept in a register across the loop. It stays in its
+ * frame slot, the body reads it from there and codegen keeps no value
+ * in a register from one block to the next, so every trip still loads
+ * and stores the index and makes the stop value again.
+ *
+ */
+
+#include <vector>
+#include "forLoops.h"
+#include "compilerContext.h"
+#include "passManager.h"
+
+using namespace bc;
+
+// The stop or step value of a for loop
+struct Bound {
+    IrVar slot;                     // slot irgen keeps it in
+    bool constant;                  // imm is its value, the slot is never stored
+    long long int imm;
+};
+
+// Tightens the for loops of one function
+class ForLoops {
+private:
+   IrFunction &function;
+   std::vector<int> uses;                 // uses of each value in the function
+   int constants;                         // stop and step values made constants
+   int onceLoops;                         // loops whose test at the top was dropped
+
+   int nextInstr(const std::vector<IrInstr> &instrs, int index);
+   bool constantStore(std::vector<IrInstr> &instrs, const IrVar &var, long long int &imm, bool remove);
+   int boundValue(std::vector<IrInstr> &instrs, int at, const Bound &bound, const char *c);
+   bool tighten(int top);
+
+public:
+   ForLoops(IrFunction &function);
+   int run();
+   int constantBounds() { return constants; }
+   int runOnce() { return onceLoops; }
+};
+
+ForLoops::ForLoops(IrFunction &function) : function(function), constants(0), onceLoops(0) {}
+
+/*
+ * @brief next instruction of a block that makes code
+ *
+ * @param instrs - instructions of the block
+ * @param index - instruction to start after, -1 for the first
+ *
+ * @return its index, -1 at the end of the block
+ */
+int ForLoops::nextInstr(const std::vector<IrInstr> &instrs, int index) {
+   for (int i = index + 1; i < (int)instrs.size(); i++) {
+      if (instrs[i].op != IrComment && instrs[i].op != IrCommentInt) {
+         return i;
+      }
+   }
+
+   return -1;
+}
+
+/*
+ * @brief the constant last stored in a slot by a block
+ *
+ * @param instrs - instructions of the block
+ * @param var - the slot
+ * @param imm - the constant
+ * @param remove - drop the store and the constant, nothing else reads them
+ *
+ * @return false if the last store is not of a constant made in the block
+ */
+bool ForLoops::constantStore(std::vector<IrInstr> &instrs, const IrVar &var, long long int &imm, bool remove) {
+   for (int i = (int)instrs.size() - 1; i >= 0; i--) {
+      const IrInstr &store = instrs[i];
+
+      if (store.op != IrStore || store.var.kind != var.kind || store.var.offset != var.offset) {
+         continue;
+      }
+
+      for (int k = i - 1; k >= 0; k--) {
+         if (instrs[k].dst != store.a) {
+            continue;
+         }
+         if (instrs[k].op != IrConst || uses[store.a] != 1) {
+            return false;
+         }
+         imm = instrs[k].imm;
+         if (remove) {
+            instrs.erase(instrs.begin() + i);
+            instrs.erase(instrs.begin() + k);
+         }
+         return true;
+      }
+      return false;
+   }
+
+   return false;
+}
+
+/*
+ * @brief make the stop or step value for a test
+ *
+ * @param instrs - instructions of the block of the test
+ * @param at - where the value is made, before the test
+ * @param bound - the value
+ * @param c - comment
+ *
+ * @return the value
+ */
+int ForLoops::boundValue(std::vector<IrInstr> &instrs, int at, const Bound &bound, const char *c) {
+   IrInstr instr = irMake(bound.constant ? IrConst : IrLoad);
+
+   if (bound.constant) {
+      instr.imm = bound.imm;
+      instr.type = Integer;
+   } else {
+      instr.var = bound.slot;
+   }
+   instr.dst = function.numValues++;
+   instr.c = c;
+   uses.push_back(1);
+   instrs.insert(instrs.begin() + at, instr);
+
+   return instr.dst;
+}
+
+/*
+ * @brief tighten the for loop tested in a block, if it is one
+ *
+ * @param top - the block
+ *
+ * @return was it a for loop
+ */
+bool ForLoops::tighten(int top) {
+   std::vector<IrInstr> &head = function.blocks[top].instrs;
+   int test = nextInstr(head, -1), branch, bottom, step = -1, stopValue, stepValue;
+   long long int start;
+   bool once;
+
+   if (test < 0 || head[test].op != IrForTest || head[test].a != IR_NONE) {
+      return false;
+   }
+   branch = nextInstr(head, test);
+   if (branch < 0 || head[branch].op != IrBranchNZ || head[branch].a != head[test].dst) {
+      return false;
+   }
+
+   // the bottom of the loop steps the index and jumps back up
+   const IrVar index = head[test].var;
+   int body = head[branch].target;
+
+   for (bottom = top + 1; bottom < (int)function.blocks.size() && step < 0; bottom++) {
+      const std::vector<IrInstr> &instrs = function.blocks[bottom].instrs;
+
+      for (int i = 0; i < (int)instrs.size(); i++) {
+         int next = nextInstr(instrs, i);
+
+         if (instrs[i].op == IrForStep && instrs[i].var.kind == index.kind &&
+               instrs[i].var.offset == index.offset && next >= 0 && instrs[next].op == IrJump &&
+               instrs[next].target == top) {
+            step = i;
+            break;
+         }
+      }
+   }
+   if (step < 0) {
+      return false;
+   }
+   bottom--;
+
+   // irgen stores the three values just before the top of the loop
+   std::vector<IrInstr> &init = function.blocks[top - 1].instrs;
+   Bound stop = {IrVar{index.kind, index.offset - 1, NULL}, false, 0};
+   Bound by = {IrVar{index.kind, index.offset - 2, NULL}, false, 0};
+
+   once = constantStore(init, index, start, false);
+   stop.constant = constantStore(init, stop.slot, stop.imm, true);
+   by.constant = constantStore(init, by.slot, by.imm, true);
+   constants += stop.constant + by.constant;
+   once = once && stop.constant && by.constant && ((by.imm > 0) ? start <= stop.imm : start >= stop.imm);
+
+   // step and test at the bottom, the index stays in its register
+   std::vector<IrInstr> &tail = function.blocks[bottom].instrs;
+   IrInstr next = irMake(IrForNext);
+   int jump = nextInstr(tail, step);
+
+   next.var = index;
+   next.dst = function.numValues++;
+   uses.push_back(1);
+   tail[jump].op = IrBranchNZ;
+   tail[jump].a = next.dst;
+   tail[jump].target = body;
+   tail[jump].c = "Jump to loop body";
+   next.a = boundValue(tail, step++, stop, "stop value");
+   if (by.constant) {
+      next.imm = by.imm;
+   } else {
+      next.b = boundValue(tail, step++, by, "step value");
+   }
+   tail[step] = next;
+
+   if (once) {
+      // the first trip always runs
+      head[branch].op = IrJump;
+      head[branch].a = IR_NONE;
+      head.erase(head.begin() + test);
+      onceLoops++;
+      return true;
+   }
+
+   stopValue = boundValue(head, test++, stop, "stop value");
+   stepValue = by.constant ? IR_NONE : boundValue(head, test++, by, "step value");
+   head[test].a = stopValue;
+   head[test].b = stepValue;
+   head[test].imm = by.imm;
+
+   return true;
+}
+
+/*
+ * @brief tighten every for loop of the function
+ *
+ * @return how many
+ */
+int ForLoops::run() {
+   int operands[2], count, loops = 0;
+
+   uses.assign(function.numValues, 0);
+   for (const IrBlock &block : function.blocks) {
+      for (const IrInstr &instr : block.instrs) {
+         count = irUses(instr, operands);
+         for (int j = 0; j < count; j++) {
+            uses[operands[j]]++;
+         }
+      }
+   }
+
+   for (size_t b = 1; b < function.blocks.size(); b++) {
+      loops += tighten((int)b);
+   }
+
+   return loops;
+}
+
+/*
+ * @brief step and test every for loop at its bottom
+ *
+ * @param program - IR to optimize
+ *
+ * @return void
+ */
+void tightenForLoops(IrProgram &program) {
+   int total = 0;
+
+   for (IrFunction &function : program.functions) {
+      if (function.kind != IrUser) {
+         continue;
+      }
+
+      ForLoops loops(function);
+      int count = loops.run();
+
+      if (count > 0) {
+         optRemark("forloop", "%s: %d for loops, %d stop and step values constant, %d first tests dropped",
+                   function.name, count, loops.constantBounds(), loops.runOnce());
+      }
+      total += count;
+   }
+
+   optRemark("forloop", "%d for loops tightened", total);
+}
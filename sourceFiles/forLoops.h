@@ -0,0 +1,20 @@
+#ifndef _FORLOOPS_H_
+#define _FORLOOPS_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Cuts the work a for loop does on each trip to step its index
+ * and test it against the stop value.
+ *
+ */
+
+#include "ir.h"
+
+/*
+ * @brief test every for loop at its bottom, with constant stop and step
+ * values as constants rather than frame slots
+ */
+void tightenForLoops(bc::IrProgram &program);
+
+#endif
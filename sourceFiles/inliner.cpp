@@ -0,0 +1,403 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Inlines calls to small functions. The body of the function
+ * called is copied into the caller where the call was and runs in the
+ * ghost frame the call had set up, so its parameters are the slots the
+ * arguments were pushed into and its own variables and temporaries are
+ * where they always were relative to FP. What goes is the jump there,
+ * saving the return address and the jump back: the copy starts by
+ * making the ghost frame the active frame (IrInlineEnter), a return
+ * jumps to the join block after the copy, which goes back to the frame
+ * of the caller and takes the result (IrInlineExit).
+ *
+ * A function on a cycle of the call graph is never inlined. The others
+ * are inlined callees first, so a body is copied with the calls it
+ * makes already inlined, and its size is the size after that. A call
+ * is inlined when the body has at most ctx->inlineLimit instructions,
+ * or at most SINGLE_SITE_FACTOR times that when it is the only call of
+ * the function. deadfunc then removes the function, but the copy is
+ * made first, and a chain of functions each calling the one before
+ * would otherwise be copied whole into every caller up the chain, so
+ * the code grows with the square of its length.
+ *
+ */
+
+#include <unordered_map>
+#include <vector>
+#include "inliner.h"
+#include "compilerContext.h"
+#include "passManager.h"
+
+#define SINGLE_SITE_FACTOR 8               // times the limit a function called once may be
+
+using namespace bc;
+
+// Inlines the calls of one program
+class Inliner {
+private:
+   std::vector<IrFunction> &functions;
+   int limit;                             // instructions of a body always inlined
+   std::unordered_map<const TreeNode *, int> indexOf;   // function of each declaration
+   std::vector<std::vector<int>> callees; // functions each function calls
+   std::vector<int> sites;                // calls to each function
+   std::vector<int> size;                 // instructions of each body
+   std::vector<bool> recursive;           // on a cycle of the call graph
+   std::vector<int> order;                // callees before their callers
+   int calls, inlined;
+
+   int calleeOf(const IrInstr &instr);
+   void callGraph();
+   std::vector<int> liveBlocks(const IrFunction &function);
+   int bodySize(const IrFunction &function);
+   bool worthIt(int callee);
+   void copyBody(const IrFunction &callee, int firstValue, std::vector<IrBlock> &out);
+   void inlineCalls(IrFunction &caller);
+
+public:
+   Inliner(std::vector<IrFunction> &functions, int limit);
+   void run();
+};
+
+Inliner::Inliner(std::vector<IrFunction> &functions, int limit) :
+   functions(functions), limit(limit), calls(0), inlined(0) {}
+
+/*
+ * @brief function an instruction calls
+ *
+ * @param instr - instruction
+ *
+ * @return its index, -1 if it is not a call of a function of the program
+ */
+int Inliner::calleeOf(const IrInstr &instr) {
+   if (instr.op != IrCall) {
+      return -1;
+   }
+
+   auto callee = indexOf.find(instr.func);
+
+   return (callee == indexOf.end()) ? -1 : callee->second;
+}
+
+/*
+ * @brief find the calls, the functions on cycles and an order with
+ * every function after those it calls. The strongly connected
+ * components of the call graph are found by Tarjan's algorithm, which
+ * finishes a component only after every component it reaches.
+ *
+ * @return void
+ */
+void Inliner::callGraph() {
+   int count = (int)functions.size(), next = 0;
+   std::vector<int> index(count, -1), low(count, 0);
+   std::vector<bool> onStack(count, false);
+   std::vector<int> stack;
+   struct Frame {
+      int function;
+      size_t edge;                         // next callee to look at
+   };
+   std::vector<Frame> work;
+
+   callees.assign(count, std::vector<int>());
+   sites.assign(count, 0);
+   recursive.assign(count, false);
+   order.clear();
+
+   for (int i = 0; i < count; i++) {
+      for (const IrBlock &block : functions[i].blocks) {
+         for (const IrInstr &instr : block.instrs) {
+            int callee = calleeOf(instr);
+
+            if (callee >= 0) {
+               callees[i].push_back(callee);
+               sites[callee]++;
+               recursive[callee] = recursive[callee] || callee == i;
+            }
+         }
+      }
+   }
+
+   for (int root = 0; root < count; root++) {
+      if (index[root] >= 0) {
+         continue;
+      }
+      work.push_back(Frame{root, 0});
+      index[root] = low[root] = next++;
+      stack.push_back(root);
+      onStack[root] = true;
+
+      while (!work.empty()) {
+         Frame &frame = work.back();
+         int f = frame.function;
+
+         if (frame.edge < callees[f].size()) {
+            int callee = callees[f][frame.edge++];
+
+            if (index[callee] < 0) {
+               index[callee] = low[callee] = next++;
+               stack.push_back(callee);
+               onStack[callee] = true;
+               work.push_back(Frame{callee, 0});
+            } else if (onStack[callee] && index[callee] < low[f]) {
+               low[f] = index[callee];
+            }
+            continue;
+         }
+
+         work.pop_back();
+         if (!work.empty() && low[f] < low[work.back().function]) {
+            low[work.back().function] = low[f];
+         }
+         if (low[f] != index[f]) {
+            continue;
+         }
+
+         // f is the first of its component, which is everything above it
+         size_t first = stack.size();
+
+         do {
+            first--;
+         } while (stack[first] != f);
+         for (size_t i = first; i < stack.size(); i++) {
+            onStack[stack[i]] = false;
+            recursive[stack[i]] = recursive[stack[i]] || stack.size() - first > 1;
+            order.push_back(stack[i]);
+         }
+         stack.resize(first);
+      }
+   }
+}
+
+/*
+ * @brief the blocks of a function that can run, in layout order. The
+ * standard closing after a function's last return is never reached.
+ *
+ * @param function - the function
+ *
+ * @return index of each block that can run
+ */
+std::vector<int> Inliner::liveBlocks(const IrFunction &function) {
+   std::vector<bool> reached(function.blocks.size(), false);
+   std::vector<int> work, live;
+
+   if (!function.blocks.empty()) {
+      reached[0] = true;
+      work.push_back(0);
+   }
+   while (!work.empty()) {
+      int b = work.back();
+      const IrInstr *last = NULL;
+
+      work.pop_back();
+      for (const IrInstr &instr : function.blocks[b].instrs) {
+         if (instr.op != IrComment && instr.op != IrCommentInt) {
+            last = &instr;
+         }
+         if (irIsTerminator(instr.op) && instr.target >= 0 && !reached[instr.target]) {
+            reached[instr.target] = true;
+            work.push_back(instr.target);
+         }
+      }
+      // a block that does not end in a jump or return falls through
+      if (last == NULL || last->op == IrBranchZ || last->op == IrBranchNZ || !irIsTerminator(last->op)) {
+         if ((size_t)b + 1 < function.blocks.size() && !reached[b + 1]) {
+            reached[b + 1] = true;
+            work.push_back(b + 1);
+         }
+      }
+   }
+
+   for (size_t b = 0; b < function.blocks.size(); b++) {
+      if (reached[b]) {
+         live.push_back((int)b);
+      }
+   }
+
+   return live;
+}
+
+/*
+ * @brief instructions a copy of the body of a function makes code from
+ *
+ * @param function - the function
+ *
+ * @return how many
+ */
+int Inliner::bodySize(const IrFunction &function) {
+   int count = 0;
+
+   for (int b : liveBlocks(function)) {
+      for (const IrInstr &instr : function.blocks[b].instrs) {
+         if (instr.op != IrComment && instr.op != IrCommentInt && instr.op != IrTempTop &&
+               instr.op != IrEnter) {
+            count++;
+         }
+      }
+   }
+
+   return count;
+}
+
+/*
+ * @brief should the calls of a function be inlined
+ */
+bool Inliner::worthIt(int callee) {
+   int most = (sites[callee] == 1) ? limit * SINGLE_SITE_FACTOR : limit;
+
+   return !recursive[callee] && size[callee] <= most;
+}
+
+/*
+ * @brief add a copy of the body of a function to the end of out, the
+ * join block is the one after it
+ *
+ * @param callee - function copied
+ * @param firstValue - its values become firstValue on
+ * @param out - blocks of the caller being built
+ *
+ * @return void
+ */
+void Inliner::copyBody(const IrFunction &callee, int firstValue, std::vector<IrBlock> &out) {
+   std::vector<int> live = liveBlocks(callee);
+   std::vector<int> newIndex(callee.blocks.size(), -1);
+   int base = (int)out.size(), join = base + (int)live.size();
+
+   for (size_t k = 0; k < live.size(); k++) {
+      newIndex[live[k]] = base + (int)k;
+   }
+
+   for (size_t k = 0; k < live.size(); k++) {
+      bool started = false, returned = false;
+
+      out.push_back(IrBlock());
+      for (const IrInstr &from : callee.blocks[live[k]].instrs) {
+         IrInstr instr = from;
+         bool comment = (instr.op == IrComment || instr.op == IrCommentInt);
+
+         // the banner of the function and what follows a return stay out
+         if ((comment && ((k == 0 && !started) || returned)) || instr.op == IrEnter) {
+            continue;
+         }
+         started = true;
+
+         if (instr.dst >= 0) {
+            instr.dst += firstValue;
+         }
+         if (instr.a >= 0) {
+            instr.a += firstValue;
+         }
+         if (instr.b >= 0) {
+            instr.b += firstValue;
+         }
+         if (instr.target >= 0) {
+            instr.target = newIndex[instr.target];
+         }
+         if (instr.op == IrRet) {
+            returned = true;
+            // the last block runs on into the join block
+            if (k + 1 == live.size()) {
+               continue;
+            }
+            instr.op = IrJump;
+            instr.target = join;
+            instr.c = "return";
+         }
+         out.back().instrs.push_back(instr);
+      }
+   }
+}
+
+/*
+ * @brief inline the calls of a function that are worth it
+ *
+ * @param caller - function to inline into
+ *
+ * @return void
+ */
+void Inliner::inlineCalls(IrFunction &caller) {
+   std::vector<IrBlock> out;
+   std::vector<int> newIndex(caller.blocks.size(), 0);
+   int at = 0;
+
+   // where each block goes once the bodies are in
+   for (size_t b = 0; b < caller.blocks.size(); b++) {
+      newIndex[b] = at++;
+      for (const IrInstr &instr : caller.blocks[b].instrs) {
+         int callee = calleeOf(instr);
+
+         if (callee >= 0 && worthIt(callee)) {
+            at += (int)liveBlocks(functions[callee]).size() + 1;
+         }
+      }
+   }
+
+   for (IrBlock &block : caller.blocks) {
+      out.push_back(IrBlock());
+      for (const IrInstr &from : block.instrs) {
+         IrInstr instr = from;
+         int callee = calleeOf(instr);
+
+         if (instr.target >= 0) {
+            instr.target = newIndex[instr.target];
+         }
+         if (callee >= 0) {
+            calls++;
+         }
+         if (callee < 0 || !worthIt(callee)) {
+            out.back().instrs.push_back(instr);
+            continue;
+         }
+
+         const IrFunction &body = functions[callee];
+         IrInstr enter = irMake(IrInlineEnter), exit = irMake(IrInlineExit);
+
+         enter.func = exit.func = instr.func;
+         exit.dst = instr.dst;
+         out.back().instrs.push_back(enter);
+         copyBody(body, caller.numValues, out);
+         caller.numValues += body.numValues;
+         out.push_back(IrBlock());
+         out.back().instrs.push_back(exit);
+
+         inlined++;
+         optRemark("inline", "%s into %s, %d instructions", body.name, caller.name, size[callee]);
+      }
+   }
+
+   caller.blocks.swap(out);
+}
+
+/*
+ * @brief inline the calls worth it in every function, callees first
+ *
+ * @return void
+ */
+void Inliner::run() {
+   for (size_t i = 0; i < functions.size(); i++) {
+      if (functions[i].kind == IrUser || functions[i].kind == IrLibrary) {
+         indexOf[functions[i].decl] = (int)i;
+      }
+   }
+   callGraph();
+
+   size.assign(functions.size(), 0);
+   for (int f : order) {
+      if (functions[f].kind == IrUser) {
+         inlineCalls(functions[f]);
+      }
+      size[f] = bodySize(functions[f]);
+   }
+
+   optRemark("inline", "%d of %d calls inlined", inlined, calls);
+}
+
+/*
+ * @brief inline calls of small functions and of functions called once
+ *
+ * @param program - IR to inline in
+ *
+ * @return void
+ */
+void inlineFunctions(IrProgram &program) {
+   Inliner(program.functions, ctx->inlineLimit).run();
+}
@@ -0,0 +1,20 @@
+#ifndef _INLINER_H_
+#define _INLINER_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Copies the bodies of small functions that are not recursive
+ * into their callers in place of the calls.
+ *
+ */
+
+#include "ir.h"
+
+/*
+ * @brief inline calls of small functions and of functions called once,
+ * small is at most ctx->inlineLimit IR instructions
+ */
+void inlineFunctions(bc::IrProgram &program);
+
+#endif
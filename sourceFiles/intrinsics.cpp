@@ -0,0 +1,116 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief The IO library functions are intrinsics. Each is a single IN,
+ * OUT or OUTNL wrapped in the calling sequence: the ghost frame, the
+ * parameter pushed into it, the return address, the jump there and
+ * back. A call to one becomes the instruction itself, its argument is
+ * output straight from the value and an input is read straight into
+ * the value of the call. bC has no function values so no call needs
+ * the library function itself, once every call is lowered deadfunc
+ * drops them.
+ *
+ */
+
+#include <string.h>
+#include <vector>
+#include "intrinsics.h"
+#include "irgen.h"
+#include "passManager.h"
+
+using namespace bc;
+
+/*
+ * @brief lower the calls to the IO library functions in one function
+ *
+ * @param function - function to rewrite
+ *
+ * @return how many calls were lowered
+ */
+static int inlineFunction(IrFunction &function) {
+   std::vector<const IrIntrinsic *> calls;    // intrinsic of each call being made, NULL for none
+   int count = 0;
+
+   for (IrBlock &block : function.blocks) {
+      std::vector<IrInstr> instrs;
+
+      for (size_t i = 0; i < block.instrs.size(); i++) {
+         IrInstr instr = block.instrs[i];
+         const IrIntrinsic *fun;
+
+         switch (instr.op) {
+            case IrCallBegin:
+               fun = irIntrinsic(instr.func);
+               calls.push_back(fun);
+               if (fun == NULL) {
+                  break;
+               }
+               // with the frame goes the comment of its parameter
+               if (i + 1 < block.instrs.size() && block.instrs[i + 1].op == IrComment &&
+                     block.instrs[i + 1].c != NULL && strcmp(block.instrs[i + 1].c, "Param") == 0) {
+                  i++;
+               }
+               continue;
+
+            case IrArg:
+               fun = calls.back();
+               if (fun == NULL) {
+                  break;
+               }
+               instr.op = IrOut;
+               instr.func = NULL;
+               instr.imm = 0;
+               instr.type = fun->type;
+               instr.c = fun->c;
+               break;
+
+            case IrCall:
+               fun = calls.back();
+               calls.pop_back();
+               if (fun == NULL) {
+                  break;
+               }
+               count++;
+               if (fun->op == IrOut) {
+                  // the result of a void function is never used
+                  continue;
+               }
+               instr.op = fun->op;
+               instr.func = NULL;
+               instr.type = fun->type;
+               instr.c = fun->c;
+               if (fun->op == IrOutNl) {
+                  instr.dst = IR_NONE;
+               }
+               break;
+
+            default:
+               break;
+         }
+         instrs.push_back(instr);
+      }
+      block.instrs.swap(instrs);
+   }
+
+   return count;
+}
+
+/*
+ * @brief replace every call to an IO library function by its IN or OUT
+ * instruction
+ *
+ * @param program - IR to rewrite
+ *
+ * @return void
+ */
+void inlineIntrinsics(IrProgram &program) {
+   int count = 0;
+
+   for (IrFunction &function : program.functions) {
+      if (function.kind != IrLibrary) {
+         count += inlineFunction(function);
+      }
+   }
+
+   optRemark("intrinsics", "%d calls lowered", count);
+}
@@ -0,0 +1,20 @@
+#ifndef _INTRINSICS_H_
+#define _INTRINSICS_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Lowers the calls to the IO library functions to the one
+ * instruction each of them is made of.
+ *
+ */
+
+#include "ir.h"
+
+/*
+ * @brief replace every call to an IO library function by its IN or OUT
+ * instruction
+ */
+void inlineIntrinsics(bc::IrProgram &program);
+
+#endif
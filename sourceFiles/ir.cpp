@@ -0,0 +1,402 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief What each IR instruction takes, the verifier and the dump
+ * of the intermediate form.
+ *
+ */
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include "ir.h"
+#include "compilerContext.h"
+
+extern char *largerTokens[];
+
+namespace bc {
+
+// The operands of an instruction. Values from minUses up to maxUses
+// may be left out.
+struct IrOpInfo {
+   const char *name;                      // name in the dump
+   bool dst;                              // defines a value
+   int minUses, maxUses;                  // values used, a then b
+   bool var;                              // reads or writes a variable
+   bool func;                             // names a function
+   bool target;                           // jumps to a block
+};
+
+// indexed by IrOp
+static const IrOpInfo irOpInfo[] = {
+   {"comment", false, 0, 0, false, false, false},
+   {"comment", false, 0, 0, false, false, false},
+   {"temptop", false, 0, 0, false, false, false},
+   {"enter", false, 0, 0, false, false, false},
+   {"init", false, 0, 0, false, false, false},
+   {"const", true, 0, 0, false, false, false},
+   {"string", true, 0, 0, true, false, false},
+   {"load", true, 0, 0, true, false, false},
+   {"addr", true, 0, 0, true, false, false},
+   {"store", false, 1, 1, true, false, false},
+   {"unary", true, 1, 1, false, false, false},
+   {"binary", true, 2, 2, false, false, false},
+   {"elem", true, 2, 2, false, false, false},
+   {"update", true, 0, 1, true, false, false},
+   {"updateelem", true, 1, 2, true, false, false},
+   {"arraycopy", false, 1, 1, true, false, false},
+   {"callbegin", false, 0, 0, false, true, false},
+   {"arg", false, 1, 1, false, true, false},
+   {"call", true, 0, 0, false, true, false},
+   {"inlineenter", false, 0, 0, false, true, false},
+   {"inlineexit", true, 0, 0, false, true, false},
+   {"in", true, 0, 0, false, false, false},
+   {"out", false, 1, 1, false, false, false},
+   {"outnl", false, 0, 0, false, false, false},
+   {"fortest", true, 0, 2, true, false, false},
+   {"forstep", false, 0, 0, true, false, false},
+   {"fornext", true, 1, 2, true, false, false},
+   {"setret", false, 0, 1, false, false, false},
+   {"start", false, 0, 0, false, false, false},
+   {"jump", false, 0, 0, false, false, true},
+   {"branchz", false, 1, 1, false, false, true},
+   {"branchnz", false, 1, 1, false, false, true},
+   {"ret", false, 0, 0, false, false, false},
+   {"halt", false, 0, 0, false, false, false},
+   {"restart", false, 0, 0, false, false, false},
+};
+
+static_assert(sizeof(irOpInfo) / sizeof(irOpInfo[0]) == NUM_IR_OPS, "irOpInfo must have an entry for every IrOp");
+
+const char *irOpName(IrOp op) {
+   return irOpInfo[op].name;
+}
+
+int irUses(const IrInstr &instr, int uses[2]) {
+   int count = 0;
+
+   if (irOpInfo[instr.op].maxUses > 0 && instr.a != IR_NONE) {
+      uses[count++] = instr.a;
+   }
+   if (irOpInfo[instr.op].maxUses > 1 && instr.b != IR_NONE) {
+      uses[count++] = instr.b;
+   }
+
+   return count;
+}
+
+// Checks one function, remembering where it is for the messages
+class IrVerifier {
+private:
+   const IrFunction &function;
+   size_t block, index;                   // instruction being checked
+   std::vector<bool> defined;             // values defined so far in layout order
+   std::vector<const IrInstr *> calls;    // calls being made, innermost last
+   std::vector<int> args;                 // parameters given to each
+   bool ok;
+
+   void fail(const char *problem);
+   void checkValue(int value, bool optional);
+   void checkInstr(const IrInstr &instr);
+
+public:
+   IrVerifier(const IrFunction &function) : function(function), block(0), index(0), ok(true) {}
+   bool run();
+};
+
+/*
+ * @brief report a problem with the instruction being checked
+ *
+ * @param problem - what is wrong
+ *
+ * @return void
+ */
+void IrVerifier::fail(const char *problem) {
+   std::string message = "ir: ";
+
+   message += function.name ? function.name : "(init)";
+   message += " block " + std::to_string(block) + " instruction " + std::to_string(index) + ": ";
+   message += problem;
+   diagnose(InternalError, 0, {message.c_str()});
+   ok = false;
+}
+
+/*
+ * @brief check a value used is one defined before it
+ *
+ * @param value - value used
+ * @param optional - it may be IR_NONE
+ *
+ * @return void
+ */
+void IrVerifier::checkValue(int value, bool optional) {
+   if (value == IR_NONE) {
+      if (!optional) {
+         fail("missing operand");
+      }
+      return;
+   }
+   if (value < 0 || value >= function.numValues) {
+      fail("operand is not a value");
+   } else if (!defined[value]) {
+      fail("value used before it is defined");
+   }
+}
+
+/*
+ * @brief check the operands of one instruction
+ *
+ * @param instr - instruction to check
+ *
+ * @return void
+ */
+void IrVerifier::checkInstr(const IrInstr &instr) {
+   if (instr.op < 0 || instr.op >= NUM_IR_OPS) {
+      fail("unknown op");
+      return;
+   }
+
+   const IrOpInfo &info = irOpInfo[instr.op];
+
+   checkValue(instr.a, info.minUses < 1);
+   checkValue(instr.b, info.minUses < 2);
+   if (info.maxUses < 1 && instr.a != IR_NONE) {
+      fail("op takes no operand a");
+   }
+   if (info.maxUses < 2 && instr.b != IR_NONE) {
+      fail("op takes no operand b");
+   }
+   if (info.var && instr.var.kind == None) {
+      fail("variable has no kind");
+   }
+   if (info.func && instr.func == NULL) {
+      fail("no function");
+   }
+   if (info.target && (instr.target < 0 || (size_t)instr.target >= function.blocks.size())) {
+      fail("jump to a block that does not exist");
+   }
+
+   switch (instr.op) {
+      case IrCallBegin:
+         calls.push_back(&instr);
+         args.push_back(0);
+         break;
+      case IrArg:
+         if (calls.empty() || calls.back()->func != instr.func) {
+            fail("parameter outside its call");
+         } else if (instr.imm != ++args.back()) {
+            fail("parameters out of order");
+         }
+         break;
+      case IrInlineEnter:
+         if (calls.empty() || calls.back()->func != instr.func) {
+            fail("inlined body without callbegin");
+         }
+         break;
+      case IrCall:
+      case IrInlineExit:
+         if (calls.empty() || calls.back()->func != instr.func) {
+            fail("call without callbegin");
+         } else {
+            calls.pop_back();
+            args.pop_back();
+         }
+         break;
+      default:
+         break;
+   }
+
+   if (info.dst) {
+      if (instr.dst == IR_RESULT && instr.op == IrIn) {
+         // the return value of a library function
+      } else if (instr.dst < 0 || instr.dst >= function.numValues) {
+         fail("result is not a value");
+      } else if (defined[instr.dst]) {
+         fail("value defined twice");
+      } else {
+         defined[instr.dst] = true;
+      }
+   } else if (instr.dst != IR_NONE) {
+      fail("op defines no value");
+   }
+}
+
+/*
+ * @brief check every block of the function
+ *
+ * @return false if anything was wrong
+ */
+bool IrVerifier::run() {
+   defined.assign(function.numValues > 0 ? function.numValues : 0, false);
+
+   for (block = 0; block < function.blocks.size(); block++) {
+      const std::vector<IrInstr> &instrs = function.blocks[block].instrs;
+      bool ended = false;
+
+      // only comments may follow the instruction that ends a block
+      for (index = 0; index < instrs.size(); index++) {
+         checkInstr(instrs[index]);
+         if (ended && instrs[index].op != IrComment && instrs[index].op != IrCommentInt) {
+            fail("block goes on after its end");
+         }
+         ended = ended || irIsTerminator(instrs[index].op);
+      }
+   }
+
+   block = function.blocks.empty() ? 0 : function.blocks.size() - 1;
+   index = 0;
+   if (!calls.empty()) {
+      fail("call not finished");
+   }
+
+   // only the code made for a declaration runs off its end
+   if (function.kind != IrDecl) {
+      const IrInstr *last = NULL;
+
+      if (!function.blocks.empty()) {
+         for (const IrInstr &instr : function.blocks.back().instrs) {
+            if (instr.op != IrComment && instr.op != IrCommentInt) {
+               last = &instr;
+            }
+         }
+      }
+      if (last == NULL || last->op == IrBranchZ || last->op == IrBranchNZ || !irIsTerminator(last->op)) {
+         fail("function runs off its end");
+      }
+   }
+
+   return ok;
+}
+
+bool irVerify(const IrProgram &program) {
+   bool ok = true;
+
+   for (const IrFunction &function : program.functions) {
+      IrVerifier verifier(function);
+
+      ok = verifier.run() && ok;
+   }
+
+   return ok;
+}
+
+/*
+ * @brief text of a variable: name(kind offset)
+ */
+static void dumpVar(FILE *out, const IrVar &var) {
+   static const char *kinds[] = {"none", "local", "global", "param", "static"};
+
+   fprintf(out, "%s(%s %d)", var.name ? var.name : "", kinds[var.kind], var.offset);
+}
+
+/*
+ * @brief text of an operator token
+ */
+static const char *operName(int oper) {
+   if (oper > 0 && largerTokens[oper] != NULL) {
+      return largerTokens[oper];
+   }
+   return "?op";
+}
+
+static const char *typeNames[] = {"void", "int", "bool", "char", "undefined"};
+
+/*
+ * @brief write one instruction
+ */
+static void dumpInstr(FILE *out, const IrInstr &instr) {
+   const IrOpInfo &info = irOpInfo[instr.op];
+
+   if (instr.op == IrComment) {
+      fprintf(out, "   ; %s%s%s\n", instr.c, instr.cc ? " " : "", instr.cc ? instr.cc : "");
+      return;
+   }
+   if (instr.op == IrCommentInt) {
+      fprintf(out, "   ; %s %lld\n", instr.c, instr.imm);
+      return;
+   }
+
+   fprintf(out, "   ");
+   if (instr.dst == IR_RESULT) {
+      fprintf(out, "result = ");
+   } else if (instr.dst != IR_NONE) {
+      fprintf(out, "%%%d = ", instr.dst);
+   }
+   fprintf(out, "%s", info.name);
+
+   switch (instr.op) {
+      case IrUnary:
+      case IrBinary:
+      case IrUpdate:
+      case IrUpdateElem:
+         fprintf(out, " %s", operName(instr.oper));
+         break;
+      case IrConst:
+      case IrTempTop:
+      case IrInit:
+      case IrArg:
+         fprintf(out, " %lld", instr.imm);
+         break;
+      case IrIn:
+      case IrOut:
+         fprintf(out, " %s", typeNames[instr.type]);
+         break;
+      case IrSetRet:
+         if (instr.a == IR_NONE) {
+            fprintf(out, " %lld", instr.imm);
+         }
+         break;
+      case IrForTest:
+      case IrForNext:
+         if (instr.a != IR_NONE && instr.b == IR_NONE) {
+            fprintf(out, " by %lld", instr.imm);
+         }
+         break;
+      case IrString:
+         fprintf(out, " %s", instr.string ? instr.string : "");
+         break;
+      default:
+         break;
+   }
+
+   const char *sep = " ";
+
+   if (info.var) {
+      fprintf(out, "%s", sep);
+      dumpVar(out, instr.var);
+      sep = ", ";
+   }
+   if (info.func || (instr.op == IrStart && instr.func != NULL)) {
+      fprintf(out, "%s%s", sep, instr.func->attr.name);
+      sep = ", ";
+   }
+   if (info.maxUses > 0 && instr.a != IR_NONE) {
+      fprintf(out, "%s%%%d", sep, instr.a);
+      sep = ", ";
+   }
+   if (info.maxUses > 1 && instr.b != IR_NONE) {
+      fprintf(out, "%s%%%d", sep, instr.b);
+      sep = ", ";
+   }
+   if (info.target) {
+      fprintf(out, "%sB%d", sep, instr.target);
+   }
+   fprintf(out, "\n");
+}
+
+void irDump(FILE *out, const IrProgram &program) {
+   static const char *kinds[] = {"user", "library", "decl", "init"};
+
+   for (const IrFunction &function : program.functions) {
+      fprintf(out, "function %s (%s), %d values\n", function.name ? function.name : "(init)",
+              kinds[function.kind], function.numValues);
+      for (size_t i = 0; i < function.blocks.size(); i++) {
+         fprintf(out, "B%zu:\n", i);
+         for (const IrInstr &instr : function.blocks[i].instrs) {
+            dumpInstr(out, instr);
+         }
+      }
+   }
+}
+
+}
@@ -0,0 +1,154 @@
+#ifndef _IR_H_
+#define _IR_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Linear intermediate form between the annotated tree and the
+ * TM code. A function is a list of basic blocks of three-address
+ * instructions over values (virtual registers), frame slots and
+ * globals. Blocks are kept in the order they are laid out, a block
+ * that does not end in a jump or return falls through to the next.
+ * Values are numbered from 0 in each function and each is defined by
+ * one instruction. The comments of the listing are instructions too,
+ * so the code lowered from the IR reads the same as it always has.
+ *
+ */
+
+#include <stdio.h>
+#include <vector>
+#include "treeNodes.h"
+
+namespace bc {
+
+enum IrOp {
+    IrComment,      // a comment line: c, or c and cc when cc is not NULL
+    IrCommentInt,   // a comment line: c and imm
+    IrTempTop,      // temporaries start at imm in the frame from here on
+    IrEnter,        // save the return address, first in a function
+    IrInit,         // make the first frame at imm past the globals
+    IrConst,        // dst = imm, a constant of type
+    IrString,       // dst = address of the string literal placed at var
+    IrLoad,         // dst = var
+    IrAddr,         // dst = address of the array var
+    IrStore,        // var = a
+    IrUnary,        // dst = oper a
+    IrBinary,       // dst = a oper b
+    IrElem,         // dst = element b of the array at address a
+    IrUpdate,       // dst = var = var oper a, or var++ and var-- without a
+    IrUpdateElem,   // dst = element a of the array var oper= b, or ++ and -- without b
+    IrArrayCopy,    // copy the array at address a into the array var
+    IrCallBegin,    // start the frame of a call to func
+    IrArg,          // parameter imm of the call being made = a
+    IrCall,         // dst = call func
+    IrInlineEnter,  // the frame of the call to func becomes the active frame, the body of func follows
+    IrInlineExit,   // dst = the result of the body of func, back to the frame of the caller
+    IrIn,           // dst = input of type
+    IrOut,          // output a as type
+    IrOutNl,        // output a newline
+    IrForTest,      // dst = the for index at var < its stop value, the stop is a and the step b, or imm when there is no b, when given
+    IrForStep,      // add the step to the for index at var
+    IrForNext,      // add the step b, or imm when there is no b, to the for index at var, dst = it < the stop a
+    IrSetRet,       // the return value = a, or imm when there is no a
+    IrStart,        // jump to func, which never returns, NULL when there is no main
+
+    // the rest end a block
+    IrJump,         // go to block target
+    IrBranchZ,      // go to block target if a is zero
+    IrBranchNZ,     // go to block target if a is not zero
+    IrRet,          // return to the caller
+    IrHalt,         // stop the machine
+    IrRestart,      // jump to address 0, which runs the program again, a break outside any loop
+
+    NUM_IR_OPS
+};
+
+#define IR_NONE -1                  // no value
+#define IR_RESULT -2                // dst of IrIn that is the return value of the function
+
+// A variable as the code refers to it. Locals and parameters are in the
+// frame (FP), globals and statics in the global space (GP). An array
+// parameter holds the address of the array rather than the array.
+struct IrVar {
+    VarKind kind;                   // where it lives
+    int offset;                     // from FP or GP
+    const char *name;               // for comments, NULL for none
+};
+
+struct IrInstr {
+    IrOp op;
+    int dst;                        // value defined, IR_NONE for none
+    int a, b;                       // values used, IR_NONE for none
+    int oper;                       // bC operator token of IrUnary, IrBinary and the updates
+    long long int imm;              // constant, parameter number or temporary offset
+    ExpType type;                   // of a constant, input or output
+    IrVar var;                      // variable read or written
+    int target;                     // block jumped to
+    TreeNode *func;                 // declaration of the function called
+    const char *string;             // text of the literal of IrString
+    const char *c, *cc;             // comment of the instruction in the listing
+};
+
+struct IrBlock {
+    std::vector<IrInstr> instrs;
+};
+
+enum IrFunctionKind {
+    IrUser,                         // a function of the program
+    IrLibrary,                      // one of the IO library functions
+    IrDecl,                         // code made for a global declaration, it is never run
+    IrInitCode                      // sets up the machine and calls main
+};
+
+struct IrFunction {
+    IrFunctionKind kind;
+    TreeNode *decl;                 // declaration, NULL for the init code
+    const char *name;
+    std::vector<IrBlock> blocks;    // in layout order
+    int numValues;                  // values are 0 to numValues-1
+};
+
+struct IrProgram {
+    std::vector<IrFunction> functions;  // in the order they are laid out, the init code last
+    int globalOffset;               // size of the global space
+    bool built;                     // has irgen made it
+    bool registers;                 // expressions are ordered for codegen to keep values in registers
+};
+
+// An instruction with no operands
+inline IrInstr irMake(IrOp op) {
+    IrInstr instr;
+
+    instr.op = op;
+    instr.dst = instr.a = instr.b = IR_NONE;
+    instr.oper = 0;
+    instr.imm = 0;
+    instr.type = Void;
+    instr.var = IrVar{None, 0, NULL};
+    instr.target = -1;
+    instr.func = NULL;
+    instr.string = NULL;
+    instr.c = instr.cc = NULL;
+
+    return instr;
+}
+
+// Does an instruction end its block
+inline bool irIsTerminator(IrOp op) { return op >= IrJump; }
+
+// Name of an instruction in the dump
+const char *irOpName(IrOp op);
+
+// The values an instruction uses, returns how many (at most 2)
+int irUses(const IrInstr &instr, int uses[2]);
+
+// Check the program is well formed, each problem is reported as an
+// internal error. Returns false if there were any.
+bool irVerify(const IrProgram &program);
+
+// Write the program as text
+void irDump(FILE *out, const IrProgram &program);
+
+}
+
+#endif
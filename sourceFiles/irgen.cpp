@@ -0,0 +1,1063 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Builds the IR of a program from its annotated tree. The tree
+ * is walked in the order code has always been generated in and every
+ * expression becomes a value, so the IR lowered without optimization
+ * gives the same TM code as before.
+ */
+
+#include <stdio.h>
+#include <vector>
+#include "irgen.h"
+#include "compilerContext.h"
+#include "treeUtils.h"
+#include "scanType.h"
+#include "parser.tab.h"
+
+using namespace bc;
+
+// A node the IR is being built for.  Nodes are built on an explicit
+// stack of these rather than by recursion so deep nesting cannot run
+// the thread out of stack.  Each step adds the instructions of the
+// node up to its next child.
+struct GenVisit {
+   TreeNode *node;                        // node being built
+   int step;                              // how far its code has got
+   bool list;                             // it is in a list of statements, go on to its siblings
+   bool done;                             // its code is finished
+   int value;                             // value of the expression once done, IR_NONE for none
+   int childValue;                        // value of the child built last
+   int left;                              // value of the first operand, or the index assigned
+   int savedToffset;                      // temporary offset to put back when it is done
+   int savedBreak;                        // break block to put back when it is done
+   int top, body, exit, end;              // blocks of a loop or if
+   TreeNode *param;                       // parameter of a call being passed
+   int paramNum;                          // number of that parameter, from 1
+};
+
+class IrGen {
+private:
+   IrProgram &program;
+   IrFunction *fn;                        // function being built
+   std::vector<int> layout;               // its blocks in the order they were started
+   int cur;                               // block instructions go in, -1 after a jump or return
+   int toffset;                           // where temporaries start in the frame
+   int breakBlock;                        // block a break jumps to, -1 outside loops
+
+   IrInstr &add(const IrInstr &instr);
+   IrInstr &add(IrOp op, const char *c = NULL, const char *cc = NULL);
+   void comment(const char *c);
+   void comment(const char *c, const char *cc);
+   void commentInt(const char *c, int n);
+   void commentLineNum(TreeNode *current);
+   int newValue();
+   int newBlock();
+   void startBlock(int block);
+   void jump(IrOp op, int cond, int target, const char *c);
+   IrVar varOf(TreeNode *node);
+   int arraySize(TreeNode *current);
+
+   TreeNode *stepFun(GenVisit &v, bool &list);
+   TreeNode *stepStatement(GenVisit &v, bool &list);
+   TreeNode *stepExpression(GenVisit &v, bool &list);
+   TreeNode *stepDecl(GenVisit &v, bool &list);
+   void pushVisit(std::vector<GenVisit> &stack, TreeNode *node, bool list);
+
+public:
+   IrGen(IrProgram &program);
+
+   void beginFunction(IrFunctionKind kind, TreeNode *decl, const char *name);
+   void endFunction();
+   int runVisits(TreeNode *start, bool list);
+   void libraryFun(TreeNode *current);
+   void initCode(int globalOffset);
+};
+
+IrGen::IrGen(IrProgram &program) : program(program), fn(NULL), cur(-1), toffset(0), breakBlock(-1) {}
+
+/*
+ * @brief add an instruction to the block being built, code after a
+ * jump or return starts a new block and comments stay with the block
+ * before
+ *
+ * @param instr - instruction to add
+ *
+ * @return the instruction in the block
+ */
+IrInstr &IrGen::add(const IrInstr &instr) {
+   if (cur < 0) {
+      if (instr.op != IrComment && instr.op != IrCommentInt) {
+         startBlock(newBlock());
+      } else if (layout.empty()) {
+         startBlock(newBlock());
+      } else {
+         fn->blocks[layout.back()].instrs.push_back(instr);
+         return fn->blocks[layout.back()].instrs.back();
+      }
+   }
+   fn->blocks[cur].instrs.push_back(instr);
+   if (irIsTerminator(instr.op)) {
+      cur = -1;
+   }
+
+   return fn->blocks[layout.back()].instrs.back();
+}
+
+IrInstr &IrGen::add(IrOp op, const char *c, const char *cc) {
+   IrInstr instr = irMake(op);
+
+   instr.c = c;
+   instr.cc = cc;
+
+   return add(instr);
+}
+
+void IrGen::comment(const char *c) {
+   add(IrComment, c);
+}
+
+void IrGen::comment(const char *c, const char *cc) {
+   add(IrComment, c, (cc != NULL) ? cc : "");
+}
+
+void IrGen::commentInt(const char *c, int n) {
+   add(IrCommentInt, c).imm = n;
+}
+
+/*
+ * @brief Comment out line number for node
+ */
+void IrGen::commentLineNum(TreeNode *current) {
+   char buff[16];
+
+   if (ctx->linenumFlag) {
+      snprintf(buff, 16, "%d", current->lineno);
+      comment("Line: ", ctx->arena.copyString(buff));
+   }
+}
+
+int IrGen::newValue() {
+   return fn->numValues++;
+}
+
+int IrGen::newBlock() {
+   fn->blocks.push_back(IrBlock());
+
+   return (int)fn->blocks.size() - 1;
+}
+
+/*
+ * @brief lay out a block next, the block before falls through to it
+ * unless it ended in a jump or return
+ */
+void IrGen::startBlock(int block) {
+   layout.push_back(block);
+   cur = block;
+}
+
+/*
+ * @brief end the block with a jump. Whatever is built next goes in a
+ * new block, the one a conditional jump falls through to.
+ *
+ * @param op - IrJump, IrBranchZ or IrBranchNZ
+ * @param cond - value tested, IR_NONE for IrJump
+ * @param target - block jumped to
+ * @param c - comment
+ *
+ * @return void
+ */
+void IrGen::jump(IrOp op, int cond, int target, const char *c) {
+   IrInstr &instr = add(op, c);
+
+   instr.a = cond;
+   instr.target = target;
+}
+
+/*
+ * @brief the variable a declaration or use refers to
+ */
+IrVar IrGen::varOf(TreeNode *node) {
+   return IrVar{node->varKind, node->offset, node->attr.name};
+}
+
+/*
+ * @brief load the size of a declared array, kept in the slot before
+ * its first element
+ *
+ * @return value of the size
+ */
+int IrGen::arraySize(TreeNode *current) {
+   IrInstr &size = add(IrConst, "load size of array", current->attr.name);
+
+   size.dst = newValue();
+   size.imm = current->size - 1;
+   size.type = Integer;
+
+   return size.dst;
+}
+
+/*
+ * @brief start building a function
+ */
+void IrGen::beginFunction(IrFunctionKind kind, TreeNode *decl, const char *name) {
+   program.functions.push_back(IrFunction());
+   fn = &program.functions.back();
+   fn->kind = kind;
+   fn->decl = decl;
+   fn->name = name;
+   fn->numValues = 0;
+   layout.clear();
+   cur = -1;
+}
+
+/*
+ * @brief finish the function being built, its blocks are put in the
+ * order they were laid out. Code for a declaration that made no
+ * instructions is dropped.
+ *
+ * @return void
+ */
+void IrGen::endFunction() {
+   std::vector<int> index(fn->blocks.size(), -1);
+   std::vector<IrBlock> blocks;
+
+   for (size_t i = 0; i < layout.size(); i++) {
+      index[layout[i]] = (int)i;
+      blocks.push_back(std::move(fn->blocks[layout[i]]));
+   }
+   for (IrBlock &block : blocks) {
+      for (IrInstr &instr : block.instrs) {
+         if (instr.target >= 0) {
+            instr.target = index[instr.target];
+         }
+      }
+   }
+   fn->blocks = std::move(blocks);
+
+   if (fn->kind == IrDecl) {
+      bool empty = true;
+
+      for (IrBlock &block : fn->blocks) {
+         empty = empty && block.instrs.empty();
+      }
+      if (empty) {
+         program.functions.pop_back();
+      }
+   }
+   fn = NULL;
+}
+
+/*
+ * @brief the instruction an IO library function is made of
+ *
+ * @param decl - declaration of a function
+ *
+ * @return the instruction, NULL if decl is not a library function
+ */
+const IrIntrinsic *irIntrinsic(const TreeNode *decl) {
+   static const IrIntrinsic library[] = {
+      {"input", IrIn, Integer, "Grab int input"},
+      {"inputb", IrIn, Boolean, "Grab bool input"},
+      {"inputc", IrIn, Char, "Grab char input"},
+      {"output", IrOut, Integer, "Output integer"},
+      {"outputb", IrOut, Boolean, "Output bool"},
+      {"outputc", IrOut, Char, "Output char"},
+      {"outnl", IrOutNl, Void, "Output a newline"},
+   };
+
+   if (decl == NULL || decl->lineno != -1) {
+      return NULL;
+   }
+   // names are interned so comparing handles compares names
+   for (const IrIntrinsic &fun : library) {
+      if (decl->attr.name == ctx->stringPool.intern(fun.name)) {
+         return &fun;
+      }
+   }
+
+   return NULL;
+}
+
+/*
+ * @brief Build the body of a library function
+ */
+void IrGen::libraryFun(TreeNode *current) {
+   commentLineNum(current);
+   comment("");
+   comment("** ** ** ** ** ** ** ** ** ** ** **");
+   comment("FUNCTION", current->attr.name);
+
+   add(IrEnter, "Store return address");
+
+   const IrIntrinsic *fun = irIntrinsic(current);
+
+   if (fun == NULL) {
+      comment("ERROR(LINKER): No support for special function");
+      comment(current->attr.name);
+   } else if (fun->op == IrIn) {
+      IrInstr &in = add(IrIn, fun->c);
+
+      in.dst = IR_RESULT;
+      in.type = fun->type;
+   } else if (fun->op == IrOut) {
+      IrInstr load = irMake(IrLoad);
+
+      load.dst = newValue();
+      load.var = IrVar{Parameter, -2, NULL};
+      load.c = "Load parameter";
+      add(load);
+
+      IrInstr &out = add(IrOut, fun->c);
+
+      out.a = load.dst;
+      out.type = fun->type;
+   } else {
+      add(IrOutNl, fun->c);
+   }
+
+   add(IrRet);
+   comment("END FUNCTION", current->attr.name);
+}
+
+/*
+ * @brief Build the next step of a function
+ *
+ * @param v - visit of the function
+ * @param list - set when the child returned is a list of statements
+ *
+ * @return child to build before the next step, NULL for none
+ */
+TreeNode *IrGen::stepFun(GenVisit &v, bool &list) {
+   TreeNode *current = v.node;
+
+   switch (v.step++) {
+      case 0:
+         comment("");
+         comment("** ** ** ** ** ** ** ** ** ** ** **");
+         comment("FUNCTION", current->attr.name);
+         toffset = current->size;
+         add(IrTempTop, "TOFF set:").imm = toffset;
+
+         add(IrEnter, "Store return address");
+
+         // build the statements
+         list = true;
+         return current->child[1];
+   }
+
+   // in case there was no return statement, set return register to 0 and return
+   comment("Add standard closing in case there is no return statement");
+   add(IrSetRet, "Set return value to 0").imm = 0;
+   add(IrRet);
+   comment("END FUNCTION", current->attr.name);
+
+   v.done = true;
+
+   return NULL;
+}
+
+/*
+ * @brief Build the next step of a statement
+ *
+ * @param v - visit of the statement
+ * @param list - set when the child returned is a list of statements
+ *
+ * @return child to build before the next step, NULL for none
+ */
+TreeNode *IrGen::stepStatement(GenVisit &v, bool &list) {
+   TreeNode *current = v.node;
+   TreeNode *rangeNode;
+   IrVar index;
+
+   if (v.step == 0) {
+      commentLineNum(current);
+   }
+
+   switch (current->kind.stmt) {
+      case IfK:
+         switch (v.step++) {
+            case 0:
+               comment("IF");
+               return current->child[0];
+
+            case 1:
+               // the else part, or the end when there is none
+               v.exit = newBlock();
+               jump(IrBranchZ, v.childValue, v.exit, "Jump around the THEN if false [backpatch]");
+               comment("THEN");
+               list = true;
+               return current->child[1];
+
+            case 2:
+               if (current->child[2] != NULL) {
+                  v.end = newBlock();
+                  jump(IrJump, IR_NONE, v.end, "Jump around the ELSE [backpatch]");
+                  startBlock(v.exit);
+                  comment("ELSE");
+                  list = true;
+                  return current->child[2];
+               }
+               startBlock(v.exit);
+               break;
+
+            case 3:
+               startBlock(v.end);
+               break;
+         }
+
+         comment("END IF");
+         break;
+
+      case WhileK:
+         switch (v.step++) {
+            case 0:
+               comment("WHILE");
+
+               // return here to do the test
+               v.top = newBlock();
+               startBlock(v.top);
+
+               // test expression
+               return current->child[0];
+
+            case 1:
+               v.body = newBlock();
+               v.exit = newBlock();
+               v.end = newBlock();
+               jump(IrBranchNZ, v.childValue, v.body, "Jump to while part");
+
+               // a break jumps back to the jump to the end of the loop
+               startBlock(v.exit);
+               comment("DO");
+               jump(IrJump, IR_NONE, v.end, "Jump past loop [backpatch]");
+               v.savedBreak = breakBlock;
+               breakBlock = v.exit;
+
+               // do body of loop
+               startBlock(v.body);
+               list = true;
+               return current->child[1];
+         }
+
+         jump(IrJump, IR_NONE, v.top, "go to beginning of loop");
+         startBlock(v.end);
+
+         // restore break statement
+         breakBlock = v.savedBreak;
+         comment("END WHILE");
+
+         break;
+
+      case ForK:
+         // the index is child 0, the range child 1 and the body child 2,
+         // the stop and step values are kept just below the index
+         rangeNode = current->child[1];
+         index = IrVar{Local, (current->child[0] != NULL) ? current->child[0]->offset : 0,
+            (current->child[0] != NULL) ? current->child[0]->attr.name : NULL};
+
+         switch (v.step++) {
+            case 0:
+               v.savedToffset = toffset;
+               toffset = current->size;
+
+               add(IrTempTop, "TOFF set:").imm = toffset;
+               comment("FOR");
+
+               if (current->child[0] == NULL) {
+                  diagnose(InternalError, current->lineno, {"codegen: for loop has no index"});
+                  break;
+               }
+
+               if (rangeNode == NULL) {
+                  diagnose(InternalError, current->lineno, {"codegen: for loop has no range"});
+                  break;
+               }
+               return rangeNode->child[0];
+
+            case 1:
+               {
+                  IrInstr &store = add(IrStore, "save starting value in index variable");
+
+                  store.var = index;
+                  store.a = v.childValue;
+                  return rangeNode->child[1];
+               }
+
+            case 2:
+               {
+                  IrInstr &store = add(IrStore, "save stop value");
+
+                  store.var = IrVar{Local, index.offset - 1, NULL};
+                  store.a = v.childValue;
+               }
+
+               if (rangeNode->child[2] != NULL) {
+                  return rangeNode->child[2];
+               }
+               {
+                  IrInstr &one = add(IrConst, "default increment by 1");
+
+                  one.dst = v.childValue = newValue();
+                  one.imm = 1;
+                  one.type = Integer;
+               }
+               return NULL;
+
+            case 3:
+               {
+                  IrInstr &store = add(IrStore, "save step value");
+
+                  store.var = IrVar{Local, index.offset - 2, NULL};
+                  store.a = v.childValue;
+               }
+
+               // return here to do the test
+               v.top = newBlock();
+               v.body = newBlock();
+               v.exit = newBlock();
+               v.end = newBlock();
+               startBlock(v.top);
+               {
+                  IrInstr &test = add(IrForTest);
+
+                  test.dst = newValue();
+                  test.var = index;
+                  jump(IrBranchNZ, test.dst, v.body, "Jump to loop body");
+               }
+
+               startBlock(v.exit);
+               jump(IrJump, IR_NONE, v.end, "Jump past loop [backpatch]");
+               v.savedBreak = breakBlock;
+               breakBlock = v.exit;
+
+               if (current->child[2] == NULL) {
+                  diagnose(InternalError, current->lineno, {"codegen: for loop has no body"});
+                  break;
+               }
+
+               startBlock(v.body);
+               list = true;
+               return current->child[2];
+
+            case 4:
+               comment("Bottom of loop increment and jump");
+               add(IrForStep).var = index;
+
+               jump(IrJump, IR_NONE, v.top, "go to beginning of loop");
+               startBlock(v.end);
+
+               breakBlock = v.savedBreak;
+
+               comment("END LOOP");
+               break;
+         }
+         break;
+
+      case CompoundK:
+         switch (v.step++) {
+            case 0:
+               v.savedToffset = toffset;
+               toffset = current->size;
+               comment("COMPOUND");
+               add(IrTempTop, "TOFF set:").imm = toffset;
+               list = true;
+               return current->child[0]; // process inits
+
+            case 1:
+               comment("Compound Body");
+               list = true;
+               return current->child[1];
+         }
+
+         toffset = v.savedToffset;
+         add(IrTempTop, "TOFF set:").imm = toffset;
+         comment("END COMPOUND");
+         break;
+
+      case ReturnK:
+         if (v.step++ == 0) {
+            comment("RETURN");
+            return current->child[0];
+         }
+
+         if (current->child[0] != NULL) {
+            add(IrSetRet, "Copy result to return register").a = v.childValue;
+         }
+         add(IrRet);
+         break;
+
+      case BreakK:
+         comment("BREAK");
+         if (breakBlock < 0) {
+            add(IrRestart, "break");
+            break;
+         }
+         jump(IrJump, IR_NONE, breakBlock, "break");
+
+         break;
+
+      case RangeK:
+         // do nothing
+         break;
+
+      default:
+         break;
+
+   }
+
+   v.done = true;
+
+   return NULL;
+}
+
+/*
+ * @brief Build the next step of an expression
+ *
+ * @param v - visit of the expression
+ *
+ * @return child to build before the next step, NULL for none, never
+ * a list of statements
+ */
+TreeNode *IrGen::stepExpression(GenVisit &v, bool &) {
+   TreeNode *current = v.node;
+
+   if (v.step == 0) {
+      commentLineNum(current);
+   }
+
+   switch (current->kind.exp) {
+      case AssignK:
+         {
+            TreeNode *lhs = current->child[0], *rhs = current->child[1];
+
+            if (lhs->attr.op == '[') {
+               TreeNode *var = lhs->child[0], *index = lhs->child[1];
+
+               switch (v.step++) {
+                  case 0:
+                     lhs->isArray = true;
+
+                     if (var == NULL) {
+                        diagnose(InternalError, current->lineno, {"codegen: assignment has no array"});
+                        break;
+                     }
+                     if (index == NULL) {
+                        diagnose(InternalError, current->lineno, {"codegen: assignment has no index"});
+                        break;
+                     }
+
+                     return index;
+
+                  case 1:
+                     v.left = v.childValue;
+                     if (rhs != NULL) {
+                        return rhs;
+                     }
+                     v.childValue = IR_NONE;
+                     // fall through
+
+                  case 2:
+                     {
+                        IrInstr &update = add(IrUpdateElem);
+
+                        update.dst = v.value = newValue();
+                        update.var = varOf(var);
+                        update.oper = current->attr.op;
+                        update.a = v.left;
+                        update.b = v.childValue;
+                     }
+                     break;
+               }
+            } else {
+               if (v.step++ == 0) {
+                  v.childValue = IR_NONE;
+                  return rhs;
+               }
+
+               if (current->attr.op == '=') {
+                  IrInstr &store = add(IrStore, "Store variable", lhs->attr.name);
+
+                  store.var = varOf(lhs);
+                  store.a = v.value = v.childValue;
+               } else {
+                  IrInstr &update = add(IrUpdate);
+
+                  update.dst = v.value = newValue();
+                  update.var = varOf(lhs);
+                  update.oper = current->attr.op;
+                  update.a = v.childValue;
+               }
+            }
+            break;
+         }
+
+      case CallK:
+         // the parameters are passed one by one into the frame of the call
+         if (v.step++ == 0) {
+            add(IrCallBegin).func = current->decl;
+
+            v.param = current->child[0];
+            v.paramNum = 1;
+         } else {
+            IrInstr &arg = add(IrArg);
+
+            arg.func = current->decl;
+            arg.a = v.childValue;
+            arg.imm = v.paramNum;
+            v.paramNum++;
+            v.param = v.param->sibling;
+         }
+
+         if (v.param != NULL) {
+            char paramsStr[12];
+
+            snprintf(paramsStr, sizeof paramsStr, "%d", v.paramNum);
+            comment("Param", ctx->arena.copyString(paramsStr));
+            return v.param;
+         }
+
+         {
+            IrInstr &call = add(IrCall);
+
+            call.dst = v.value = newValue();
+            call.func = current->decl;
+         }
+
+         break;
+
+      case ConstantK:
+         if (current->type == Char && current->isArray) {
+            IrInstr &string = add(IrString, "Load address of char array");
+
+            string.dst = v.value = newValue();
+            string.var = IrVar{Global, current->offset, NULL};
+            string.string = current->attr.string;
+         } else if (current->type == Char || current->type == Boolean || current->type == Integer) {
+            IrInstr &constant = add(IrConst);
+
+            constant.dst = v.value = newValue();
+            constant.type = current->type;
+            if (current->type == Char) {
+               constant.imm = int(current->attr.cvalue);
+               constant.c = "Load char constant";
+            } else {
+               constant.imm = current->attr.value;
+               constant.c = (current->type == Boolean) ? "Load Boolean constant" : "Load integer constant";
+            }
+         } else {
+            diagnose(InternalError, current->lineno, {"codegen: constant has no type"});
+         }
+
+         break;
+
+      case IdK:
+         {
+            IrInstr &load = add(current->isArray ? IrAddr : IrLoad);
+
+            load.dst = v.value = newValue();
+            load.var = varOf(current);
+            load.c = current->isArray ? "Load address of base of array" : "Load variable";
+            load.cc = current->attr.name;
+         }
+         break;
+
+      case OpK:
+         switch (v.step++) {
+            case 0:
+               return current->child[0];
+
+            case 1:
+               v.left = v.childValue;
+               if (current->child[1]) {
+                  return current->child[1];
+               }
+
+               {
+                  IrInstr &unary = add(IrUnary);
+
+                  unary.dst = v.value = newValue();
+                  unary.oper = current->attr.op;
+                  unary.a = v.left;
+               }
+               break;
+
+            case 2:
+               {
+                  // indexing an array is the only binary operator on arrays
+                  IrInstr &binary = add(current->isArray ? IrElem : IrBinary);
+
+                  binary.dst = v.value = newValue();
+                  binary.oper = current->attr.op;
+                  binary.a = v.left;
+                  binary.b = v.childValue;
+               }
+               break;
+         }
+         break;
+   }
+
+   v.done = true;
+
+   return NULL;
+}
+
+/*
+ * @brief Build the next step of a declaration
+ *
+ * @param v - visit of the declaration
+ * @param list - set when the child returned is a list of statements
+ *
+ * @return child to build before the next step, NULL for none
+ */
+TreeNode *IrGen::stepDecl(GenVisit &v, bool &list) {
+   TreeNode *current = v.node;
+
+   if (v.step == 0) {
+      commentLineNum(current);
+   }
+
+   switch (current->kind.decl) {
+      case VarK:
+         if (v.step++ == 0) {
+            v.childValue = IR_NONE;
+            if (current->isArray) {
+               if (current->varKind == Local) {
+                  int size = arraySize(current);
+                  IrInstr &store = add(IrStore, "save size of array", current->attr.name);
+
+                  store.var = IrVar{Local, current->offset + 1, current->attr.name};
+                  store.a = size;
+               }
+
+               // ARRAY VALUE initializatin
+               return current->child[0];
+            }
+
+            // SCALAR VALUE initialization, compute rhs
+            if (current->varKind == Local) {
+               return current->child[0];
+            }
+            break;
+         }
+
+         if (current->child[0]) {
+            if (current->isArray) {
+               IrInstr &copy = add(IrArrayCopy);
+
+               copy.var = varOf(current);
+               copy.a = v.childValue;
+            } else {
+               IrInstr &store = add(IrStore, "Store variable", current->attr.name);
+
+               store.var = varOf(current);
+               store.a = v.childValue;
+            }
+         }
+         break;
+
+      case FuncK:
+         return stepFun(v, list);
+
+      case ParamK:
+         // IMPORTANT: no instructions need to be made
+         // for parameters
+         break;
+   }
+
+   v.done = true;
+
+   return NULL;
+}
+
+/*
+ * @brief start building a node
+ *
+ * @param stack - visits in progress
+ * @param node - node to build
+ * @param list - node starts a list of statements rather than being one expression
+ *
+ * @return void
+ */
+void IrGen::pushVisit(std::vector<GenVisit> &stack, TreeNode *node, bool list) {
+   GenVisit v = GenVisit();
+
+   v.node = node;
+   v.list = list;
+   v.value = IR_NONE;
+   v.childValue = IR_NONE;
+   v.left = IR_NONE;
+   stack.push_back(v);
+}
+
+/*
+ * @brief build a node on an explicit stack. A list of statements goes
+ * on to the siblings of the node, the next sibling replacing the one
+ * before on the stack, so the stack only grows with the nesting of the
+ * tree. The value of a node is handed to the node below it when it is
+ * done.
+ *
+ * @param start - node to build
+ * @param list - start is a list of statements rather than one expression
+ *
+ * @return value of start, IR_NONE if it has none
+ */
+int IrGen::runVisits(TreeNode *start, bool list) {
+   std::vector<GenVisit> stack;
+   int value = IR_NONE;
+
+   pushVisit(stack, start, list);
+   while (!stack.empty()) {
+      GenVisit &v = stack.back();
+      TreeNode *child = NULL;
+      bool childList = false;
+
+      if (v.done) {
+         TreeNode *sibling = v.list ? v.node->sibling : NULL;
+
+         value = v.value;
+         stack.pop_back();
+         if (!stack.empty()) {
+            stack.back().childValue = value;
+         }
+         if (sibling != NULL) {
+            pushVisit(stack, sibling, true);
+         }
+         continue;
+      }
+
+      switch (v.node->nodekind) {
+         case StmtK:
+            child = stepStatement(v, childList);
+            break;
+         case ExpK:
+            if (v.list && v.step == 0) {
+               comment("EXPRESSION");
+            }
+            child = stepExpression(v, childList);
+            break;
+         case DeclK:
+            child = stepDecl(v, childList);
+            break;
+         default:
+            v.done = true;
+            break;
+      }
+
+      if (child != NULL) {
+         pushVisit(stack, child, childList);
+      }
+   }
+
+   return value;
+}
+
+// declarations found in the global symbol table, applyToAllGlobal
+// takes no argument to hand them back in
+static thread_local std::vector<TreeNode *> *globalDecls;
+
+static void collectGlobal(std::string, void *ptr) {
+   globalDecls->push_back((TreeNode *)ptr);
+}
+
+/*
+ * @brief Build the init code: set up the first frame, initialize the
+ * global array sizes and the globals and statics with initializers,
+ * then call main
+ *
+ * @param globalOffset - size of the global space
+ *
+ * @return void
+ */
+void IrGen::initCode(int globalOffset) {
+   std::vector<TreeNode *> decls;
+
+   beginFunction(IrInitCode, NULL, NULL);
+   comment("INIT");
+   add(IrInit).imm = globalOffset;
+
+   // temporaries of the initializers go where the last function left them
+   add(IrTempTop).imm = toffset;
+
+   comment("INIT GLOBALS AND STATICS");
+   globalDecls = &decls;
+   ctx->globals->applyToAllGlobal(collectGlobal);
+   globalDecls = NULL;
+
+   for (TreeNode *current : decls) {
+      if (current->lineno == -1) {
+         continue;
+      }
+      if (current->isArray) {
+         int size = arraySize(current);
+         IrInstr &store = add(IrStore, "save size of array", current->attr.name);
+
+         store.var = IrVar{(current->varKind == LocalStatic) ? LocalStatic : Global, current->offset + 1,
+            current->attr.name};
+         store.a = size;
+      }
+      if (current->kind.decl == VarK && (current->varKind == Global || current->varKind == LocalStatic)) {
+         if (current->child[0]) {
+            int value = runVisits(current->child[0], false);
+            IrInstr &store = add(IrStore, "Store variable", current->attr.name);
+
+            store.var = varOf(current);
+            store.a = value;
+         }
+      }
+   }
+   comment("END INIT GLOBALS AND STATICS");
+
+   // without main the start is left for codegen to report
+   add(IrStart).func = ctx->mainFunc;
+
+   add(IrHalt, "DONE!");
+   comment("END INIT");
+   endFunction();
+}
+
+/*
+ * @brief top level IR builder call. Each function declaration becomes
+ * a function, the library functions included, and the code made for a
+ * global array initializer is kept where it was made.
+ *
+ * @param syntaxTree - annotated tree
+ * @param globals - global symbol table
+ * @param globalOffset - size of the global space
+ * @param linenumFlag - comment with line numbers
+ * @param program - filled in
+ *
+ * @return void
+ */
+void irgen(TreeNode *syntaxTree, SymbolTable *globals, int globalOffset, bool linenumFlag,
+      IrProgram &program) {
+   IrGen gen(program);
+
+   ctx->globals = globals;
+   ctx->linenumFlag = linenumFlag;
+
+   startPhase("irgen");
+
+   program.functions.clear();
+   program.globalOffset = globalOffset;
+
+   for (TreeNode *current = syntaxTree; current != NULL; current = current->sibling) {
+      if (current->nodekind == DeclK && current->kind.decl == FuncK) {
+         if (current->lineno == -1) {
+            gen.beginFunction(IrLibrary, current, current->attr.name);
+            gen.libraryFun(current);
+         } else {
+            gen.beginFunction(IrUser, current, current->attr.name);
+            gen.runVisits(current, false);
+         }
+      } else {
+         gen.beginFunction(IrDecl, current, current->attr.name);
+         gen.runVisits(current, false);
+      }
+      gen.endFunction();
+   }
+
+   gen.initCode(globalOffset);
+   program.built = true;
+   program.registers = false;
+}
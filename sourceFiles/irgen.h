@@ -0,0 +1,38 @@
+#ifndef _IRGEN_H_
+#define _IRGEN_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Builds the intermediate form of a program from its annotated
+ * tree. Each function of the program, each library function and the
+ * init code become an IR function, laid out in the order the code has
+ * always been generated in.
+ *
+ */
+
+#include "treeNodes.h"
+#include "symbolTable.h"
+#include "ir.h"
+
+// An IO library function, its body is the one instruction op
+struct IrIntrinsic {
+    const char *name;
+    bc::IrOp op;                    // IrIn, IrOut or IrOutNl
+    ExpType type;                   // of the input or output
+    const char *c;                  // comment of the instruction
+};
+
+/*
+ * @brief the instruction an IO library function is made of, NULL for
+ * any other function
+ */
+const IrIntrinsic *irIntrinsic(const TreeNode *decl);
+
+/*
+ * @brief top level IR builder call
+ */
+void irgen(TreeNode *syntaxTree, SymbolTable *globals, int globalOffset, bool linenumFlag,
+      bc::IrProgram &program);
+
+#endif
@@ -0,0 +1,194 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Library entry points that compile programs held in memory or
+ * in files and hand back the code bC would have printed and the
+ * diagnostics as records, so a caller that only wants the counts never
+ * pays for formatting the messages.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <thread>
+#include "libbc.h"
+#include "compilerContext.h"
+#include "passManager.h"
+#include "symbolTable.h"
+
+namespace bc {
+
+/*
+ * @brief open a stream that collects its output in memory
+ *
+ * @return the stream, the program exits if one cannot be made
+ */
+static FILE *openMemoryStream(char **text, size_t *textSize) {
+   FILE *stream = open_memstream(text, textSize);
+
+   if (stream == NULL) {
+      printf("ERROR(SYSTEM): could not open an output stream for the compile\n");
+      exit(1);
+   }
+
+   return stream;
+}
+
+/*
+ * @brief close a stream made by openMemoryStream and move its text into s
+ *
+ * @return void
+ */
+static void closeMemoryStream(FILE *stream, char *&text, size_t &textSize, std::string &s) {
+   fclose(stream);
+   s.assign(text, textSize);
+   free(text);
+}
+
+/*
+ * @brief compile a source in its own context
+ *
+ * @param src - source to compile, must stay alive until the compile ends
+ * @param options - how to compile it, fileName is shown in the header
+ * of the generated code
+ *
+ * @return counts, code and diagnostics of the compile
+ */
+static CompileResult compileSource(SourceBuffer *src, const CompileOptions &options) {
+   CompileResult result;
+   char *codeText = NULL, *treeText = NULL;
+   size_t codeSize = 0, treeSize = 0;
+   FILE *out = openMemoryStream(&codeText, &codeSize);
+   FILE *trees = openMemoryStream(&treeText, &treeSize);
+   CompilerContext *saved = ctx;
+
+   initTables();
+
+   {
+      CompilerContext context(out, trees);
+      SymbolTable symtab;
+
+      ctx = &context;
+      context.semanticThreads = options.semanticThreads;
+      context.optLevel = options.optLevel;
+      context.passList = options.passes.empty() ? NULL : options.passes.c_str();
+      context.printAfter = options.printAfter.empty() ? NULL : options.printAfter.c_str();
+      context.optReport = options.optReport;
+      if (options.inlineLimit >= 0) {
+         context.inlineLimit = options.inlineLimit;
+      }
+      context.holdMessages = true;
+      symtab.debug(false);
+
+      startPhase("parse");
+      parseSource(src);
+      runPasses((char *)options.fileName.c_str(), &symtab);
+
+      result.numErrors = context.numErrors + context.tokenErrors;
+      result.numWarnings = context.numWarnings;
+      result.diagnostics = std::move(context.messages);
+      result.remarks = std::move(context.optRemarks);
+
+      // symtab and then the context (and its arena) go away here
+   }
+
+   ctx = saved;
+   closeMemoryStream(out, codeText, codeSize, result.code);
+   closeMemoryStream(trees, treeText, treeSize, result.trees);
+
+   return result;
+}
+
+/*
+ * @brief compile a bC program in its own context
+ *
+ * @param source - text of the program
+ * @param options - how to compile it
+ *
+ * @return counts, code and diagnostics of the compile
+ */
+CompileResult compile(const std::string &source, const CompileOptions &options) {
+   CompileResult result;
+   SourceBuffer src;
+
+   copySource(source.data(), source.size(), &src);
+   result = compileSource(&src, options);
+   closeSource(&src);
+
+   return result;
+}
+
+/*
+ * @brief compile the bC program in a file in its own context
+ *
+ * @param path - file to compile, also the name shown in the code header
+ * @param options - how to compile it
+ *
+ * @return counts, code and diagnostics of the compile
+ */
+CompileResult compileFile(const std::string &path, const CompileOptions &options) {
+   CompileResult result;
+   CompileOptions fileOptions = options;
+   SourceBuffer src;
+
+   if (!openSource(path.c_str(), &src)) {
+      result.numErrors = 1;
+      result.numWarnings = 0;
+      result.diagnostics.add(SourceNotOpened, 0, {path.c_str()});
+      return result;
+   }
+   fileOptions.fileName = path;
+   result = compileSource(&src, fileOptions);
+   closeSource(&src);
+
+   return result;
+}
+
+/*
+ * @brief compile many files at once. Each worker takes the next file
+ * not yet started so a few large files do not hold up the rest.
+ *
+ * @param paths - files to compile
+ * @param numThreads - workers to run, 0 for one per core
+ * @param done - called with the index and result of each file
+ * @param options - how to compile every file
+ *
+ * @return void
+ */
+void compileFiles(const std::vector<std::string> &paths, int numThreads, const CompileDone &done,
+                  const CompileOptions &options) {
+   std::atomic<size_t> next(0);
+   std::vector<std::thread> workers;
+
+   if (numThreads <= 0) {
+      numThreads = (int)std::thread::hardware_concurrency();
+   }
+   if (numThreads <= 0) {
+      numThreads = 1;
+   }
+   if ((size_t)numThreads > paths.size()) {
+      numThreads = (int)paths.size();
+   }
+
+   initTables();
+
+   auto work = [&]() {
+      size_t index;
+
+      while ((index = next.fetch_add(1)) < paths.size()) {
+         CompileResult result = compileFile(paths[index], options);
+         done(index, result);
+      }
+   };
+
+   for (int i = 1; i < numThreads; i++) {
+      workers.emplace_back(work);
+   }
+   work();   // this thread works too
+   for (std::thread &worker : workers) {
+      worker.join();
+   }
+}
+
+}
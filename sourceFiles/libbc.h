@@ -0,0 +1,56 @@
+#ifndef _LIBBC_H_
+#define _LIBBC_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Library interface to the bC compiler (libbc.a). Every call to
+ * compile() gets its own compiler context so calls can be made from
+ * many threads at once.
+ *
+ */
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "diagnostics.h"
+
+namespace bc {
+
+struct CompileOptions {
+    std::string fileName;                  // name shown in the header of the generated code
+    int semanticThreads = 1;               // threads to check function bodies on, 0 one per core, 1 in order
+    int optLevel = 0;                      // -O level choosing the passes run
+    std::string passes;                    // comma separated passes to run instead of optLevel's, empty for none
+    std::string printAfter;                // pass to print the tree after into trees, empty for none
+    bool optReport = false;                // keep what the optimization passes did in remarks
+    int inlineLimit = -1;                  // instructions of a function always inlined, -1 for the default
+};
+
+struct CompileResult {
+    int numErrors;                         // errors found, code is only complete when 0
+    int numWarnings;                       // warnings found
+    std::string code;                      // TM code
+    Diagnostics diagnostics;               // errors and warnings, formatted only when asked (text())
+    std::string trees;                     // trees printed by printAfter
+    std::vector<std::string> remarks;      // optimization report, a line each, if optReport
+};
+
+// Called on a worker thread as each file of compileFiles() finishes
+typedef std::function<void (size_t index, CompileResult &result)> CompileDone;
+
+// Compile the bC program in source
+CompileResult compile(const std::string &source, const CompileOptions &options = CompileOptions());
+
+// Compile the bC program in the file at path, its name is shown in the
+// header of the generated code instead of options.fileName
+CompileResult compileFile(const std::string &path, const CompileOptions &options = CompileOptions());
+
+// Compile every file in paths on numThreads threads (0 for one per
+// core), done is called once for each file in whatever order they finish
+void compileFiles(const std::vector<std::string> &paths, int numThreads, const CompileDone &done,
+                  const CompileOptions &options = CompileOptions());
+
+}
+
+#endif
@@ -0,0 +1,807 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Loop invariant code motion. The loops are the natural loops
+ * of the flow graph: a jump to a block that dominates the block the
+ * jump is in goes back round a loop, which is that header and every
+ * block that reaches the jump without going through the header. Every
+ * way into the loop goes through its header, so code put just before
+ * the header runs once each time the loop is entered. A break jumps
+ * back to a block laid out before the body too, but that block does
+ * not dominate the body, so it is no loop. An expression tree in a loop whose
+ * variables the loop never writes gives the same value on every trip,
+ * so it is computed once in a preheader block laid out just before
+ * the loop and saved in a frame slot of its own, and the loop loads
+ * the slot instead. The slots are reserved below the deepest scope of
+ * the function by moving every temporary top down past them.
+ *
+ * Only trees of at least two instructions that load a variable are
+ * moved. A single instruction is no dearer than the load that would
+ * replace it, and a tree of constants alone, such as not true, is a
+ * few register instructions that cost less than the load from the
+ * frame, which peephole can not remove when the loop jumps to it.
+ * Division and modulus
+ * are left in the loop as the preheader also runs when the loop body
+ * does not, and a call in the loop may write any global.
+ *
+ * The loops nest as a tree, numbered in a depth first walk of it, so
+ * the loops inside a loop are the ones numbered from it to its last.
+ * Dominance is tested the same way on the dominator tree. Each block
+ * is looked at once, in its innermost loop: a tree goes to the
+ * preheader of the outermost loop it is invariant in, and a part of it
+ * invariant in loops further out still goes out of those on its own.
+ * The preheaders are laid out together once every block is done, so
+ * the work grows with the size of the function, not with the loops
+ * times the blocks.
+ *
+ */
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "licm.h"
+#include "compilerContext.h"
+#include "passManager.h"
+#include "scanType.h"
+#include "parser.tab.h"
+
+using namespace bc;
+
+// A natural loop
+struct Loop {
+   int header;                            // block every way into the loop goes through
+   int parent;                            // loop this one is directly inside, -1 for none
+   std::vector<int> blocks;               // blocks this is the innermost loop of
+   int first;                             // number of the loop in a walk of the loops
+   int last;                              // last number of a loop inside it
+   bool kept;                             // a preheader can go before it
+   IrBlock preheader;                     // invariants computed before it
+};
+
+// Moves the invariant trees out of the loops of one function
+class Hoister {
+private:
+   IrFunction &function;
+   int slotTop;                           // first slot reserved for invariants
+   int slots;                             // slots reserved
+   std::vector<Loop> loops;               // loops of the function, inner ones first
+   std::vector<int> innermost;            // innermost loop of each block, -1 for none
+   std::vector<std::vector<int>> written; // numbers of the loops writing each variable in the frame, by -offset
+   std::vector<std::vector<int>> writtenGlobal; // the same for globals
+   std::vector<int> calls;                // numbers of the loops making a call
+   std::vector<int> uses;                 // uses of each value in the function
+   std::vector<int> defAt;                // instruction of the block defining each value, -1 for none
+   std::vector<int> chain;                // loops round the block being done, outermost first
+   std::vector<int> keptOnChain;          // positions in chain of the loops that are kept
+   int hoisted;                           // instructions moved
+
+   std::vector<std::vector<int>> successors(std::vector<bool> &fallsThrough);
+   std::vector<int> dominators(const std::vector<std::vector<int>> &succ, std::vector<int> &order);
+   bool findLoops();
+   bool inLoop(int block, const Loop &loop);
+   void findWrites();
+   bool isWritten(const IrVar &var, const Loop &loop);
+   int level(const IrInstr &instr, int depth);
+   int outermostKept(int level);
+   void hoistBlock(int block, int depth);
+   void hoistLoops();
+   void insertPreheaders();
+   void moveTempTops();
+
+public:
+   Hoister(IrFunction &function);
+   int run();
+};
+
+Hoister::Hoister(IrFunction &function) : function(function), slotTop(0), slots(0), hoisted(0) {}
+
+/*
+ * @brief number the nodes of a forest in a depth first walk
+ *
+ * @param children - children of each node
+ * @param roots - the roots, in the order they are walked
+ * @param first - set to the number of each node, -1 for one not in the forest
+ * @param last - set to the last number of a node below each node
+ *
+ * @return void
+ */
+static void numberTree(const std::vector<std::vector<int>> &children, const std::vector<int> &roots,
+   std::vector<int> &first, std::vector<int> &last) {
+   std::vector<std::pair<int, size_t>> work;
+   int number = 0;
+
+   first.assign(children.size(), -1);
+   last.assign(children.size(), -1);
+   for (int root : roots) {
+      first[root] = number++;
+      work.push_back(std::make_pair(root, (size_t)0));
+      while (!work.empty()) {
+         int node = work.back().first;
+
+         if (work.back().second < children[node].size()) {
+            int child = children[node][work.back().second++];
+
+            first[child] = number++;
+            work.push_back(std::make_pair(child, (size_t)0));
+            continue;
+         }
+         last[node] = number - 1;
+         work.pop_back();
+      }
+   }
+}
+
+/*
+ * @brief the set a block is in, joining the path to it straight to the set
+ *
+ * @param leader - next block towards the set of each block, itself for the set
+ * @param block - the block
+ *
+ * @return the block naming the set
+ */
+static int findLeader(std::vector<int> &leader, int block) {
+   int set = block;
+
+   while (leader[set] != set) {
+      set = leader[set];
+   }
+   while (leader[block] != set) {
+      int next = leader[block];
+
+      leader[block] = set;
+      block = next;
+   }
+
+   return set;
+}
+
+/*
+ * @brief the blocks each block of the function can go to next
+ *
+ * @param fallsThrough - set for the blocks that can run on into the next
+ *
+ * @return the successors of each block
+ */
+std::vector<std::vector<int>> Hoister::successors(std::vector<bool> &fallsThrough) {
+   std::vector<std::vector<int>> succ(function.blocks.size());
+
+   fallsThrough.assign(function.blocks.size(), false);
+   for (size_t b = 0; b < function.blocks.size(); b++) {
+      const IrInstr *last = NULL;
+
+      for (const IrInstr &instr : function.blocks[b].instrs) {
+         if (instr.op != IrComment && instr.op != IrCommentInt) {
+            last = &instr;
+         }
+         if (irIsTerminator(instr.op) && instr.target >= 0) {
+            succ[b].push_back(instr.target);
+         }
+      }
+      // a block that does not end in a jump or return falls through
+      if (last == NULL || last->op == IrBranchZ || last->op == IrBranchNZ || !irIsTerminator(last->op)) {
+         if (b + 1 < function.blocks.size()) {
+            succ[b].push_back((int)b + 1);
+            fallsThrough[b] = true;
+         }
+      }
+   }
+
+   return succ;
+}
+
+/*
+ * @brief the immediate dominator of each block, by the algorithm of
+ * Cooper, Harvey and Kennedy over the blocks in reverse postorder
+ *
+ * @param succ - successors of each block
+ * @param order - set to the blocks that can be reached in reverse postorder
+ *
+ * @return the immediate dominator of each block, -1 for a block that
+ * can not be reached, the entry is its own
+ */
+std::vector<int> Hoister::dominators(const std::vector<std::vector<int>> &succ, std::vector<int> &order) {
+   int count = (int)succ.size();
+   std::vector<std::vector<int>> pred(count);
+   std::vector<int> number(count, -1), idom(count, -1);
+   std::vector<bool> seen(count, false);
+   std::vector<std::pair<int, size_t>> work;
+   bool changed = true;
+
+   order.clear();
+   if (count == 0) {
+      return idom;
+   }
+
+   // postorder by a depth first walk from the entry
+   seen[0] = true;
+   work.push_back(std::make_pair(0, (size_t)0));
+   while (!work.empty()) {
+      int b = work.back().first;
+
+      if (work.back().second < succ[b].size()) {
+         int next = succ[b][work.back().second++];
+
+         if (!seen[next]) {
+            seen[next] = true;
+            work.push_back(std::make_pair(next, (size_t)0));
+         }
+         continue;
+      }
+      work.pop_back();
+      order.push_back(b);
+   }
+   std::reverse(order.begin(), order.end());
+   for (size_t k = 0; k < order.size(); k++) {
+      number[order[k]] = (int)k;
+   }
+   for (int b = 0; b < count; b++) {
+      for (int next : succ[b]) {
+         if (seen[b]) {
+            pred[next].push_back(b);
+         }
+      }
+   }
+
+   idom[0] = 0;
+   while (changed) {
+      changed = false;
+      for (size_t k = 1; k < order.size(); k++) {
+         int b = order[k], dom = -1;
+
+         for (int p : pred[b]) {
+            int x = p;
+
+            if (idom[p] < 0) {
+               continue;
+            }
+            // the nearest block dominating both
+            for (int y = dom; y >= 0 && x != y; ) {
+               while (number[x] > number[y]) {
+                  x = idom[x];
+               }
+               while (number[y] > number[x]) {
+                  y = idom[y];
+               }
+            }
+            dom = x;
+         }
+         if (dom != idom[b]) {
+            idom[b] = dom;
+            changed = true;
+         }
+      }
+   }
+
+   return idom;
+}
+
+/*
+ * @brief find the natural loops of the function and the loop each block
+ * is innermost in. The headers are taken in reverse of reverse
+ * postorder, so the loops inside a loop are found before it, and each
+ * loop found becomes one set whose leader is its header: a later loop
+ * walking back over it meets only the header.
+ *
+ * @return true if a preheader can go before one of the loops
+ */
+bool Hoister::findLoops() {
+   std::vector<bool> fallsThrough;
+   std::vector<std::vector<int>> succ = successors(fallsThrough);
+   std::vector<int> order;
+   std::vector<int> idom = dominators(succ, order);
+   int count = (int)succ.size();
+   std::vector<std::vector<int>> pred(count), domChildren(count), backFrom(count), inner;
+   std::vector<int> domFirst, domLast, loopOf(count, -1), leader(count), work, roots, first, last;
+   bool anyKept = false;
+
+   if (count == 0) {
+      return false;
+   }
+
+   for (int b = 0; b < count; b++) {
+      leader[b] = b;
+      if (idom[b] < 0) {
+         continue;
+      }
+      if (b != 0) {
+         domChildren[idom[b]].push_back(b);
+      }
+      for (int next : succ[b]) {
+         pred[next].push_back(b);
+      }
+   }
+   numberTree(domChildren, std::vector<int>(1, 0), domFirst, domLast);
+
+   // a jump to a block dominating this one goes back round a loop
+   for (int b = 0; b < count; b++) {
+      for (int header : succ[b]) {
+         if (idom[b] >= 0 && domFirst[header] <= domFirst[b] && domFirst[b] <= domLast[header]) {
+            backFrom[header].push_back(b);
+         }
+      }
+   }
+
+   innermost.assign(count, -1);
+   for (size_t k = order.size(); k-- > 0; ) {
+      int header = order[k], loop = (int)loops.size();
+
+      if (backFrom[header].empty()) {
+         continue;
+      }
+      loops.push_back(Loop());
+      loops.back().header = header;
+      loops.back().parent = -1;
+      loopOf[header] = loop;
+      innermost[header] = loop;
+
+      // the blocks reaching the jumps without going through the header
+      work = backFrom[header];
+      while (!work.empty()) {
+         int x = findLeader(leader, work.back());
+
+         work.pop_back();
+         if (x == header) {
+            continue;
+         }
+         if (loopOf[x] >= 0) {
+            loops[loopOf[x]].parent = loop;
+         } else {
+            innermost[x] = loop;
+         }
+         leader[x] = header;
+         for (int p : pred[x]) {
+            work.push_back(p);
+         }
+      }
+   }
+
+   if (loops.empty()) {
+      return false;
+   }
+
+   inner.resize(loops.size());
+   for (size_t l = 0; l < loops.size(); l++) {
+      if (loops[l].parent >= 0) {
+         inner[loops[l].parent].push_back((int)l);
+      } else {
+         roots.push_back((int)l);
+      }
+   }
+   numberTree(inner, roots, first, last);
+   for (size_t l = 0; l < loops.size(); l++) {
+      loops[l].first = first[l];
+      loops[l].last = last[l];
+   }
+   for (int b = 0; b < count; b++) {
+      if (innermost[b] >= 0) {
+         loops[innermost[b]].blocks.push_back(b);
+      }
+   }
+
+   // the preheader goes just before the header, so the block laid out
+   // there must not be in the loop and run on into the header, and the
+   // function starts in block 0
+   for (Loop &loop : loops) {
+      int before = loop.header - 1;
+
+      loop.kept = !(loop.header == 0 || (inLoop(before, loop) && fallsThrough[before]));
+      anyKept = anyKept || loop.kept;
+   }
+
+   return anyKept;
+}
+
+/*
+ * @brief is a block in a loop or in a loop inside it
+ */
+bool Hoister::inLoop(int block, const Loop &loop) {
+   int number = innermost[block] < 0 ? -1 : loops[innermost[block]].first;
+
+   return number >= loop.first && number <= loop.last;
+}
+
+/*
+ * @brief note the loops that write each variable and the loops that
+ * call, by the number of the innermost loop the instruction is in
+ *
+ * @return void
+ */
+void Hoister::findWrites() {
+   for (size_t b = 0; b < function.blocks.size(); b++) {
+      if (innermost[b] < 0) {
+         continue;
+      }
+
+      int number = loops[innermost[b]].first;
+
+      for (const IrInstr &instr : function.blocks[b].instrs) {
+         bool global = (instr.var.kind == Global || instr.var.kind == LocalStatic);
+         std::vector<std::vector<int>> &vars = global ? writtenGlobal : written;
+         int slot = -instr.var.offset;
+
+         switch (instr.op) {
+            case IrStore:
+            case IrUpdate:
+            case IrUpdateElem:
+            case IrArrayCopy:
+            case IrForStep:
+            case IrForNext:
+               break;
+
+            case IrCallBegin:
+            case IrCall:
+               calls.push_back(number);
+               continue;
+
+            default:
+               continue;
+         }
+
+         if (slot < 0) {
+            continue;
+         }
+         if (slot >= (int)vars.size()) {
+            vars.resize(slot + 1);
+         }
+         vars[slot].push_back(number);
+      }
+   }
+
+   std::sort(calls.begin(), calls.end());
+   for (std::vector<int> &loopsWriting : written) {
+      std::sort(loopsWriting.begin(), loopsWriting.end());
+   }
+   for (std::vector<int> &loopsWriting : writtenGlobal) {
+      std::sort(loopsWriting.begin(), loopsWriting.end());
+   }
+}
+
+/*
+ * @brief is one of a sorted list of loop numbers a loop inside a loop
+ */
+static bool anyInside(const std::vector<int> &numbers, const Loop &loop) {
+   std::vector<int>::const_iterator at = std::lower_bound(numbers.begin(), numbers.end(), loop.first);
+
+   return at != numbers.end() && *at <= loop.last;
+}
+
+/*
+ * @brief can a loop change a variable
+ */
+bool Hoister::isWritten(const IrVar &var, const Loop &loop) {
+   bool global = (var.kind == Global || var.kind == LocalStatic);
+   const std::vector<std::vector<int>> &vars = global ? writtenGlobal : written;
+   int slot = -var.offset;
+
+   // variables grow down from FP and GP
+   if (slot < 0 || (global && anyInside(calls, loop))) {
+      return true;
+   }
+
+   return slot < (int)vars.size() && anyInside(vars[slot], loop);
+}
+
+/*
+ * @brief the outermost loop round the block an instruction gives the
+ * same value on every trip of when its operands do
+ *
+ * @param instr - the instruction
+ * @param depth - how many loops the block is in
+ *
+ * @return the position of the loop in chain, depth for none
+ */
+int Hoister::level(const IrInstr &instr, int depth) {
+   int low = 0, high = depth;
+
+   switch (instr.op) {
+      case IrConst:
+      case IrString:
+      case IrAddr:
+         return 0;
+
+      case IrLoad:
+         // a loop writing the variable is inside every loop that does
+         while (low < high) {
+            int mid = (low + high) / 2;
+
+            if (isWritten(instr.var, loops[chain[mid]])) {
+               low = mid + 1;
+            } else {
+               high = mid;
+            }
+         }
+         return low;
+
+      case IrUnary:
+         return instr.oper != '?' ? 0 : depth;
+
+      case IrBinary:
+         return (instr.oper != '/' && instr.oper != '%') ? 0 : depth;
+
+      default:
+         return depth;
+   }
+}
+
+/*
+ * @brief the outermost kept loop of chain at a level or inside it
+ *
+ * @return its position in chain, -1 for none
+ */
+int Hoister::outermostKept(int level) {
+   std::vector<int>::iterator at = std::lower_bound(keptOnChain.begin(), keptOnChain.end(), level);
+
+   return at == keptOnChain.end() ? -1 : *at;
+}
+
+/*
+ * @brief move the invariant trees of a block into the preheaders of the
+ * loops round it
+ *
+ * @param block - the block
+ * @param depth - how many loops it is in, the loops are in chain
+ *
+ * @return void
+ */
+void Hoister::hoistBlock(int block, int depth) {
+   std::vector<IrInstr> &instrs = function.blocks[block].instrs;
+   int size = (int)instrs.size(), operands[2], count;
+   std::vector<int> first(size, -1), target(size, -1), length(size, 0), open;
+   std::vector<bool> loads(size, false), inTree(size, false), moved(size, false);
+   std::vector<std::pair<int, int>> starts;
+   std::vector<IrInstr> body;
+   size_t next = 0;
+
+   // an invariant tree is a run of invariant instructions each used
+   // once by the next one needing it, as regalloc finds its trees. It
+   // can go out of the loops every instruction of it is invariant in.
+   for (int i = 0; i < size; i++) {
+      const IrInstr &instr = instrs[i];
+      int end = i - 1, to = outermostKept(level(instr, depth));
+
+      if (instr.dst >= 0) {
+         defAt[instr.dst] = i;
+      }
+      if (to < 0) {
+         continue;
+      }
+      count = irUses(instr, operands);
+      for (int j = count - 1; j >= 0 && end >= -1; j--) {
+         int at = defAt[operands[j]];
+
+         end = (at >= 0 && at == end && first[at] >= 0 && uses[operands[j]] == 1) ? first[at] - 1 : -2;
+      }
+      if (end < -1) {
+         continue;
+      }
+      first[i] = end + 1;
+      for (int j = 0; j < count; j++) {
+         to = std::max(to, target[defAt[operands[j]]]);
+      }
+      target[i] = to;
+      length[i] = 1;
+      loads[i] = (instr.op == IrLoad);
+
+      // an operand invariant in more loops goes out of them on its own,
+      // leaving a load of its slot in the tree
+      for (int j = 0; j < count; j++) {
+         int at = defAt[operands[j]];
+
+         inTree[at] = true;
+         moved[at] = target[at] < to && length[at] >= 2 && loads[at];
+         length[i] += moved[at] ? 1 : length[at];
+         loads[i] = loads[i] || moved[at] || loads[at];
+      }
+   }
+
+   for (int i = 0; i < size; i++) {
+      if (instrs[i].dst >= 0) {
+         defAt[instrs[i].dst] = -1;
+      }
+      if (first[i] >= 0 && !inTree[i] && length[i] >= 2 && loads[i]) {
+         moved[i] = true;
+      }
+      if (moved[i]) {
+         starts.push_back(std::make_pair(first[i], -i));
+      }
+   }
+   if (starts.empty()) {
+      return;
+   }
+
+   // the trees moved, the ones holding others first
+   std::sort(starts.begin(), starts.end());
+   auto into = [&]() -> std::vector<IrInstr> & {
+      return open.empty() ? body : loops[chain[target[open.back()]]].preheader.instrs;
+   };
+   for (int i = 0; i < size; i++) {
+      for (; next < starts.size() && starts[next].first == i; next++) {
+         open.push_back(-starts[next].second);
+      }
+      into().push_back(instrs[i]);
+      if (open.empty() || open.back() != i) {
+         continue;
+      }
+
+      // the tree goes to the preheader, its value to a slot
+      std::vector<IrInstr> &preheader = into();
+      int value = function.numValues++;
+      IrVar slot = IrVar{Local, slotTop - slots, "invariant"};
+      IrInstr store = irMake(IrStore), load = irMake(IrLoad);
+
+      preheader.back().dst = value;
+      uses.push_back(1);
+      store.var = load.var = slot;
+      store.a = value;
+      store.c = "Save loop invariant";
+      preheader.push_back(store);
+      open.pop_back();
+
+      load.dst = instrs[i].dst;
+      load.c = "Load loop invariant";
+      into().push_back(load);
+      hoisted += length[i];
+      slots++;
+   }
+   instrs.swap(body);
+}
+
+/*
+ * @brief hoist the trees of every block, walking the loops outer
+ * first so chain holds the loops round each
+ *
+ * @return void
+ */
+void Hoister::hoistLoops() {
+   std::vector<int> walk(loops.size());
+
+   for (size_t l = 0; l < loops.size(); l++) {
+      walk[loops[l].first] = (int)l;
+   }
+   for (int l : walk) {
+      const Loop &loop = loops[l];
+
+      // leave the loops this one is not inside
+      while (!chain.empty() && loops[chain.back()].last < loop.first) {
+         if (!keptOnChain.empty() && keptOnChain.back() == (int)chain.size() - 1) {
+            keptOnChain.pop_back();
+         }
+         chain.pop_back();
+      }
+      if (loop.kept) {
+         keptOnChain.push_back((int)chain.size());
+      }
+      chain.push_back(l);
+      for (int b : loop.blocks) {
+         hoistBlock(b, (int)chain.size());
+      }
+   }
+}
+
+/*
+ * @brief lay out each preheader just before its loop. It takes the place
+ * of the header for every jump from outside the loop, and the blocks
+ * move down one for each preheader before them.
+ *
+ * @return void
+ */
+void Hoister::insertPreheaders() {
+   int count = (int)function.blocks.size(), added = 0;
+   std::vector<int> preheaderOf(count, -1), shift(count);
+   std::vector<IrBlock> blocks;
+
+   for (size_t l = 0; l < loops.size(); l++) {
+      if (!loops[l].preheader.instrs.empty()) {
+         preheaderOf[loops[l].header] = (int)l;
+      }
+   }
+   for (int b = 0; b < count; b++) {
+      added += (preheaderOf[b] >= 0);
+      shift[b] = added;
+   }
+
+   for (int b = 0; b < count; b++) {
+      for (IrInstr &instr : function.blocks[b].instrs) {
+         int to = instr.target;
+
+         if (to >= 0) {
+            instr.target = to + shift[to] - (preheaderOf[to] >= 0 && !inLoop(b, loops[preheaderOf[to]]));
+         }
+      }
+   }
+
+   blocks.reserve(count + added);
+   for (int b = 0; b < count; b++) {
+      if (preheaderOf[b] >= 0) {
+         IrBlock &preheader = loops[preheaderOf[b]].preheader;
+
+         preheader.instrs.insert(preheader.instrs.begin(), irMake(IrComment));
+         preheader.instrs.front().c = "LOOP INVARIANTS";
+         blocks.push_back(std::move(preheader));
+      }
+      blocks.push_back(std::move(function.blocks[b]));
+   }
+   function.blocks.swap(blocks);
+}
+
+/*
+ * @brief start the temporaries past the slots of the invariants
+ */
+void Hoister::moveTempTops() {
+   for (IrBlock &block : function.blocks) {
+      for (IrInstr &instr : block.instrs) {
+         if (instr.op == IrTempTop) {
+            instr.imm = slotTop - slots;
+         }
+      }
+   }
+}
+
+/*
+ * @brief move the invariant trees out of every loop of the function
+ *
+ * @return instructions moved
+ */
+int Hoister::run() {
+   int operands[2], count;
+
+   if (!findLoops()) {
+      return 0;
+   }
+
+   // the slots go below the deepest scope
+   for (const IrBlock &block : function.blocks) {
+      for (const IrInstr &instr : block.instrs) {
+         if (instr.op == IrTempTop && instr.imm < slotTop) {
+            slotTop = (int)instr.imm;
+         }
+      }
+   }
+
+   uses.assign(function.numValues, 0);
+   for (const IrBlock &block : function.blocks) {
+      for (const IrInstr &instr : block.instrs) {
+         count = irUses(instr, operands);
+         for (int j = 0; j < count; j++) {
+            uses[operands[j]]++;
+         }
+      }
+   }
+   defAt.assign(function.numValues, -1);
+
+   findWrites();
+   hoistLoops();
+
+   if (slots > 0) {
+      insertPreheaders();
+      moveTempTops();
+   }
+
+   return hoisted;
+}
+
+/*
+ * @brief move the invariant expressions of every loop into a preheader
+ *
+ * @param program - IR to optimize
+ *
+ * @return void
+ */
+void hoistInvariants(IrProgram &program) {
+   int total = 0;
+
+   for (IrFunction &function : program.functions) {
+      if (function.kind != IrUser) {
+         continue;
+      }
+
+      int hoisted = Hoister(function).run();
+
+      if (hoisted > 0) {
+         optRemark("licm", "%s: %d instructions hoisted", function.name, hoisted);
+      }
+      total += hoisted;
+   }
+
+   optRemark("licm", "%d instructions hoisted", total);
+}
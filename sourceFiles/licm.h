@@ -0,0 +1,20 @@
+#ifndef _LICM_H_
+#define _LICM_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Moves the expressions of a loop that give the same value on
+ * every trip out of the loop.
+ *
+ */
+
+#include "ir.h"
+
+/*
+ * @brief compute the invariant expressions of every loop once, in a
+ * preheader before it, and have the loop load their values
+ */
+void hoistInvariants(bc::IrProgram &program);
+
+#endif
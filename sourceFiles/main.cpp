@@ -0,0 +1,466 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Driver for the bC compiler. Reads the sources named on the
+ * command line (or standard input) and compiles them in one compiler
+ * context, printing the code and the error counts to standard output.
+ * With -o every source is instead compiled on its own, on -j threads,
+ * into a .tm file in the output directory. Without -o, -j is the number
+ * of threads the function bodies are checked on. -O, --passes= and
+ * --print-after= choose the passes run after the parse (passManager.h).
+ * The errors and warnings are printed as text in front of the code
+ * unless --diagnostics= asks for JSON or SARIF, which go to standard
+ * error or to the file named by --diagnostics-file=. --opt-report prints
+ * what the optimization passes did to standard error. --inline-limit=
+ * sets how big a function the inliner always inlines.
+ *
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <errno.h>
+#include <getopt.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "compilerContext.h"
+#include "libbc.h"
+#include "passManager.h"
+#include "source.h"
+#include "scanType.h"
+#include "symbolTable.h"
+#include "treeNodes.h"
+#include "treeUtils.h"
+#include "parser.tab.h"
+
+using namespace std;
+
+#define MAX_THREADS 1024                   // most threads -j takes
+
+extern char *largerTokens[LASTTERM+1];
+
+void printToken(TokenData myData, string tokenName, int type = 0) {
+   cout << "Line: " << myData.linenum << " Type: " << tokenName;
+   if(type==0)
+     cout << " Token: " << myData.tokenstr;
+   if(type==1)
+     cout << " Token: " << myData.nvalue;
+   if(type==2)
+     cout << " Token: " << myData.cvalue;
+   cout << endl;
+}
+
+/*
+ * @brief run only the scanner over a source. Used to compare builds
+ * of the scanner and to time them.
+ *
+ * @param src - source to scan
+ * @param showTokens - print every token as it is scanned
+ *
+ * @return number of tokens scanned
+*/
+int scanOnly(SourceBuffer *src, bool showTokens) {
+   int tokenClass, count = 0;
+   void *scanner = scannerBegin(src);
+   YYSTYPE lval;
+
+   while ((tokenClass = yylex(&lval, scanner)) != 0) {
+      count++;
+      if (showTokens) {
+         string name;
+         int type = 0;
+
+         if (tokenClass < 256) name = string(1, (char)tokenClass);
+         else if (tokenClass <= LASTTERM && largerTokens[tokenClass] != NULL) name = largerTokens[tokenClass];
+         else name = to_string(tokenClass);
+
+         if (tokenClass == NUMCONST || tokenClass == BOOLCONST) type = 1;
+         else if (tokenClass == CHARCONST) type = 2;
+         bc::flushDiagnostics();   // token errors go in among the tokens
+         printToken(*lval.tinfo, name, type);
+      }
+   }
+   scannerEnd(scanner);
+
+   return count;
+}
+
+/*
+ * @brief name of the .tm file for a source in the output directory,
+ * the source name with its directory and extension replaced
+ *
+ * @param outDir - output directory
+ * @param path - source file
+ *
+ * @return path of the .tm file
+*/
+string tmPath(const char *outDir, const string &path) {
+   size_t slash = path.rfind('/');
+   string name = (slash == string::npos) ? path : path.substr(slash + 1);
+   size_t dot = name.rfind('.');
+
+   if (dot != string::npos && dot > 0) name = name.substr(0, dot);
+
+   return string(outDir) + "/" + name + ".tm";
+}
+
+/*
+ * @brief read a whole number given to an option, -O, -j or --inline-limit=
+ *
+ * @param text - the argument
+ * @param most - largest number the option takes
+ * @param number - set to the number when it is good
+ *
+ * @return is it a whole number from 0 to most
+*/
+bool parseNumber(const char *text, int most, int &number) {
+   char *end;
+   long value;
+
+   errno = 0;
+   value = strtol(text, &end, 10);
+   if (end == text || *end != '\0' || errno != 0 || value < 0 || value > most) {
+      return false;
+   }
+   number = (int)value;
+
+   return true;
+}
+
+/*
+ * @brief open the file named by --diagnostics-file=
+ *
+ * @param path - file to write, NULL for standard error
+ *
+ * @return the stream, NULL if the file cannot be made
+*/
+FILE *openDiagnostics(const char *path) {
+   return (path == NULL) ? stderr : fopen(path, "w");
+}
+
+/*
+ * @brief close a stream made by openDiagnostics
+ *
+ * @return void
+*/
+void closeDiagnostics(FILE *out) {
+   if (out != NULL && out != stderr) fclose(out);
+}
+
+/*
+ * @brief compile every file on its own on numThreads threads, writing
+ * the code of each file that compiles without errors to a .tm file in
+ * outDir. The diagnostics are printed in the order the files were given
+ * with the name of the file in front, or written as JSON or SARIF,
+ * followed by the total counts.
+ *
+ * @param files - sources to compile
+ * @param numFiles - number of sources
+ * @param numThreads - threads to compile on, 0 for one per core
+ * @param outDir - where the .tm files go, made if it does not exist
+ * @param options - passes to run on every file
+ * @param format - how the diagnostics are written
+ * @param diagPath - file they are written to, NULL for standard output
+ * as text and standard error otherwise
+ *
+ * @return void
+*/
+void compileBatch(char **files, int numFiles, int numThreads, const char *outDir,
+                  const bc::CompileOptions &options, bc::DiagFormat format, const char *diagPath) {
+   vector<string> paths(files, files + numFiles);
+   vector<bc::CompileResult> results(numFiles);
+   int numErrors = ctx->numErrors, numWarnings = 0;
+
+   bc::flushDiagnostics();   // problems with the options
+
+   // two sources of the same name in different directories would
+   // write the same .tm file
+   map<string, int> written;
+
+   for (int i = 0; i < numFiles; i++) {
+      auto found = written.emplace(tmPath(outDir, paths[i]), i);
+
+      if (!found.second) {
+         printf("ERROR(ARGLIST): \"%s\" and \"%s\" would both be compiled into \"%s\".\n",
+                files[found.first->second], files[i], found.first->first.c_str());
+         numErrors++;
+      }
+   }
+   if (numErrors > ctx->numErrors) {
+      printf("Number of warnings: 0\n");
+      printf("Number of errors: %d\n", numErrors);
+      return;
+   }
+
+   if (mkdir(outDir, 0777) != 0 && errno != EEXIST) {
+      printf("ERROR(ARGLIST): output directory \"%s\" could not be made.\n", outDir);
+      printf("Number of warnings: 0\n");
+      printf("Number of errors: 1\n");
+      return;
+   }
+
+   // runs on the workers, each result has its own slot so no locking
+   bc::compileFiles(paths, numThreads, [&](size_t index, bc::CompileResult &result) {
+      if (result.numErrors == 0) {
+         string path = tmPath(outDir, paths[index]);
+         FILE *tm = fopen(path.c_str(), "w");
+
+         if (tm == NULL || fwrite(result.code.data(), 1, result.code.size(), tm) != result.code.size()) {
+            result.diagnostics.add(bc::OutputNotWritten, 0, {path.c_str()});
+            result.numErrors++;
+         }
+         if (tm != NULL) fclose(tm);
+      }
+      result.code.clear();
+      result.code.shrink_to_fit();
+      results[index] = std::move(result);
+   }, options);
+
+   vector<const char *> names(files, files + numFiles);
+   vector<const bc::Diagnostics *> lists;
+
+   for (int i = 0; i < numFiles; i++) {
+      lists.push_back(&results[i].diagnostics);
+      numWarnings += results[i].numWarnings;
+      numErrors += results[i].numErrors;
+   }
+   if (format == bc::DiagText && diagPath == NULL) {
+      bc::writeDiagnostics(stdout, format, names, lists);
+   }
+   else {
+      FILE *out = openDiagnostics(diagPath);
+
+      if (out == NULL) {
+         printf("ERROR(ARGLIST): output file \"%s\" could not be written.\n", diagPath);
+         numErrors++;
+      }
+      else {
+         bc::writeDiagnostics(out, format, names, lists);
+         closeDiagnostics(out);
+      }
+   }
+
+   printf("Number of warnings: %d\n", numWarnings);
+   printf("Number of errors: %d\n", numErrors);
+
+   for (int i = 0; i < numFiles; i++) {
+      for (const string &remark : results[i].remarks) {
+         fprintf(stderr, "%s: %s\n", files[i], remark.c_str());
+      }
+   }
+}
+
+/*
+ * @brief driver code to run the compiler
+*/
+int main(int argc, char **argv) {
+   int option, index;
+   SourceBuffer *sources;
+   bc::CompilerContext context(stdout, stdout);
+   SymbolTable *symtab;
+   bool memReport = false;
+   bool scanOnlyFlag = false;
+   bool showTokens = false;
+   int numTokens = 0;
+   size_t numBytes = 0;
+   struct timespec scanStart, scanEnd;
+   int numThreads = 0;
+   bool threadsGiven = false;
+   char *outDir = NULL;
+   bool timeReport = false;
+   bool timeReportJson = false;
+   bc::CompileOptions options;
+   bc::DiagFormat diagFormat = bc::DiagText;
+   char *diagPath = NULL;
+   static struct option longOptions[] = {
+      {"time-report", optional_argument, NULL, 'R'},
+      {"passes", required_argument, NULL, 'P'},
+      {"print-after", required_argument, NULL, 'A'},
+      {"diagnostics", required_argument, NULL, 'D'},
+      {"diagnostics-file", required_argument, NULL, 'F'},
+      {"opt-report", no_argument, NULL, 'Q'},
+      {"inline-limit", required_argument, NULL, 'I'},
+      {NULL, 0, NULL, 0}
+   };
+
+   ctx = &context;
+   bc::initTables();
+
+   while ((option = getopt_long (argc, argv, "MLTj:o:O::", longOptions, NULL)) != -1)
+      switch (option)
+      {
+      case 'O':
+         // -O alone is -O1
+         if (optarg == NULL) {
+            options.optLevel = 1;
+         } else if (!parseNumber(optarg, MAX_OPT_LEVEL, options.optLevel)) {
+            bc::diagnose(bc::BadOptLevel, 0, {optarg, MAX_OPT_LEVEL});
+         }
+         break;
+      case 'P':
+         options.passes = optarg;     // run these passes instead of the -O pipeline
+         break;
+      case 'A':
+         options.printAfter = optarg; // print the tree after this pass
+         break;
+      case 'D':
+         // text as bC always printed it, json or sarif
+         if (!bc::parseDiagFormat(optarg, diagFormat)) {
+            bc::diagnose(bc::UnknownDiagnosticFormat, 0, {optarg});
+         }
+         break;
+      case 'F':
+         diagPath = optarg;   // write the diagnostics here instead
+         break;
+      case 'Q':
+         options.optReport = true;    // print what the optimization passes did to stderr
+         break;
+      case 'I':
+         // size of the functions always inlined
+         if (!parseNumber(optarg, MAX_INLINE_LIMIT, options.inlineLimit)) {
+            bc::diagnose(bc::BadInlineLimit, 0, {optarg, MAX_INLINE_LIMIT});
+         }
+         break;
+      case 'R':
+         // print time and memory per phase to stderr, as text or json
+         if (optarg != NULL && strcmp(optarg, "text") != 0 && strcmp(optarg, "json") != 0) {
+            bc::diagnose(bc::UnknownTimeReportFormat, 0, {optarg});
+            break;
+         }
+         timeReport = true;
+         timeReportJson = (optarg != NULL && strcmp(optarg, "json") == 0);
+         break;
+      case 'j':
+         // threads for -o or function bodies, 0 is one per core
+         if (!parseNumber(optarg, MAX_THREADS, numThreads)) {
+            bc::diagnose(bc::BadThreadCount, 0, {optarg, MAX_THREADS});
+            break;
+         }
+         threadsGiven = true;
+         break;
+      case 'o':
+         outDir = optarg;     // compile each file on its own into outDir
+         break;
+      case 'M':
+         memReport = true;    // print arena usage per phase to stderr
+         break;
+      case 'T':
+         showTokens = true;   // print the token stream
+         // fall through
+      case 'L':
+         scanOnlyFlag = true; // only run the scanner and report its speed
+         break;
+      default:
+         ;
+      }
+
+   if (outDir != NULL) {
+      compileBatch(argv + optind, argc - optind, numThreads, outDir, options, diagFormat, diagPath);
+      return 0;
+   }
+
+   symtab = new SymbolTable();
+   symtab->debug(false);
+   if (timeReport) {
+      context.timeReport.enable();
+   }
+   if (threadsGiven) {
+      context.semanticThreads = numThreads;
+   }
+   context.optLevel = options.optLevel;
+   context.passList = options.passes.empty() ? NULL : options.passes.c_str();
+   context.printAfter = options.printAfter.empty() ? NULL : options.printAfter.c_str();
+   context.optReport = options.optReport;
+   if (options.inlineLimit >= 0) {
+      context.inlineLimit = options.inlineLimit;
+   }
+   context.holdMessages = (diagFormat != bc::DiagText || diagPath != NULL);
+
+   // sources stay mapped until the end since tokens view into them
+   sources = new SourceBuffer[argc - optind + 1]();
+
+   bc::startPhase("parse");
+   clock_gettime(CLOCK_MONOTONIC, &scanStart);
+   if ( optind == argc ) {
+      if (!readSource(stdin, &sources[0])) {
+         bc::diagnose(bc::SourceNotRead, 0);
+      }
+      numBytes += sources[0].size;
+      if (scanOnlyFlag) numTokens += scanOnly(&sources[0], showTokens);
+      else bc::parseSource(&sources[0]);
+   }
+   for (index = optind; index < argc; index++)
+   {
+      SourceBuffer *src = &sources[index - optind];
+
+      if (!openSource(argv[index], src)) {
+         bc::diagnose(bc::SourceNotOpened, 0, {argv[index]});
+         src->base = NULL;
+         continue;
+      }
+      numBytes += src->size;
+      if (scanOnlyFlag) numTokens += scanOnly(src, showTokens);
+      else bc::parseSource(src);
+   }
+   clock_gettime(CLOCK_MONOTONIC, &scanEnd);
+
+   if (scanOnlyFlag) {
+      double seconds = (scanEnd.tv_sec - scanStart.tv_sec) + (scanEnd.tv_nsec - scanStart.tv_nsec) / 1e9;
+
+      fprintf(stderr, "Scanned %zu bytes, %d tokens in %.3f ms: %.1f MB/s\n", numBytes, numTokens,
+            seconds * 1e3, (seconds > 0) ? numBytes / seconds / 1e6 : 0.0);
+   }
+   else {
+      bc::runPasses(argv[optind], symtab);
+   }
+
+   if (context.holdMessages) {
+      FILE *out = openDiagnostics(diagPath);
+      const char *name = (diagFormat == bc::DiagText) ? NULL : argv[optind];
+
+      if (out == NULL) {
+         printf("ERROR(ARGLIST): output file \"%s\" could not be written.\n", diagPath);
+         context.numErrors++;
+      }
+      else {
+         bc::writeDiagnostics(out, diagFormat, {name}, {&context.messages});
+         closeDiagnostics(out);
+      }
+   }
+   else {
+      bc::flushDiagnostics();
+   }
+
+   printf("Number of warnings: %d\n", context.numWarnings);
+   printf("Number of errors: %d\n", context.numErrors + context.tokenErrors);
+
+   if (memReport) {
+      context.arena.report(stderr);
+   }
+   for (const string &remark : context.optRemarks) {
+      fprintf(stderr, "%s\n", remark.c_str());
+   }
+   if (timeReportJson) {
+      context.timeReport.printJson(stderr, argv[optind]);
+   }
+   else if (timeReport) {
+      context.timeReport.print(stderr);
+   }
+
+   // the whole tree goes away in one shot
+   delete symtab;
+   context.syntaxTree = NULL;
+   context.stringPool.clear();
+   context.arena.release();
+   for (index = 0; index < argc - optind + 1; index++) {
+      closeSource(&sources[index]);
+   }
+   delete [] sources;
+
+   return 0;
+}
@@ -0,0 +1,2669 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 2
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "parser.y"
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Grammar for bC. The parser is pure, everything it builds goes
+ * into the compiler context of the compile running on this thread and
+ * the scanner it reads from is passed in to yyparse().
+ *
+*/
+
+#include <cstdio>
+#include <time.h>
+#include "compilerContext.h"
+#include "yyerror.h"
+#include "scanType.h"
+#include "treeNodes.h"
+#include "treeUtils.h"
+
+// the semantic checks and code generation walk the tree on explicit
+// stacks, so nesting is only limited by the parser's own stack which
+// grows on the heap up to this many entries
+#define YYMAXDEPTH 1000000
+
+
+#line 96 "parser.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "parser.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_FIRSTOP = 3,                    /* FIRSTOP  */
+  YYSYMBOL_IF = 4,                         /* IF  */
+  YYSYMBOL_THEN = 5,                       /* THEN  */
+  YYSYMBOL_ELSE = 6,                       /* ELSE  */
+  YYSYMBOL_FOR = 7,                        /* FOR  */
+  YYSYMBOL_TO = 8,                         /* TO  */
+  YYSYMBOL_BY = 9,                         /* BY  */
+  YYSYMBOL_WHILE = 10,                     /* WHILE  */
+  YYSYMBOL_DO = 11,                        /* DO  */
+  YYSYMBOL_BREAK = 12,                     /* BREAK  */
+  YYSYMBOL_ADDASS = 13,                    /* ADDASS  */
+  YYSYMBOL_SUBASS = 14,                    /* SUBASS  */
+  YYSYMBOL_MULASS = 15,                    /* MULASS  */
+  YYSYMBOL_DIVASS = 16,                    /* DIVASS  */
+  YYSYMBOL_MIN = 17,                       /* MIN  */
+  YYSYMBOL_MAX = 18,                       /* MAX  */
+  YYSYMBOL_ID = 19,                        /* ID  */
+  YYSYMBOL_CHARCONST = 20,                 /* CHARCONST  */
+  YYSYMBOL_NUMCONST = 21,                  /* NUMCONST  */
+  YYSYMBOL_BOOLCONST = 22,                 /* BOOLCONST  */
+  YYSYMBOL_STRINGCONST = 23,               /* STRINGCONST  */
+  YYSYMBOL_CHAR = 24,                      /* CHAR  */
+  YYSYMBOL_INT = 25,                       /* INT  */
+  YYSYMBOL_BOOL = 26,                      /* BOOL  */
+  YYSYMBOL_STATIC = 27,                    /* STATIC  */
+  YYSYMBOL_28_ = 28,                       /* ';'  */
+  YYSYMBOL_29_ = 29,                       /* '('  */
+  YYSYMBOL_30_ = 30,                       /* ')'  */
+  YYSYMBOL_31_ = 31,                       /* '{'  */
+  YYSYMBOL_32_ = 32,                       /* '}'  */
+  YYSYMBOL_33_ = 33,                       /* '<'  */
+  YYSYMBOL_34_ = 34,                       /* '>'  */
+  YYSYMBOL_35_ = 35,                       /* '='  */
+  YYSYMBOL_36_ = 36,                       /* ','  */
+  YYSYMBOL_37_ = 37,                       /* ':'  */
+  YYSYMBOL_38_ = 38,                       /* '-'  */
+  YYSYMBOL_39_ = 39,                       /* '?'  */
+  YYSYMBOL_40_ = 40,                       /* '+'  */
+  YYSYMBOL_41_ = 41,                       /* '/'  */
+  YYSYMBOL_42_ = 42,                       /* '*'  */
+  YYSYMBOL_43_ = 43,                       /* '%'  */
+  YYSYMBOL_44_ = 44,                       /* '['  */
+  YYSYMBOL_45_ = 45,                       /* ']'  */
+  YYSYMBOL_NEQ = 46,                       /* NEQ  */
+  YYSYMBOL_EQ = 47,                        /* EQ  */
+  YYSYMBOL_LEQ = 48,                       /* LEQ  */
+  YYSYMBOL_GEQ = 49,                       /* GEQ  */
+  YYSYMBOL_AND = 50,                       /* AND  */
+  YYSYMBOL_OR = 51,                        /* OR  */
+  YYSYMBOL_NOT = 52,                       /* NOT  */
+  YYSYMBOL_INC = 53,                       /* INC  */
+  YYSYMBOL_DEC = 54,                       /* DEC  */
+  YYSYMBOL_PRECOMPILER = 55,               /* PRECOMPILER  */
+  YYSYMBOL_ERROR = 56,                     /* ERROR  */
+  YYSYMBOL_RETURN = 57,                    /* RETURN  */
+  YYSYMBOL_CHSIGN = 58,                    /* CHSIGN  */
+  YYSYMBOL_SIZEOF = 59,                    /* SIZEOF  */
+  YYSYMBOL_LASTOP = 60,                    /* LASTOP  */
+  YYSYMBOL_LASTTERM = 61,                  /* LASTTERM  */
+  YYSYMBOL_YYACCEPT = 62,                  /* $accept  */
+  YYSYMBOL_program = 63,                   /* program  */
+  YYSYMBOL_precomList = 64,                /* precomList  */
+  YYSYMBOL_declList = 65,                  /* declList  */
+  YYSYMBOL_decl = 66,                      /* decl  */
+  YYSYMBOL_varDecl = 67,                   /* varDecl  */
+  YYSYMBOL_scopedVarDecl = 68,             /* scopedVarDecl  */
+  YYSYMBOL_varDeclList = 69,               /* varDeclList  */
+  YYSYMBOL_varDeclInit = 70,               /* varDeclInit  */
+  YYSYMBOL_varDeclId = 71,                 /* varDeclId  */
+  YYSYMBOL_typeSpec = 72,                  /* typeSpec  */
+  YYSYMBOL_funDecl = 73,                   /* funDecl  */
+  YYSYMBOL_parms = 74,                     /* parms  */
+  YYSYMBOL_parmList = 75,                  /* parmList  */
+  YYSYMBOL_parmTypeList = 76,              /* parmTypeList  */
+  YYSYMBOL_parmIdList = 77,                /* parmIdList  */
+  YYSYMBOL_parmId = 78,                    /* parmId  */
+  YYSYMBOL_stmt = 79,                      /* stmt  */
+  YYSYMBOL_matched = 80,                   /* matched  */
+  YYSYMBOL_iterRange = 81,                 /* iterRange  */
+  YYSYMBOL_unmatched = 82,                 /* unmatched  */
+  YYSYMBOL_expStmt = 83,                   /* expStmt  */
+  YYSYMBOL_compoundStmt = 84,              /* compoundStmt  */
+  YYSYMBOL_localDecls = 85,                /* localDecls  */
+  YYSYMBOL_stmtList = 86,                  /* stmtList  */
+  YYSYMBOL_returnStmt = 87,                /* returnStmt  */
+  YYSYMBOL_breakStmt = 88,                 /* breakStmt  */
+  YYSYMBOL_exp = 89,                       /* exp  */
+  YYSYMBOL_assignop = 90,                  /* assignop  */
+  YYSYMBOL_simpleExp = 91,                 /* simpleExp  */
+  YYSYMBOL_relop = 92,                     /* relop  */
+  YYSYMBOL_arithExp = 93,                  /* arithExp  */
+  YYSYMBOL_minmaxop = 94,                  /* minmaxop  */
+  YYSYMBOL_sumop = 95,                     /* sumop  */
+  YYSYMBOL_mulop = 96,                     /* mulop  */
+  YYSYMBOL_unaryop = 97,                   /* unaryop  */
+  YYSYMBOL_mutable = 98,                   /* mutable  */
+  YYSYMBOL_call = 99,                      /* call  */
+  YYSYMBOL_args = 100,                     /* args  */
+  YYSYMBOL_argList = 101,                  /* argList  */
+  YYSYMBOL_constant = 102                  /* constant  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+/* Unqualified %code blocks.  */
+#line 35 "parser.y"
+
+// yyparse reads its tokens through timedLex so the time spent in the
+// scanner can be reported on its own (bC --time-report)
+static int timedLex(YYSTYPE *lvalp, void *scanner);
+#define yylex(lvalp, scanner) timedLex(lvalp, scanner)
+
+#line 240 "parser.tab.c"
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if 1
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* 1 */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  4
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   701
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  62
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  41
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  148
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  237
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   298
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,    43,     2,     2,
+      29,    30,    42,    40,    36,    38,     2,    41,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,    37,    28,
+      33,    35,    34,    39,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,    44,     2,    45,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    31,     2,    32,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    46,    47,    48,    49,    50,    51,    52,
+      53,    54,    55,    56,    57,    58,    59,    60,    61
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,    95,    95,    98,    99,   100,   103,   104,   107,   108,
+     109,   112,   113,   114,   118,   119,   120,   121,   124,   125,
+     126,   127,   130,   131,   132,   133,   136,   137,   140,   141,
+     144,   145,   146,   149,   150,   151,   152,   153,   154,   155,
+     158,   159,   162,   163,   164,   165,   168,   169,   172,   173,
+     174,   177,   178,   179,   182,   183,   187,   188,   189,   190,
+     191,   192,   193,   194,   195,   196,   197,   200,   201,   202,
+     203,   204,   207,   208,   209,   210,   211,   214,   215,   216,
+     219,   222,   223,   226,   227,   230,   231,   234,   237,   238,
+     239,   240,   241,   242,   243,   244,   247,   248,   249,   250,
+     251,   256,   257,   258,   259,   260,   261,   262,   263,   266,
+     267,   268,   269,   270,   271,   277,   278,   279,   280,   281,
+     282,   283,   284,   285,   286,   287,   288,   289,   292,   293,
+     296,   297,   300,   301,   302,   305,   306,   307,   310,   311,
+     318,   321,   322,   325,   326,   329,   330,   331,   332
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  static const char *const yy_sname[] =
+  {
+  "end of file", "error", "invalid token", "FIRSTOP", "IF", "THEN",
+  "ELSE", "FOR", "TO", "BY", "WHILE", "DO", "BREAK", "ADDASS", "SUBASS",
+  "MULASS", "DIVASS", "MIN", "MAX", "ID", "CHARCONST", "NUMCONST",
+  "BOOLCONST", "STRINGCONST", "CHAR", "INT", "BOOL", "STATIC", "';'",
+  "'('", "')'", "'{'", "'}'", "'<'", "'>'", "'='", "','", "':'", "'-'",
+  "'?'", "'+'", "'/'", "'*'", "'%'", "'['", "']'", "NEQ", "EQ", "LEQ",
+  "GEQ", "AND", "OR", "NOT", "INC", "DEC", "PRECOMPILER", "ERROR",
+  "RETURN", "CHSIGN", "SIZEOF", "LASTOP", "LASTTERM", "$accept", "program",
+  "precomList", "declList", "decl", "varDecl", "scopedVarDecl",
+  "varDeclList", "varDeclInit", "varDeclId", "typeSpec", "funDecl",
+  "parms", "parmList", "parmTypeList", "parmIdList", "parmId", "stmt",
+  "matched", "iterRange", "unmatched", "expStmt", "compoundStmt",
+  "localDecls", "stmtList", "returnStmt", "breakStmt", "exp", "assignop",
+  "simpleExp", "relop", "arithExp", "minmaxop", "sumop", "mulop",
+  "unaryop", "mutable", "call", "args", "argList", "constant", YY_NULLPTR
+  };
+  return yy_sname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-158)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-143)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+     -35,  -158,    40,    12,  -158,   281,    33,  -158,  -158,  -158,
+    -158,   675,  -158,  -158,    10,  -158,    88,    39,    99,  -158,
+      31,   147,  -158,   155,   -21,   110,   372,  -158,    11,  -158,
+      20,   396,    72,   123,    60,    71,  -158,  -158,   322,  -158,
+      66,   -19,  -158,  -158,  -158,  -158,   407,  -158,  -158,  -158,
+     431,     6,   644,   136,  -158,  -158,  -158,  -158,    94,    88,
+    -158,    66,     6,    53,    96,   140,  -158,   195,    17,    72,
+     151,  -158,   336,   442,   214,   152,     6,   274,    66,  -158,
+     466,   477,  -158,  -158,  -158,  -158,  -158,  -158,  -158,  -158,
+    -158,  -158,  -158,  -158,  -158,   606,   606,   617,   631,    66,
+    -158,  -158,  -158,   142,   149,   116,   501,   175,   372,   170,
+    -158,  -158,   361,  -158,  -158,  -158,  -158,  -158,  -158,  -158,
+     180,  -158,  -158,   234,   214,  -158,   181,   186,   187,  -158,
+    -158,  -158,  -158,  -158,  -158,  -158,   442,  -158,  -158,  -158,
+     512,    66,  -158,    66,   189,   625,   364,    66,   178,    66,
+    -158,  -158,   191,  -158,  -158,   114,    -4,   190,    24,  -158,
+     415,  -158,   203,  -158,   116,  -158,  -158,   442,  -158,  -158,
+     214,  -158,   273,   312,   273,   536,   273,   235,  -158,   160,
+      84,  -158,  -158,   116,  -158,   236,   547,   221,   372,  -158,
+    -158,   239,   105,   237,    14,  -158,  -158,    25,   158,   173,
+    -158,  -158,   273,   184,    -2,   215,    67,   273,   250,   273,
+     571,  -158,   176,  -158,  -158,  -158,  -158,   312,   312,   536,
+     312,  -158,  -158,  -158,  -158,  -158,    66,    42,  -158,   236,
+     252,   253,   582,   312,   312,    66,     6
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_uint8 yydefact[] =
+{
+       5,     4,     0,     0,     1,     0,     0,    32,    30,    31,
+       3,     0,     7,     8,     0,     9,    21,    26,     0,    20,
+      22,     0,     6,    35,    26,     0,     0,    29,     0,    12,
+       0,     0,    38,     0,     0,    40,    43,    13,     0,    11,
+       0,   138,   146,   145,   148,   147,     0,   135,   137,   136,
+       0,    24,   105,     0,   122,   120,   121,    28,     0,    19,
+      18,    25,    23,    47,    51,    46,    49,     0,     0,    36,
+       0,   127,     0,     0,   126,     0,    91,   122,   108,   103,
+       0,     0,   129,   128,   110,   111,   131,   130,   133,   132,
+     134,   114,   113,   109,   112,     0,     0,     0,     0,   125,
+     118,    27,    53,     0,     0,    39,     0,     0,     0,     0,
+      79,    82,     0,    34,    54,    55,    63,    64,    65,    66,
+       0,    44,    42,     0,     0,   144,     0,   141,     0,    97,
+      98,    99,   100,    96,    94,    95,     0,   119,    89,    90,
+       0,   107,   102,   106,   101,   104,   115,   123,   116,   124,
+     117,    52,     0,    48,    78,    59,     0,     0,     0,    87,
+      84,    85,     0,    77,    37,    33,   140,     0,   139,    92,
+      93,    88,     0,     0,     0,     0,     0,     0,    81,     0,
+       0,    86,   143,     0,    73,    54,     0,     0,     0,    60,
+      72,    54,     0,     0,     0,    61,    75,     0,    21,     0,
+      80,    83,     0,    59,     0,     0,     0,     0,     0,     0,
+       0,    16,     0,    17,    15,    58,    57,     0,     0,     0,
+       0,    56,    74,    71,    62,    76,    70,    67,    14,     0,
+       0,     0,     0,     0,     0,    69,    68
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -158,  -158,  -158,  -158,   255,  -158,  -158,   -12,   240,  -158,
+       3,  -158,   231,  -158,   207,  -158,   167,   -93,  -157,    59,
+     -55,  -158,  -158,  -158,  -158,  -158,  -158,   -39,   202,   -22,
+    -158,    13,  -158,  -158,  -158,  -158,   -26,  -158,  -158,  -158,
+    -158
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
+{
+       0,     2,     3,    11,    12,    13,   178,    18,    19,    20,
+      33,    15,    34,    35,    36,    65,    66,   113,   114,   193,
+     115,   116,   117,   160,   180,   118,   119,   120,   136,    76,
+      95,    52,    96,    97,    98,    53,    77,    55,   126,   127,
+      56
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+      54,   174,    25,   218,    51,    54,    14,    75,    38,    62,
+      72,    23,    57,     5,    14,   185,   189,   191,   121,   195,
+       1,    59,   210,    28,    54,    73,    16,    54,    79,    24,
+     165,     6,    58,   125,   128,   176,     7,     8,     9,    17,
+       4,     7,     8,     9,    17,   215,    80,    81,    80,    81,
+     221,   232,   224,   211,    54,    54,    80,    81,   142,   144,
+     229,   230,    21,   195,    80,    81,   100,    10,    31,    54,
+      54,    54,    54,   162,    80,    81,   221,   224,   220,   184,
+      54,   190,    54,    28,   156,   183,   158,   201,   106,   -50,
+      67,   107,    80,    81,   108,    71,   109,   169,   102,    68,
+     -45,   171,   -45,    41,    42,    43,    44,    45,   145,   146,
+     148,   150,   110,    46,   208,   111,   200,    80,    81,   172,
+     173,   196,    47,    48,    63,    26,    49,    29,   182,   129,
+     130,   131,   132,    27,    71,    30,    50,    99,    39,   101,
+     103,   112,    64,    71,   154,    71,    30,   216,    32,    54,
+     152,   133,   222,   194,   225,    41,    42,    43,    44,    45,
+      54,   198,    54,   179,   204,    46,   206,   199,    64,   134,
+     135,     7,     8,     9,    47,    48,   104,   -41,    49,    17,
+     197,   123,   137,    37,    54,   212,   213,   151,   227,   217,
+     173,   -21,    26,    54,   157,    26,   105,   194,   159,   106,
+      27,   214,   107,    27,   228,   108,    54,   109,   163,    30,
+     236,   166,    30,    71,    41,    42,    43,    44,    45,    88,
+      89,    90,   167,   110,    46,   175,   111,   129,   130,   131,
+     132,   181,   168,    47,    48,   164,   102,    49,   106,    80,
+     205,   107,   202,    71,   108,   207,   109,    50,   209,   133,
+     219,   223,   112,    41,    42,    43,    44,    45,   233,     7,
+       8,     9,   110,    46,   234,   111,    22,   134,   135,    70,
+      60,   153,    47,    48,   183,   122,    49,   106,   231,   140,
+     107,   -10,    16,   108,     0,   109,    50,   129,   130,   131,
+     132,   112,    41,    42,    43,    44,    45,     0,     0,     0,
+      17,   110,    46,     0,   111,   -10,   -10,   -10,     0,   133,
+       0,    47,    48,   183,     0,    49,   186,     0,     0,   187,
+       0,     0,   188,    69,   109,    50,     0,   138,   139,     0,
+     112,    41,    42,    43,    44,    45,     0,   124,     0,     0,
+     110,    46,     0,   111,     0,     0,     7,     8,     9,     0,
+      47,    48,   -41,     0,    49,    41,    42,    43,    44,    45,
+       0,     0,   124,     0,    50,    46,  -142,     0,     0,   112,
+       0,     0,     0,    40,    47,    48,     0,     0,    49,     0,
+      41,    42,    43,    44,    45,     0,     0,     0,    50,   161,
+      46,    41,    42,    43,    44,    45,     0,    61,     0,    47,
+      48,    46,    86,    49,    87,    88,    89,    90,    74,     0,
+      47,    48,     0,    50,    49,    41,    42,    43,    44,    45,
+       0,     0,     0,     0,    50,    46,    41,    42,    43,    44,
+      45,     0,    78,     0,    47,    48,    46,     0,    49,     7,
+       8,     9,   177,   124,     0,    47,    48,     0,    50,    49,
+      41,    42,    43,    44,    45,     0,     0,     0,     0,    50,
+      46,    41,    42,    43,    44,    45,     0,   141,     0,    47,
+      48,    46,     0,    49,     0,     0,     0,     0,   143,     0,
+      47,    48,     0,    50,    49,    41,    42,    43,    44,    45,
+       0,     0,     0,     0,    50,    46,    41,    42,    43,    44,
+      45,     0,   155,     0,    47,    48,    46,     0,    49,     0,
+       0,     0,     0,   170,     0,    47,    48,     0,    50,    49,
+      41,    42,    43,    44,    45,     0,     0,     0,     0,    50,
+      46,    41,    42,    43,    44,    45,     0,   192,     0,    47,
+      48,    46,     0,    49,     0,     0,     0,     0,   203,     0,
+      47,    48,     0,    50,    49,    41,    42,    43,    44,    45,
+       0,     0,     0,     0,    50,    46,    41,    42,    43,    44,
+      45,     0,   226,     0,    47,    48,    46,     0,    49,     0,
+       0,     0,     0,   235,     0,    47,    48,     0,    50,    49,
+      41,    42,    43,    44,    45,     0,     0,     0,     0,    50,
+      46,    41,    42,    43,    44,    45,     0,    40,     0,    47,
+      48,    46,     0,    49,     0,     0,     0,     0,   147,     0,
+      47,    48,     0,    50,    49,    41,    42,    43,    44,    45,
+       0,     0,   149,     0,    50,    46,    41,    42,    43,    44,
+      45,     0,    82,    83,    47,    48,    46,     0,    49,     0,
+      41,    42,    43,    44,    45,    47,    48,     0,     0,    49,
+      46,    82,    83,    86,     0,    87,    88,    89,    90,    47,
+      48,     0,     0,    49,     0,    -2,     5,    84,    85,     0,
+       0,     0,    86,     0,    87,    88,    89,    90,     0,     0,
+      91,    92,    93,    94,     6,     0,     0,     0,     0,     7,
+       8,     9
+};
+
+static const yytype_int16 yycheck[] =
+{
+      26,     5,    14,     5,    26,    31,     3,    46,    29,    31,
+      29,     1,     1,     1,    11,   172,   173,   174,     1,   176,
+      55,     1,     8,    44,    50,    44,     1,    53,    50,    19,
+     123,    19,    21,    72,    73,    11,    24,    25,    26,    19,
+       0,    24,    25,    26,    19,   202,    50,    51,    50,    51,
+     207,     9,   209,    28,    80,    81,    50,    51,    80,    81,
+     217,   218,    29,   220,    50,    51,    53,    55,    37,    95,
+      96,    97,    98,   112,    50,    51,   233,   234,    11,   172,
+     106,   174,   108,    44,   106,     1,   108,   180,     4,    36,
+      30,     7,    50,    51,    10,    29,    12,   136,    45,    28,
+      28,   140,    30,    19,    20,    21,    22,    23,    95,    96,
+      97,    98,    28,    29,     9,    31,    32,    50,    51,     5,
+       6,   176,    38,    39,     1,    37,    42,    28,   167,    13,
+      14,    15,    16,    45,    29,    36,    52,     1,    28,    45,
+      44,    57,    19,    29,    28,    29,    36,   202,     1,   175,
+       1,    35,   207,   175,   209,    19,    20,    21,    22,    23,
+     186,     1,   188,   160,   186,    29,   188,   179,    19,    53,
+      54,    24,    25,    26,    38,    39,    36,    30,    42,    19,
+     177,    30,    30,    28,   210,   197,    28,    45,   210,     5,
+       6,    36,    37,   219,    19,    37,     1,   219,    28,     4,
+      45,    28,     7,    45,    28,    10,   232,    12,    28,    36,
+     232,    30,    36,    29,    19,    20,    21,    22,    23,    41,
+      42,    43,    36,    28,    29,    35,    31,    13,    14,    15,
+      16,    28,    45,    38,    39,     1,    45,    42,     4,    50,
+      19,     7,     6,    29,    10,     6,    12,    52,    11,    35,
+      35,     1,    57,    19,    20,    21,    22,    23,     6,    24,
+      25,    26,    28,    29,    11,    31,    11,    53,    54,    38,
+      30,   104,    38,    39,     1,    68,    42,     4,   219,    77,
+       7,     0,     1,    10,    -1,    12,    52,    13,    14,    15,
+      16,    57,    19,    20,    21,    22,    23,    -1,    -1,    -1,
+      19,    28,    29,    -1,    31,    24,    25,    26,    -1,    35,
+      -1,    38,    39,     1,    -1,    42,     4,    -1,    -1,     7,
+      -1,    -1,    10,     1,    12,    52,    -1,    53,    54,    -1,
+      57,    19,    20,    21,    22,    23,    -1,     1,    -1,    -1,
+      28,    29,    -1,    31,    -1,    -1,    24,    25,    26,    -1,
+      38,    39,    30,    -1,    42,    19,    20,    21,    22,    23,
+      -1,    -1,     1,    -1,    52,    29,    30,    -1,    -1,    57,
+      -1,    -1,    -1,     1,    38,    39,    -1,    -1,    42,    -1,
+      19,    20,    21,    22,    23,    -1,    -1,    -1,    52,    28,
+      29,    19,    20,    21,    22,    23,    -1,     1,    -1,    38,
+      39,    29,    38,    42,    40,    41,    42,    43,     1,    -1,
+      38,    39,    -1,    52,    42,    19,    20,    21,    22,    23,
+      -1,    -1,    -1,    -1,    52,    29,    19,    20,    21,    22,
+      23,    -1,     1,    -1,    38,    39,    29,    -1,    42,    24,
+      25,    26,    27,     1,    -1,    38,    39,    -1,    52,    42,
+      19,    20,    21,    22,    23,    -1,    -1,    -1,    -1,    52,
+      29,    19,    20,    21,    22,    23,    -1,     1,    -1,    38,
+      39,    29,    -1,    42,    -1,    -1,    -1,    -1,     1,    -1,
+      38,    39,    -1,    52,    42,    19,    20,    21,    22,    23,
+      -1,    -1,    -1,    -1,    52,    29,    19,    20,    21,    22,
+      23,    -1,     1,    -1,    38,    39,    29,    -1,    42,    -1,
+      -1,    -1,    -1,     1,    -1,    38,    39,    -1,    52,    42,
+      19,    20,    21,    22,    23,    -1,    -1,    -1,    -1,    52,
+      29,    19,    20,    21,    22,    23,    -1,     1,    -1,    38,
+      39,    29,    -1,    42,    -1,    -1,    -1,    -1,     1,    -1,
+      38,    39,    -1,    52,    42,    19,    20,    21,    22,    23,
+      -1,    -1,    -1,    -1,    52,    29,    19,    20,    21,    22,
+      23,    -1,     1,    -1,    38,    39,    29,    -1,    42,    -1,
+      -1,    -1,    -1,     1,    -1,    38,    39,    -1,    52,    42,
+      19,    20,    21,    22,    23,    -1,    -1,    -1,    -1,    52,
+      29,    19,    20,    21,    22,    23,    -1,     1,    -1,    38,
+      39,    29,    -1,    42,    -1,    -1,    -1,    -1,     1,    -1,
+      38,    39,    -1,    52,    42,    19,    20,    21,    22,    23,
+      -1,    -1,     1,    -1,    52,    29,    19,    20,    21,    22,
+      23,    -1,    17,    18,    38,    39,    29,    -1,    42,    -1,
+      19,    20,    21,    22,    23,    38,    39,    -1,    -1,    42,
+      29,    17,    18,    38,    -1,    40,    41,    42,    43,    38,
+      39,    -1,    -1,    42,    -1,     0,     1,    33,    34,    -1,
+      -1,    -1,    38,    -1,    40,    41,    42,    43,    -1,    -1,
+      46,    47,    48,    49,    19,    -1,    -1,    -1,    -1,    24,
+      25,    26
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,    55,    63,    64,     0,     1,    19,    24,    25,    26,
+      55,    65,    66,    67,    72,    73,     1,    19,    69,    70,
+      71,    29,    66,     1,    19,    69,    37,    45,    44,    28,
+      36,    37,     1,    72,    74,    75,    76,    28,    29,    28,
+       1,    19,    20,    21,    22,    23,    29,    38,    39,    42,
+      52,    91,    93,    97,    98,    99,   102,     1,    21,     1,
+      70,     1,    91,     1,    19,    77,    78,    30,    28,     1,
+      74,    29,    29,    44,     1,    89,    91,    98,     1,    91,
+      50,    51,    17,    18,    33,    34,    38,    40,    41,    42,
+      43,    46,    47,    48,    49,    92,    94,    95,    96,     1,
+      93,    45,    45,    44,    36,     1,     4,     7,    10,    12,
+      28,    31,    57,    79,    80,    82,    83,    84,    87,    88,
+      89,     1,    76,    30,     1,    89,   100,   101,    89,    13,
+      14,    15,    16,    35,    53,    54,    90,    30,    53,    54,
+      90,     1,    91,     1,    91,    93,    93,     1,    93,     1,
+      93,    45,     1,    78,    28,     1,    91,    19,    91,    28,
+      85,    28,    89,    28,     1,    79,    30,    36,    45,    89,
+       1,    89,     5,     6,     5,    35,    11,    27,    68,    72,
+      86,    28,    89,     1,    79,    80,     4,     7,    10,    80,
+      79,    80,     1,    81,    91,    80,    82,    72,     1,    69,
+      32,    79,     6,     1,    91,    19,    91,     6,     9,    11,
+       8,    28,    69,    28,    28,    80,    82,     5,     5,    35,
+      11,    80,    82,     1,    80,    82,     1,    91,    28,    80,
+      80,    81,     9,     6,    11,     1,    91
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    62,    63,    64,    64,    64,    65,    65,    66,    66,
+      66,    67,    67,    67,    68,    68,    68,    68,    69,    69,
+      69,    69,    70,    70,    70,    70,    71,    71,    71,    71,
+      72,    72,    72,    73,    73,    73,    73,    73,    73,    73,
+      74,    74,    75,    75,    75,    75,    76,    76,    77,    77,
+      77,    78,    78,    78,    79,    79,    80,    80,    80,    80,
+      80,    80,    80,    80,    80,    80,    80,    81,    81,    81,
+      81,    81,    82,    82,    82,    82,    82,    83,    83,    83,
+      84,    85,    85,    86,    86,    87,    87,    88,    89,    89,
+      89,    89,    89,    89,    89,    89,    90,    90,    90,    90,
+      90,    91,    91,    91,    91,    91,    91,    91,    91,    92,
+      92,    92,    92,    92,    92,    93,    93,    93,    93,    93,
+      93,    93,    93,    93,    93,    93,    93,    93,    94,    94,
+      95,    95,    96,    96,    96,    97,    97,    97,    98,    98,
+      99,   100,   100,   101,   101,   102,   102,   102,   102
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     2,     2,     1,     0,     2,     1,     1,     1,
+       1,     3,     3,     3,     4,     3,     3,     3,     3,     3,
+       1,     1,     1,     3,     3,     3,     1,     4,     3,     2,
+       1,     1,     1,     6,     5,     2,     4,     6,     3,     5,
+       1,     0,     3,     1,     3,     1,     2,     2,     3,     1,
+       1,     1,     3,     2,     1,     1,     6,     6,     6,     2,
+       4,     4,     6,     1,     1,     1,     1,     3,     5,     5,
+       3,     3,     4,     4,     6,     4,     6,     2,     2,     1,
+       4,     2,     0,     2,     0,     2,     3,     2,     3,     2,
+       2,     1,     3,     3,     2,     2,     1,     1,     1,     1,
+       1,     3,     3,     2,     3,     1,     3,     3,     2,     1,
+       1,     1,     1,     1,     1,     3,     3,     3,     2,     3,
+       1,     1,     1,     3,     3,     2,     2,     2,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     4,
+       4,     1,     0,     3,     1,     1,     1,     1,     1
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (scanner, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, scanner); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, void *scanner)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (scanner);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, void *scanner)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep, scanner);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, void *scanner)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], scanner);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, scanner); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
+
+
+/* The kind of the lookahead of this context.  */
+static yysymbol_kind_t
+yypcontext_token (const yypcontext_t *yyctx) YY_ATTRIBUTE_UNUSED;
+
+static yysymbol_kind_t
+yypcontext_token (const yypcontext_t *yyctx)
+{
+  return yyctx->yytoken;
+}
+
+
+
+/* User defined function to report a syntax error.  */
+static int
+yyreport_syntax_error (const yypcontext_t *yyctx, void *scanner);
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, void *scanner)
+{
+  YY_USE (yyvaluep);
+  YY_USE (scanner);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (void *scanner)
+{
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, scanner);
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* program: precomList declList  */
+#line 95 "parser.y"
+                                                    { ctx->syntaxTree = (yyvsp[0].tnode); }
+#line 1523 "parser.tab.c"
+    break;
+
+  case 3: /* precomList: precomList PRECOMPILER  */
+#line 98 "parser.y"
+                                                      { (yyval.tnode) = NULL; fprintf(ctx->out, "%s\n", yylval.tinfo->tokenstr); }
+#line 1529 "parser.tab.c"
+    break;
+
+  case 4: /* precomList: PRECOMPILER  */
+#line 99 "parser.y"
+                                                         { (yyval.tnode) = NULL; fprintf(ctx->out, "%s\n", yylval.tinfo->tokenstr);}
+#line 1535 "parser.tab.c"
+    break;
+
+  case 5: /* precomList: %empty  */
+#line 100 "parser.y"
+                                                         {  (yyval.tnode) = NULL;  }
+#line 1541 "parser.tab.c"
+    break;
+
+  case 6: /* declList: declList decl  */
+#line 103 "parser.y"
+                                                    { (yyval.tnode) = addSibling((yyvsp[-1].tnode), (yyvsp[0].tnode));  }
+#line 1547 "parser.tab.c"
+    break;
+
+  case 7: /* declList: decl  */
+#line 104 "parser.y"
+                  { (yyval.tnode) = (yyvsp[0].tnode); }
+#line 1553 "parser.tab.c"
+    break;
+
+  case 8: /* decl: varDecl  */
+#line 107 "parser.y"
+                     { (yyval.tnode) = (yyvsp[0].tnode); }
+#line 1559 "parser.tab.c"
+    break;
+
+  case 9: /* decl: funDecl  */
+#line 108 "parser.y"
+                     { (yyval.tnode) = (yyvsp[0].tnode); }
+#line 1565 "parser.tab.c"
+    break;
+
+  case 10: /* decl: error  */
+#line 109 "parser.y"
+                     { (yyval.tnode) = NULL; yyerrok; }
+#line 1571 "parser.tab.c"
+    break;
+
+  case 11: /* varDecl: typeSpec varDeclList ';'  */
+#line 112 "parser.y"
+                                                    { setType((yyvsp[-2].etype), (yyvsp[-1].tnode), false); (yyval.tnode) = (yyvsp[-1].tnode);  }
+#line 1577 "parser.tab.c"
+    break;
+
+  case 12: /* varDecl: error varDeclList ';'  */
+#line 113 "parser.y"
+                                                    { (yyval.tnode) = NULL; yyerrok; }
+#line 1583 "parser.tab.c"
+    break;
+
+  case 13: /* varDecl: typeSpec error ';'  */
+#line 114 "parser.y"
+                                                        { (yyval.tnode) = NULL; yyerrok; }
+#line 1589 "parser.tab.c"
+    break;
+
+  case 14: /* scopedVarDecl: STATIC typeSpec varDeclList ';'  */
+#line 118 "parser.y"
+                                                     { (yyval.tnode) = (yyvsp[-1].tnode); setType((yyvsp[-2].etype), (yyvsp[-1].tnode), true); }
+#line 1595 "parser.tab.c"
+    break;
+
+  case 15: /* scopedVarDecl: typeSpec varDeclList ';'  */
+#line 119 "parser.y"
+                                                     { (yyval.tnode) = (yyvsp[-1].tnode); setType((yyvsp[-2].etype), (yyvsp[-1].tnode), false); }
+#line 1601 "parser.tab.c"
+    break;
+
+  case 16: /* scopedVarDecl: STATIC typeSpec ';'  */
+#line 120 "parser.y"
+                                                     { (yyval.tnode) = NULL; yyerrok; }
+#line 1607 "parser.tab.c"
+    break;
+
+  case 17: /* scopedVarDecl: typeSpec error ';'  */
+#line 121 "parser.y"
+                                                     { (yyval.tnode) = NULL; yyerrok; }
+#line 1613 "parser.tab.c"
+    break;
+
+  case 18: /* varDeclList: varDeclList ',' varDeclInit  */
+#line 124 "parser.y"
+                                                     { (yyval.tnode) = addSibling((yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 1619 "parser.tab.c"
+    break;
+
+  case 19: /* varDeclList: varDeclList ',' error  */
+#line 125 "parser.y"
+                                                     { (yyval.tnode) = NULL; }
+#line 1625 "parser.tab.c"
+    break;
+
+  case 20: /* varDeclList: varDeclInit  */
+#line 126 "parser.y"
+                                                     { (yyval.tnode) = (yyvsp[0].tnode);  }
+#line 1631 "parser.tab.c"
+    break;
+
+  case 21: /* varDeclList: error  */
+#line 127 "parser.y"
+                                                     { (yyval.tnode) = NULL; }
+#line 1637 "parser.tab.c"
+    break;
+
+  case 22: /* varDeclInit: varDeclId  */
+#line 130 "parser.y"
+                                                     { (yyval.tnode) = (yyvsp[0].tnode); }
+#line 1643 "parser.tab.c"
+    break;
+
+  case 23: /* varDeclInit: varDeclId ':' simpleExp  */
+#line 131 "parser.y"
+                                                     { (yyval.tnode) = (yyvsp[-2].tnode); if ((yyval.tnode) != NULL) (yyval.tnode)->child[0] = (yyvsp[0].tnode); }
+#line 1649 "parser.tab.c"
+    break;
+
+  case 24: /* varDeclInit: error ':' simpleExp  */
+#line 132 "parser.y"
+                                                     { (yyval.tnode) = NULL; yyerrok; }
+#line 1655 "parser.tab.c"
+    break;
+
+  case 25: /* varDeclInit: varDeclId ':' error  */
+#line 133 "parser.y"
+                                                     { (yyval.tnode) = NULL; yyerrok; }
+#line 1661 "parser.tab.c"
+    break;
+
+  case 26: /* varDeclId: ID  */
+#line 136 "parser.y"
+                                                     { (yyval.tnode) = newDeclNode(VarK, UndefinedType, (yyvsp[0].tinfo)); }
+#line 1667 "parser.tab.c"
+    break;
+
+  case 27: /* varDeclId: ID '[' NUMCONST ']'  */
+#line 137 "parser.y"
+                                                     { (yyval.tnode) = newDeclNode(VarK, UndefinedType, (yyvsp[-3].tinfo));
+                                                       (yyval.tnode)->isArray = true;
+                                                       (yyval.tnode)->size = 1 + (yyvsp[-1].tinfo)->nvalue; }
+#line 1675 "parser.tab.c"
+    break;
+
+  case 28: /* varDeclId: ID '[' error  */
+#line 140 "parser.y"
+                                                     { (yyval.tnode) = NULL; yyerrok; }
+#line 1681 "parser.tab.c"
+    break;
+
+  case 29: /* varDeclId: error ']'  */
+#line 141 "parser.y"
+                                                     { (yyval.tnode) = NULL; yyerrok;  }
+#line 1687 "parser.tab.c"
+    break;
+
+  case 30: /* typeSpec: INT  */
+#line 144 "parser.y"
+                                                        { (yyval.etype) = Integer; }
+#line 1693 "parser.tab.c"
+    break;
+
+  case 31: /* typeSpec: BOOL  */
+#line 145 "parser.y"
+                                                        {(yyval.etype) = Boolean;}
+#line 1699 "parser.tab.c"
+    break;
+
+  case 32: /* typeSpec: CHAR  */
+#line 146 "parser.y"
+                                                        { (yyval.etype) = Char;}
+#line 1705 "parser.tab.c"
+    break;
+
+  case 33: /* funDecl: typeSpec ID '(' parms ')' stmt  */
+#line 149 "parser.y"
+                                                  { (yyval.tnode) = newDeclNode(FuncK, (yyvsp[-5].etype), (yyvsp[-4].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 1711 "parser.tab.c"
+    break;
+
+  case 34: /* funDecl: ID '(' parms ')' stmt  */
+#line 150 "parser.y"
+                                                     { (yyval.tnode) = newDeclNode(FuncK, Void, (yyvsp[-4].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 1717 "parser.tab.c"
+    break;
+
+  case 35: /* funDecl: typeSpec error  */
+#line 151 "parser.y"
+                                              { (yyval.tnode) = NULL;  }
+#line 1723 "parser.tab.c"
+    break;
+
+  case 36: /* funDecl: typeSpec ID '(' error  */
+#line 152 "parser.y"
+                                                        { (yyval.tnode) = NULL;  }
+#line 1729 "parser.tab.c"
+    break;
+
+  case 37: /* funDecl: typeSpec ID '(' parms ')' error  */
+#line 153 "parser.y"
+                                                               { (yyval.tnode) = NULL; }
+#line 1735 "parser.tab.c"
+    break;
+
+  case 38: /* funDecl: ID '(' error  */
+#line 154 "parser.y"
+                                                        { (yyval.tnode) = NULL;  }
+#line 1741 "parser.tab.c"
+    break;
+
+  case 39: /* funDecl: ID '(' parms ')' error  */
+#line 155 "parser.y"
+                                                      { (yyval.tnode) = NULL;  }
+#line 1747 "parser.tab.c"
+    break;
+
+  case 40: /* parms: parmList  */
+#line 158 "parser.y"
+                      {(yyval.tnode) = (yyvsp[0].tnode);}
+#line 1753 "parser.tab.c"
+    break;
+
+  case 41: /* parms: %empty  */
+#line 159 "parser.y"
+                                                        { (yyval.tnode) = NULL; }
+#line 1759 "parser.tab.c"
+    break;
+
+  case 42: /* parmList: parmList ';' parmTypeList  */
+#line 162 "parser.y"
+                                                    { (yyval.tnode) = addSibling((yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 1765 "parser.tab.c"
+    break;
+
+  case 43: /* parmList: parmTypeList  */
+#line 163 "parser.y"
+                                                    { (yyval.tnode) = (yyvsp[0].tnode); }
+#line 1771 "parser.tab.c"
+    break;
+
+  case 44: /* parmList: parmList ';' error  */
+#line 164 "parser.y"
+                                                    { (yyval.tnode) = NULL; }
+#line 1777 "parser.tab.c"
+    break;
+
+  case 45: /* parmList: error  */
+#line 165 "parser.y"
+                                                    { (yyval.tnode) = NULL; }
+#line 1783 "parser.tab.c"
+    break;
+
+  case 46: /* parmTypeList: typeSpec parmIdList  */
+#line 168 "parser.y"
+                                                    { setType((yyvsp[-1].etype), (yyvsp[0].tnode), false); (yyval.tnode) = (yyvsp[0].tnode); }
+#line 1789 "parser.tab.c"
+    break;
+
+  case 47: /* parmTypeList: typeSpec error  */
+#line 169 "parser.y"
+                                                    { (yyval.tnode) = NULL; yyerrok; }
+#line 1795 "parser.tab.c"
+    break;
+
+  case 48: /* parmIdList: parmIdList ',' parmId  */
+#line 172 "parser.y"
+                                                     { (yyval.tnode) = addSibling((yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 1801 "parser.tab.c"
+    break;
+
+  case 49: /* parmIdList: parmId  */
+#line 173 "parser.y"
+                      { (yyval.tnode) = (yyvsp[0].tnode); }
+#line 1807 "parser.tab.c"
+    break;
+
+  case 50: /* parmIdList: error  */
+#line 174 "parser.y"
+                                                     { (yyval.tnode) = NULL; yyerrok; }
+#line 1813 "parser.tab.c"
+    break;
+
+  case 51: /* parmId: ID  */
+#line 177 "parser.y"
+                                                         { (yyval.tnode) = newDeclNode(ParamK, UndefinedType, (yyvsp[0].tinfo)); }
+#line 1819 "parser.tab.c"
+    break;
+
+  case 52: /* parmId: ID '[' ']'  */
+#line 178 "parser.y"
+                                                         { (yyval.tnode) = newDeclNode(ParamK, UndefinedType, (yyvsp[-2].tinfo)); (yyval.tnode)->isArray = true; }
+#line 1825 "parser.tab.c"
+    break;
+
+  case 53: /* parmId: error ']'  */
+#line 179 "parser.y"
+                                                         { (yyval.tnode) = NULL; yyerrok; }
+#line 1831 "parser.tab.c"
+    break;
+
+  case 54: /* stmt: matched  */
+#line 182 "parser.y"
+                     {(yyval.tnode) = (yyvsp[0].tnode); }
+#line 1837 "parser.tab.c"
+    break;
+
+  case 55: /* stmt: unmatched  */
+#line 183 "parser.y"
+                       {(yyval.tnode) = (yyvsp[0].tnode); }
+#line 1843 "parser.tab.c"
+    break;
+
+  case 56: /* matched: IF simpleExp THEN matched ELSE matched  */
+#line 187 "parser.y"
+                                                         { (yyval.tnode) = newStmtNode(IfK, (yyvsp[-5].tinfo), (yyvsp[-4].tnode), (yyvsp[-2].tnode), (yyvsp[0].tnode));  }
+#line 1849 "parser.tab.c"
+    break;
+
+  case 57: /* matched: IF error THEN matched ELSE unmatched  */
+#line 188 "parser.y"
+                                                         { (yyval.tnode) = NULL; yyerrok; }
+#line 1855 "parser.tab.c"
+    break;
+
+  case 58: /* matched: IF error THEN matched ELSE matched  */
+#line 189 "parser.y"
+                                                         { (yyval.tnode) = NULL; yyerrok; }
+#line 1861 "parser.tab.c"
+    break;
+
+  case 59: /* matched: IF error  */
+#line 190 "parser.y"
+                                                         { (yyval.tnode) = NULL; yyerrok; }
+#line 1867 "parser.tab.c"
+    break;
+
+  case 60: /* matched: IF error ELSE matched  */
+#line 191 "parser.y"
+                                                         { (yyval.tnode) = NULL; yyerrok; }
+#line 1873 "parser.tab.c"
+    break;
+
+  case 61: /* matched: WHILE simpleExp DO matched  */
+#line 192 "parser.y"
+                                                         { (yyval.tnode) = newStmtNode(WhileK, (yyvsp[-3].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode));  }
+#line 1879 "parser.tab.c"
+    break;
+
+  case 62: /* matched: FOR ID '=' iterRange DO matched  */
+#line 193 "parser.y"
+                                                         { (yyval.tnode) = newStmtNode(ForK, (yyvsp[-5].tinfo), NULL, (yyvsp[-2].tnode), (yyvsp[0].tnode)); (yyval.tnode)->child[0] = newDeclNode(VarK, Integer, (yyvsp[-4].tinfo)); }
+#line 1885 "parser.tab.c"
+    break;
+
+  case 63: /* matched: expStmt  */
+#line 194 "parser.y"
+                     {(yyval.tnode) = (yyvsp[0].tnode); }
+#line 1891 "parser.tab.c"
+    break;
+
+  case 64: /* matched: compoundStmt  */
+#line 195 "parser.y"
+                          {(yyval.tnode) = (yyvsp[0].tnode); }
+#line 1897 "parser.tab.c"
+    break;
+
+  case 65: /* matched: returnStmt  */
+#line 196 "parser.y"
+                        {(yyval.tnode) = (yyvsp[0].tnode); }
+#line 1903 "parser.tab.c"
+    break;
+
+  case 66: /* matched: breakStmt  */
+#line 197 "parser.y"
+                       {(yyval.tnode) = (yyvsp[0].tnode); }
+#line 1909 "parser.tab.c"
+    break;
+
+  case 67: /* iterRange: simpleExp TO simpleExp  */
+#line 200 "parser.y"
+                                                     { (yyval.tnode) = newStmtNode(RangeK, (yyvsp[-1].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 1915 "parser.tab.c"
+    break;
+
+  case 68: /* iterRange: simpleExp TO simpleExp BY simpleExp  */
+#line 201 "parser.y"
+                                                    { (yyval.tnode) = newStmtNode(RangeK, (yyvsp[-3].tinfo), (yyvsp[-4].tnode), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 1921 "parser.tab.c"
+    break;
+
+  case 69: /* iterRange: simpleExp TO simpleExp BY error  */
+#line 202 "parser.y"
+                                                   { (yyval.tnode) = NULL; yyerrok; }
+#line 1927 "parser.tab.c"
+    break;
+
+  case 70: /* iterRange: simpleExp TO error  */
+#line 203 "parser.y"
+                                                    { (yyval.tnode) = NULL; yyerrok; }
+#line 1933 "parser.tab.c"
+    break;
+
+  case 71: /* iterRange: error BY error  */
+#line 204 "parser.y"
+                                                    { (yyval.tnode) = NULL; yyerrok; }
+#line 1939 "parser.tab.c"
+    break;
+
+  case 72: /* unmatched: IF simpleExp THEN stmt  */
+#line 207 "parser.y"
+                                                       { (yyval.tnode) = newStmtNode(IfK, (yyvsp[-3].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 1945 "parser.tab.c"
+    break;
+
+  case 73: /* unmatched: IF error THEN stmt  */
+#line 208 "parser.y"
+                                                       { (yyval.tnode) = NULL; yyerrok; }
+#line 1951 "parser.tab.c"
+    break;
+
+  case 74: /* unmatched: IF simpleExp THEN matched ELSE unmatched  */
+#line 209 "parser.y"
+                                                       { (yyval.tnode) = newStmtNode(IfK, (yyvsp[-5].tinfo), (yyvsp[-4].tnode), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 1957 "parser.tab.c"
+    break;
+
+  case 75: /* unmatched: WHILE simpleExp DO unmatched  */
+#line 210 "parser.y"
+                                                         { (yyval.tnode) = newStmtNode(WhileK, (yyvsp[-3].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 1963 "parser.tab.c"
+    break;
+
+  case 76: /* unmatched: FOR ID '=' iterRange DO unmatched  */
+#line 211 "parser.y"
+                                                         { (yyval.tnode) = newStmtNode(ForK, (yyvsp[-5].tinfo), NULL, (yyvsp[-2].tnode), (yyvsp[0].tnode)); (yyval.tnode)->child[0] = newDeclNode(VarK, Integer, (yyvsp[-4].tinfo)); }
+#line 1969 "parser.tab.c"
+    break;
+
+  case 77: /* expStmt: exp ';'  */
+#line 214 "parser.y"
+                                                        { (yyval.tnode) = (yyvsp[-1].tnode); }
+#line 1975 "parser.tab.c"
+    break;
+
+  case 78: /* expStmt: error ';'  */
+#line 215 "parser.y"
+                                                        { (yyval.tnode) = NULL; yyerrok; }
+#line 1981 "parser.tab.c"
+    break;
+
+  case 79: /* expStmt: ';'  */
+#line 216 "parser.y"
+                                                        { (yyval.tnode) = NULL; yyerrok; }
+#line 1987 "parser.tab.c"
+    break;
+
+  case 80: /* compoundStmt: '{' localDecls stmtList '}'  */
+#line 219 "parser.y"
+                                                   { (yyval.tnode) = newStmtNode(CompoundK, (yyvsp[-3].tinfo), (yyvsp[-2].tnode), (yyvsp[-1].tnode));  }
+#line 1993 "parser.tab.c"
+    break;
+
+  case 81: /* localDecls: localDecls scopedVarDecl  */
+#line 222 "parser.y"
+                                                   { (yyval.tnode) = addSibling((yyvsp[-1].tnode), (yyvsp[0].tnode));}
+#line 1999 "parser.tab.c"
+    break;
+
+  case 82: /* localDecls: %empty  */
+#line 223 "parser.y"
+                                                       {  (yyval.tnode) = NULL; }
+#line 2005 "parser.tab.c"
+    break;
+
+  case 83: /* stmtList: stmtList stmt  */
+#line 226 "parser.y"
+                                                   { (yyval.tnode) = addSibling((yyvsp[-1].tnode), (yyvsp[0].tnode)); }
+#line 2011 "parser.tab.c"
+    break;
+
+  case 84: /* stmtList: %empty  */
+#line 227 "parser.y"
+                                                       {  (yyval.tnode) = NULL; }
+#line 2017 "parser.tab.c"
+    break;
+
+  case 85: /* returnStmt: RETURN ';'  */
+#line 230 "parser.y"
+                                                       {  (yyval.tnode) = newStmtNode(ReturnK, (yyvsp[-1].tinfo));}
+#line 2023 "parser.tab.c"
+    break;
+
+  case 86: /* returnStmt: RETURN exp ';'  */
+#line 231 "parser.y"
+                                                       { (yyval.tnode) = newStmtNode(ReturnK, (yyvsp[-2].tinfo), (yyvsp[-1].tnode));  }
+#line 2029 "parser.tab.c"
+    break;
+
+  case 87: /* breakStmt: BREAK ';'  */
+#line 234 "parser.y"
+                                                       { (yyval.tnode) = newStmtNode(BreakK, (yyvsp[-1].tinfo)); }
+#line 2035 "parser.tab.c"
+    break;
+
+  case 88: /* exp: mutable assignop exp  */
+#line 237 "parser.y"
+                                                        { (yyval.tnode) = newExpNode(AssignK, (yyvsp[-1].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 2041 "parser.tab.c"
+    break;
+
+  case 89: /* exp: mutable INC  */
+#line 238 "parser.y"
+                                                        { (yyval.tnode) = newExpNode(AssignK, (yyvsp[0].tinfo), (yyvsp[-1].tnode)); }
+#line 2047 "parser.tab.c"
+    break;
+
+  case 90: /* exp: mutable DEC  */
+#line 239 "parser.y"
+                                                        { (yyval.tnode) = newExpNode(AssignK, (yyvsp[0].tinfo), (yyvsp[-1].tnode)); }
+#line 2053 "parser.tab.c"
+    break;
+
+  case 91: /* exp: simpleExp  */
+#line 240 "parser.y"
+                                                        { (yyval.tnode) = (yyvsp[0].tnode); }
+#line 2059 "parser.tab.c"
+    break;
+
+  case 92: /* exp: error assignop exp  */
+#line 241 "parser.y"
+                                                        { (yyval.tnode) = NULL; yyerrok; }
+#line 2065 "parser.tab.c"
+    break;
+
+  case 93: /* exp: mutable assignop error  */
+#line 242 "parser.y"
+                                                        { (yyval.tnode) = NULL; yyerrok; }
+#line 2071 "parser.tab.c"
+    break;
+
+  case 94: /* exp: error INC  */
+#line 243 "parser.y"
+                                                        { (yyval.tnode) = NULL; yyerrok; }
+#line 2077 "parser.tab.c"
+    break;
+
+  case 95: /* exp: error DEC  */
+#line 244 "parser.y"
+                                                        { (yyval.tnode) = NULL; yyerrok; }
+#line 2083 "parser.tab.c"
+    break;
+
+  case 96: /* assignop: '='  */
+#line 247 "parser.y"
+                {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2089 "parser.tab.c"
+    break;
+
+  case 97: /* assignop: ADDASS  */
+#line 248 "parser.y"
+                   {(yyval.tinfo) = (yyvsp[0].tinfo);  }
+#line 2095 "parser.tab.c"
+    break;
+
+  case 98: /* assignop: SUBASS  */
+#line 249 "parser.y"
+                   {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2101 "parser.tab.c"
+    break;
+
+  case 99: /* assignop: MULASS  */
+#line 250 "parser.y"
+                   {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2107 "parser.tab.c"
+    break;
+
+  case 100: /* assignop: DIVASS  */
+#line 251 "parser.y"
+                   {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2113 "parser.tab.c"
+    break;
+
+  case 101: /* simpleExp: simpleExp OR simpleExp  */
+#line 256 "parser.y"
+                                                  { (yyval.tnode) = newExpNode(OpK, (yyvsp[-1].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 2119 "parser.tab.c"
+    break;
+
+  case 102: /* simpleExp: simpleExp AND simpleExp  */
+#line 257 "parser.y"
+                                                  { (yyval.tnode) = newExpNode(OpK, (yyvsp[-1].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 2125 "parser.tab.c"
+    break;
+
+  case 103: /* simpleExp: NOT simpleExp  */
+#line 258 "parser.y"
+                                                  { (yyval.tnode) = newExpNode(OpK, (yyvsp[-1].tinfo), (yyvsp[0].tnode)); }
+#line 2131 "parser.tab.c"
+    break;
+
+  case 104: /* simpleExp: arithExp relop arithExp  */
+#line 259 "parser.y"
+                                                  { (yyval.tnode) = newExpNode(OpK, (yyvsp[-1].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 2137 "parser.tab.c"
+    break;
+
+  case 105: /* simpleExp: arithExp  */
+#line 260 "parser.y"
+                                                  { (yyval.tnode) = (yyvsp[0].tnode); }
+#line 2143 "parser.tab.c"
+    break;
+
+  case 106: /* simpleExp: simpleExp OR error  */
+#line 261 "parser.y"
+                                                  { (yyval.tnode) = NULL; yyerrok; }
+#line 2149 "parser.tab.c"
+    break;
+
+  case 107: /* simpleExp: simpleExp AND error  */
+#line 262 "parser.y"
+                                                  { (yyval.tnode) = NULL; yyerrok; }
+#line 2155 "parser.tab.c"
+    break;
+
+  case 108: /* simpleExp: NOT error  */
+#line 263 "parser.y"
+                                                  { (yyval.tnode) = NULL; }
+#line 2161 "parser.tab.c"
+    break;
+
+  case 109: /* relop: LEQ  */
+#line 266 "parser.y"
+                 {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2167 "parser.tab.c"
+    break;
+
+  case 110: /* relop: '<'  */
+#line 267 "parser.y"
+                 {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2173 "parser.tab.c"
+    break;
+
+  case 111: /* relop: '>'  */
+#line 268 "parser.y"
+                 {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2179 "parser.tab.c"
+    break;
+
+  case 112: /* relop: GEQ  */
+#line 269 "parser.y"
+                 {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2185 "parser.tab.c"
+    break;
+
+  case 113: /* relop: EQ  */
+#line 270 "parser.y"
+                {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2191 "parser.tab.c"
+    break;
+
+  case 114: /* relop: NEQ  */
+#line 271 "parser.y"
+                 {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2197 "parser.tab.c"
+    break;
+
+  case 115: /* arithExp: arithExp minmaxop arithExp  */
+#line 277 "parser.y"
+                                                  { (yyval.tnode) = newExpNode(OpK, (yyvsp[-1].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 2203 "parser.tab.c"
+    break;
+
+  case 116: /* arithExp: arithExp sumop arithExp  */
+#line 278 "parser.y"
+                                                  { (yyval.tnode) = newExpNode(OpK, (yyvsp[-1].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 2209 "parser.tab.c"
+    break;
+
+  case 117: /* arithExp: arithExp mulop arithExp  */
+#line 279 "parser.y"
+                                                  { (yyval.tnode) = newExpNode(OpK, (yyvsp[-1].tinfo), (yyvsp[-2].tnode), (yyvsp[0].tnode)); }
+#line 2215 "parser.tab.c"
+    break;
+
+  case 118: /* arithExp: unaryop arithExp  */
+#line 280 "parser.y"
+                                                  { (yyval.tnode) = newExpNode(OpK, (yyvsp[-1].tinfo), (yyvsp[0].tnode)); }
+#line 2221 "parser.tab.c"
+    break;
+
+  case 119: /* arithExp: '(' exp ')'  */
+#line 281 "parser.y"
+                                                  { (yyval.tnode) = (yyvsp[-1].tnode); }
+#line 2227 "parser.tab.c"
+    break;
+
+  case 120: /* arithExp: call  */
+#line 282 "parser.y"
+                                                  { (yyval.tnode) = (yyvsp[0].tnode); }
+#line 2233 "parser.tab.c"
+    break;
+
+  case 121: /* arithExp: constant  */
+#line 283 "parser.y"
+                                                  { (yyval.tnode) = (yyvsp[0].tnode); }
+#line 2239 "parser.tab.c"
+    break;
+
+  case 122: /* arithExp: mutable  */
+#line 284 "parser.y"
+                                                  { (yyval.tnode) = (yyvsp[0].tnode); }
+#line 2245 "parser.tab.c"
+    break;
+
+  case 123: /* arithExp: arithExp sumop error  */
+#line 285 "parser.y"
+                                                  { (yyval.tnode) = NULL; yyerrok; }
+#line 2251 "parser.tab.c"
+    break;
+
+  case 124: /* arithExp: arithExp mulop error  */
+#line 286 "parser.y"
+                                                  { (yyval.tnode) = NULL; yyerrok; }
+#line 2257 "parser.tab.c"
+    break;
+
+  case 125: /* arithExp: unaryop error  */
+#line 287 "parser.y"
+                                                  { (yyval.tnode) = NULL; yyerrok; }
+#line 2263 "parser.tab.c"
+    break;
+
+  case 126: /* arithExp: '(' error  */
+#line 288 "parser.y"
+                                                  { (yyval.tnode) = NULL; yyerrok; }
+#line 2269 "parser.tab.c"
+    break;
+
+  case 127: /* arithExp: error '('  */
+#line 289 "parser.y"
+                                                  { (yyval.tnode) = NULL; yyerrok; }
+#line 2275 "parser.tab.c"
+    break;
+
+  case 128: /* minmaxop: MAX  */
+#line 292 "parser.y"
+                 {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2281 "parser.tab.c"
+    break;
+
+  case 129: /* minmaxop: MIN  */
+#line 293 "parser.y"
+                 {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2287 "parser.tab.c"
+    break;
+
+  case 130: /* sumop: '+'  */
+#line 296 "parser.y"
+                 {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2293 "parser.tab.c"
+    break;
+
+  case 131: /* sumop: '-'  */
+#line 297 "parser.y"
+                 {(yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2299 "parser.tab.c"
+    break;
+
+  case 132: /* mulop: '*'  */
+#line 300 "parser.y"
+                 {(yyval.tinfo) = (yyvsp[0].tinfo);}
+#line 2305 "parser.tab.c"
+    break;
+
+  case 133: /* mulop: '/'  */
+#line 301 "parser.y"
+                 {(yyval.tinfo) = (yyvsp[0].tinfo);}
+#line 2311 "parser.tab.c"
+    break;
+
+  case 134: /* mulop: '%'  */
+#line 302 "parser.y"
+                 {(yyval.tinfo) = (yyvsp[0].tinfo);}
+#line 2317 "parser.tab.c"
+    break;
+
+  case 135: /* unaryop: '-'  */
+#line 305 "parser.y"
+                                                     { (yyval.tinfo) = (yyvsp[0].tinfo); (yyval.tinfo)->tokenclass = CHSIGN; (yyval.tinfo)->tokenstr = ctx->stringPool.intern("chsign");  }
+#line 2323 "parser.tab.c"
+    break;
+
+  case 136: /* unaryop: '*'  */
+#line 306 "parser.y"
+                                                      { (yyval.tinfo) = (yyvsp[0].tinfo); (yyval.tinfo)->tokenclass = SIZEOF; (yyval.tinfo)->tokenstr = ctx->stringPool.intern("sizeof");  }
+#line 2329 "parser.tab.c"
+    break;
+
+  case 137: /* unaryop: '?'  */
+#line 307 "parser.y"
+                                                      { (yyval.tinfo) = (yyvsp[0].tinfo); }
+#line 2335 "parser.tab.c"
+    break;
+
+  case 138: /* mutable: ID  */
+#line 310 "parser.y"
+                                                      { (yyval.tnode) = newExpNode(IdK, (yyvsp[0].tinfo)); }
+#line 2341 "parser.tab.c"
+    break;
+
+  case 139: /* mutable: ID '[' exp ']'  */
+#line 311 "parser.y"
+                                                     { TreeNode* tmp = newExpNode(IdK, (yyvsp[-3].tinfo));
+                                                       tmp->isArray = true; 
+                                                       (yyval.tnode) = newExpNode(OpK, (yyvsp[-2].tinfo), tmp, (yyvsp[-1].tnode));
+                                                       (yyval.tnode)->isArray = true;
+                                                     }
+#line 2351 "parser.tab.c"
+    break;
+
+  case 140: /* call: ID '(' args ')'  */
+#line 318 "parser.y"
+                                                    { (yyval.tnode) = newExpNode(CallK, (yyvsp[-3].tinfo), (yyvsp[-1].tnode)); }
+#line 2357 "parser.tab.c"
+    break;
+
+  case 141: /* args: argList  */
+#line 321 "parser.y"
+                     {(yyval.tnode) = (yyvsp[0].tnode); }
+#line 2363 "parser.tab.c"
+    break;
+
+  case 142: /* args: %empty  */
+#line 322 "parser.y"
+                                                        { (yyval.tnode) = NULL; }
+#line 2369 "parser.tab.c"
+    break;
+
+  case 143: /* argList: argList ',' exp  */
+#line 325 "parser.y"
+                                                   { (yyval.tnode) = addSibling((yyvsp[-2].tnode), (yyvsp[0].tnode));  }
+#line 2375 "parser.tab.c"
+    break;
+
+  case 144: /* argList: exp  */
+#line 326 "parser.y"
+                 {(yyval.tnode) = (yyvsp[0].tnode); }
+#line 2381 "parser.tab.c"
+    break;
+
+  case 145: /* constant: NUMCONST  */
+#line 329 "parser.y"
+                                                        { (yyval.tnode) = newExpNode(ConstantK, (yyvsp[0].tinfo)); (yyval.tnode)->type = Integer; }
+#line 2387 "parser.tab.c"
+    break;
+
+  case 146: /* constant: CHARCONST  */
+#line 330 "parser.y"
+                                                         { (yyval.tnode) = newExpNode(ConstantK, (yyvsp[0].tinfo)); (yyval.tnode)->type = Char; }
+#line 2393 "parser.tab.c"
+    break;
+
+  case 147: /* constant: STRINGCONST  */
+#line 331 "parser.y"
+                                                         { (yyval.tnode) = newExpNode(ConstantK, (yyvsp[0].tinfo)); (yyval.tnode)->type = Char; (yyval.tnode)->isArray = true; (yyval.tnode)->size = 1 + (yyvsp[0].tinfo)->nvalue;  }
+#line 2399 "parser.tab.c"
+    break;
+
+  case 148: /* constant: BOOLCONST  */
+#line 332 "parser.y"
+                                                         { (yyval.tnode) = newExpNode(ConstantK, (yyvsp[0].tinfo)); (yyval.tnode)->type = Boolean; }
+#line 2405 "parser.tab.c"
+    break;
+
+
+#line 2409 "parser.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      {
+        yypcontext_t yyctx
+          = {yyssp, yytoken};
+        if (yyreport_syntax_error (&yyctx, scanner) == 2)
+          YYNOMEM;
+      }
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, scanner);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, scanner);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (scanner, YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, scanner);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, scanner);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 336 "parser.y"
+
+
+
+/*
+ * @brief get the next token, timing the scanner when a time report is
+ * being made. The parentheses around yylex call the scanner itself
+ * rather than the macro that sends the parser here.
+ *
+ * @return the next token class, 0 at the end of the source
+*/
+static int timedLex(YYSTYPE *lvalp, void *scanner) {
+   struct timespec before, after;
+   size_t allocs, bytes;
+   int tokenClass;
+
+   if (!ctx->timeReport.isEnabled()) {
+      return (yylex)(lvalp, scanner);
+   }
+
+   allocs = ctx->arena.allocs();
+   bytes = ctx->arena.used();
+   clock_gettime(CLOCK_MONOTONIC, &before);
+   tokenClass = (yylex)(lvalp, scanner);
+   clock_gettime(CLOCK_MONOTONIC, &after);
+   ctx->timeReport.addLex((after.tv_sec - before.tv_sec) + (after.tv_nsec - before.tv_nsec) / 1e9,
+         ctx->arena.allocs() - allocs, ctx->arena.used() - bytes);
+
+   return tokenClass;
+}
+
+/*
+ * @brief number of terminal symbols, yyerror.cpp translates the names
+ * of all of them once
+*/
+int numParserSymbols() {
+   return YYNTOKENS;
+}
+
+/*
+ * @brief Bison's own name for a symbol
+*/
+const char *parserSymbolName(int symbol) {
+   return yysymbol_name((yysymbol_kind_t)symbol);
+}
+
+/*
+ * @brief called by the parser on a syntax error instead of yyerror. It
+ * hands over the unexpected token and at most four expected tokens as
+ * symbol numbers, none when more than four would do.
+ *
+ * @return 0, the error has been reported
+*/
+static int yyreport_syntax_error(const yypcontext_t *yyctx, void *) {
+   yysymbol_kind_t expected[4];
+   int symbols[4];
+   int n = yypcontext_expected_tokens(yyctx, expected, 4);
+
+   if (n < 0) n = 0;
+   for (int i = 0; i < n; i++) symbols[i] = expected[i];
+   syntaxError(yypcontext_token(yyctx), symbols, n);
+
+   return 0;
+}
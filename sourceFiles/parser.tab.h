@@ -0,0 +1,133 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_PARSER_TAB_H_INCLUDED
+# define YY_YY_PARSER_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 1
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    FIRSTOP = 258,                 /* FIRSTOP  */
+    IF = 259,                      /* IF  */
+    THEN = 260,                    /* THEN  */
+    ELSE = 261,                    /* ELSE  */
+    FOR = 262,                     /* FOR  */
+    TO = 263,                      /* TO  */
+    BY = 264,                      /* BY  */
+    WHILE = 265,                   /* WHILE  */
+    DO = 266,                      /* DO  */
+    BREAK = 267,                   /* BREAK  */
+    ADDASS = 268,                  /* ADDASS  */
+    SUBASS = 269,                  /* SUBASS  */
+    MULASS = 270,                  /* MULASS  */
+    DIVASS = 271,                  /* DIVASS  */
+    MIN = 272,                     /* MIN  */
+    MAX = 273,                     /* MAX  */
+    ID = 274,                      /* ID  */
+    CHARCONST = 275,               /* CHARCONST  */
+    NUMCONST = 276,                /* NUMCONST  */
+    BOOLCONST = 277,               /* BOOLCONST  */
+    STRINGCONST = 278,             /* STRINGCONST  */
+    CHAR = 279,                    /* CHAR  */
+    INT = 280,                     /* INT  */
+    BOOL = 281,                    /* BOOL  */
+    STATIC = 282,                  /* STATIC  */
+    NEQ = 283,                     /* NEQ  */
+    EQ = 284,                      /* EQ  */
+    LEQ = 285,                     /* LEQ  */
+    GEQ = 286,                     /* GEQ  */
+    AND = 287,                     /* AND  */
+    OR = 288,                      /* OR  */
+    NOT = 289,                     /* NOT  */
+    INC = 290,                     /* INC  */
+    DEC = 291,                     /* DEC  */
+    PRECOMPILER = 292,             /* PRECOMPILER  */
+    ERROR = 293,                   /* ERROR  */
+    RETURN = 294,                  /* RETURN  */
+    CHSIGN = 295,                  /* CHSIGN  */
+    SIZEOF = 296,                  /* SIZEOF  */
+    LASTOP = 297,                  /* LASTOP  */
+    LASTTERM = 298                 /* LASTTERM  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 44 "parser.y"
+
+   TokenData *tinfo ;
+   TreeNode *tnode ;
+   ExpType etype;
+
+#line 113 "parser.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+
+
+int yyparse (void *scanner);
+
+/* "%code provides" blocks.  */
+#line 30 "parser.y"
+
+// The scanner (scanner.cpp) provides this
+int yylex(YYSTYPE *lvalp, void *scanner);
+
+#line 132 "parser.tab.h"
+
+#endif /* !YY_YY_PARSER_TAB_H_INCLUDED  */
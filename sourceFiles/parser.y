@@ -2,45 +2,43 @@
 /*
  * @author Lance Townsend
  *
- * @brief Performs parsing and runs the entire compilitaion process
+ * @brief Grammar for bC. The parser is pure, everything it builds goes
+ * into the compiler context of the compile running on this thread and
+ * the scanner it reads from is passed in to yyparse().
  *
 */
 
 #include <cstdio>
-#include <iostream>
-#include <unistd.h>
-#include "codegen.h"
+#include <time.h>
+#include "compilerContext.h"
 #include "yyerror.h"
 #include "scanType.h"
-#include "semantics.h"
-#include "symbolTable.h"
 #include "treeNodes.h"
 #include "treeUtils.h"
 
-using namespace std;
-
-extern "C" int yylex();
-extern "C" int yyparse();
-extern "C" FILE *yyin;
-extern "C" int tokenErrors;
-
-void printToken(TokenData myData, string tokenName, int type = 0) {
-   cout << "Line: " << myData.linenum << " Type: " << tokenName;
-   if(type==0)
-     cout << " Token: " << myData.tokenstr;
-   if(type==1)
-     cout << " Token: " << myData.nvalue;
-   if(type==2)
-     cout << " Token: " << myData.cvalue;
-   cout << endl;
+// the semantic checks and code generation walk the tree on explicit
+// stacks, so nesting is only limited by the parser's own stack which
+// grows on the heap up to this many entries
+#define YYMAXDEPTH 1000000
+
+%}
+
+%define api.pure full
+%define parse.error custom
+%param {void *scanner}
+
+%code provides {
+// The scanner (scanner.cpp) provides this
+int yylex(YYSTYPE *lvalp, void *scanner);
 }
 
-/* Abstract Syntrax Tree */
-static TreeNode* syntaxTree;
-int numErrors;
-int numWarnings;
+%code {
+// yyparse reads its tokens through timedLex so the time spent in the
+// scanner can be reported on its own (bC --time-report)
+static int timedLex(YYSTYPE *lvalp, void *scanner);
+#define yylex(lvalp, scanner) timedLex(lvalp, scanner)
+}
 
-%}
 
 %union
 {
@@ -55,10 +53,10 @@ int numWarnings;
 %type   <tnode> varDecl varDeclId scopedVarDecl varDeclList varDeclInit
 %type   <tnode> funDecl parms parmList parmTypeList parmIdList parmId
 %type   <tnode> stmt expStmt compoundStmt stmtList returnStmt breakStmt
-%type   <tnode> factor matched unmatched mutable immutable
+%type   <tnode> matched unmatched mutable
 %type   <tnode> call args argList
 %type   <tnode> iterRange
-%type   <tnode> exp simpleExp andExp unaryRelExp relExp minmaxExp sumExp mulExp unaryExp
+%type   <tnode> exp simpleExp arithExp
 %type   <tnode> constant 
 
 %token  <tinfo> FIRSTOP
@@ -83,13 +81,22 @@ int numWarnings;
 
 %token   <tinfo> LASTTERM
 
+// operator precedence for simpleExp and arithExp, lowest first
+%left    OR
+%left    AND
+%right   NOT
+%left    MAX MIN
+%left    '+' '-'
+%left    '*' '/' '%'
+%right   CHSIGN
+
 %%
 
-program    : precomList declList                    { syntaxTree = $2; }
+program    : precomList declList                    { ctx->syntaxTree = $2; }
            ;
 
-precomList : precomList PRECOMPILER                   { $$ = NULL; printf("%s\n", yylval.tinfo->tokenstr); }
-           | PRECOMPILER                                 { $$ = NULL; printf("%s\n", yylval.tinfo->tokenstr);}
+precomList : precomList PRECOMPILER                   { $$ = NULL; fprintf(ctx->out, "%s\n", yylval.tinfo->tokenstr); }
+           | PRECOMPILER                                 { $$ = NULL; fprintf(ctx->out, "%s\n", yylval.tinfo->tokenstr);}
            | /* empty */                                 {  $$ = NULL;  }
            ;
 
@@ -244,23 +251,16 @@ assignop  : '=' {$$ = $1; }
           | DIVASS {$$ = $1; }
           ;
 
-simpleExp  : simpleExp OR andExp                 {  $$ = newExpNode(OpK, $2, $1, $3);}
-           | andExp                              {$$ = $1; }
-           | simpleExp OR error                  { $$ = NULL; yyerrok; }
-           ;
-
-andExp     : andExp AND unaryRelExp              { $$ = newExpNode(OpK, $2, $1, $3); }
-           | unaryRelExp {$$ = $1; }
-           | andExp AND error                  { $$ = NULL; yyerrok; }
-           ;
-
-unaryRelExp : NOT unaryRelExp                      { $$ = newExpNode(OpK, $1, $2); }
-            | relExp {$$ = $1; }
-            | NOT error { $$ = NULL; }
-            ;
-
-relExp     : minmaxExp relop minmaxExp          { $$ = newExpNode(OpK, $2, $1, $3); }
-           | minmaxExp {$$ = $1; }
+// Boolean and relational operators. Relational operators do not chain
+// and only take arithmetic operands, and "not" binds looser than them.
+simpleExp  : simpleExp OR simpleExp               { $$ = newExpNode(OpK, $2, $1, $3); }
+           | simpleExp AND simpleExp              { $$ = newExpNode(OpK, $2, $1, $3); }
+           | NOT simpleExp                        { $$ = newExpNode(OpK, $1, $2); }
+           | arithExp relop arithExp              { $$ = newExpNode(OpK, $2, $1, $3); }
+           | arithExp                             { $$ = $1; }
+           | simpleExp OR error                   { $$ = NULL; yyerrok; }
+           | simpleExp AND error                  { $$ = NULL; yyerrok; }
+           | NOT error                            { $$ = NULL; }
            ;
 
 relop      : LEQ {$$ = $1; }
@@ -271,47 +271,42 @@ relop      : LEQ {$$ = $1; }
            | NEQ {$$ = $1; }
            ;
 
-minmaxExp  : minmaxExp minmaxop sumExp              { $$ = newExpNode(OpK, $2, $1, $3); }
-           | sumExp {$$ = $1; }
+// Arithmetic operators. The operator precedence declared above picks
+// between shifting and reducing so an operand is a single reduction
+// away from an expression instead of going through a rule per level.
+arithExp   : arithExp minmaxop arithExp %prec MAX { $$ = newExpNode(OpK, $2, $1, $3); }
+           | arithExp sumop arithExp %prec '+'    { $$ = newExpNode(OpK, $2, $1, $3); }
+           | arithExp mulop arithExp %prec '*'    { $$ = newExpNode(OpK, $2, $1, $3); }
+           | unaryop arithExp %prec CHSIGN        { $$ = newExpNode(OpK, $1, $2); }
+           | '(' exp ')'                          { $$ = $2; }
+           | call                                 { $$ = $1; }
+           | constant                             { $$ = $1; }
+           | mutable                              { $$ = $1; }
+           | arithExp sumop error                 { $$ = NULL; yyerrok; }
+           | arithExp mulop error                 { $$ = NULL; yyerrok; }
+           | unaryop error                        { $$ = NULL; yyerrok; }
+           | '(' error                            { $$ = NULL; yyerrok; }
+           | error '('                            { $$ = NULL; yyerrok; }
            ;
 
 minmaxop   : MAX {$$ = $1; }
            | MIN {$$ = $1; }
            ;
 
-sumExp     : sumExp sumop mulExp              { $$ = newExpNode(OpK, $2, $1, $3); }
-           | mulExp {$$ = $1; }
-           | sumExp sumop error               { $$ = NULL; yyerrok; }
-           ;
-
 sumop      : '+' {$$ = $1; }
            | '-' {$$ = $1; }
            ;
 
-mulExp     : mulExp mulop unaryExp           { $$ = newExpNode(OpK, $2, $1, $3); }
-           | unaryExp {$$ = $1; }
-           | mulExp mulop error               { $$ = NULL; yyerrok; }
-           ;
-
 mulop      : '*' {$$ = $1;}
            | '/' {$$ = $1;}
            | '%' {$$ = $1;}
            ;
 
-unaryExp   : unaryop unaryExp                   { $$ = newExpNode(OpK, $1, $2); }
-           | factor {$$ = $1; }
-           | unaryop error                      { $$ = NULL; yyerrok; }
-           ;
-
-unaryop    : '-'                                     { $$ = $1; $$->tokenclass = CHSIGN; $$->tokenstr = (char*)"chsign";  }
-           | '*'                                      { $$ = $1; $$->tokenclass = SIZEOF; $$->tokenstr = (char*)"sizeof";  }
+unaryop    : '-'                                     { $$ = $1; $$->tokenclass = CHSIGN; $$->tokenstr = ctx->stringPool.intern("chsign");  }
+           | '*'                                      { $$ = $1; $$->tokenclass = SIZEOF; $$->tokenstr = ctx->stringPool.intern("sizeof");  }
            | '?'                                      { $$ = $1; }
            ;
 
-factor     : immutable {$$ = $1; }
-           | mutable {$$ = $1; }
-           ;
-
 mutable    : ID                                       { $$ = newExpNode(IdK, $1); }
            | ID '[' exp ']'                          { TreeNode* tmp = newExpNode(IdK, $1);
                                                        tmp->isArray = true; 
@@ -320,13 +315,6 @@ mutable    : ID                                       { $$ = newExpNode(IdK, $1)
                                                      }
            ;
 
-immutable  : '(' exp ')'                            { $$ = $2; }
-           | call                                   { $$ = $1; }
-           | constant                               { $$ = $1; }
-           | '(' error                              { $$ = NULL; yyerrok; }
-           | error '('                              { $$ = NULL; yyerrok; }
-           ;
-
 call       : ID '(' args ')'                        { $$ = newExpNode(CallK, $1, $3); }
            ;
 
@@ -349,47 +337,62 @@ constant   : NUMCONST                                   { $$ = newExpNode(Consta
 
 
 /*
- * @brief driver code to run the compiler
+ * @brief get the next token, timing the scanner when a time report is
+ * being made. The parentheses around yylex call the scanner itself
+ * rather than the macro that sends the parser here.
+ *
+ * @return the next token class, 0 at the end of the source
 */
-int main(int argc, char **argv) {
-   int option, index;
-   char *file = NULL;
-   extern FILE *yyin;
-//   numErrors = 0, numWarnings = 0;
-   SymbolTable *symtab;
-   symtab = new SymbolTable();
-   symtab->debug(false);
-   int globalOffset;
-
-   initErrorProcessing();
-   initTokenStrings();
-
-   while ((option = getopt (argc, argv, "")) != -1)
-      switch (option)
-      {
-      default:
-         ;
-      }
-   if ( optind == argc ) yyparse();
-   for (index = optind; index < argc; index++) 
-   {
-      yyin = fopen (argv[index], "r");
-      yyparse();
-      fclose (yyin);
-   }
+static int timedLex(YYSTYPE *lvalp, void *scanner) {
+   struct timespec before, after;
+   size_t allocs, bytes;
+   int tokenClass;
 
-   if (numErrors == 0) {
-      syntaxTree = semanticAnalysis(syntaxTree, symtab, globalOffset);
-      //printTree(stdout, syntaxTree, false, false);
+   if (!ctx->timeReport.isEnabled()) {
+      return (yylex)(lvalp, scanner);
    }
 
-   if (numErrors == 0) {
-      codegen(stdout, argv[1], syntaxTree, symtab, globalOffset, false);
-   }
+   allocs = ctx->arena.allocs();
+   bytes = ctx->arena.used();
+   clock_gettime(CLOCK_MONOTONIC, &before);
+   tokenClass = (yylex)(lvalp, scanner);
+   clock_gettime(CLOCK_MONOTONIC, &after);
+   ctx->timeReport.addLex((after.tv_sec - before.tv_sec) + (after.tv_nsec - before.tv_nsec) / 1e9,
+         ctx->arena.allocs() - allocs, ctx->arena.used() - bytes);
 
-   printf("Number of warnings: %d\n", numWarnings);
-   printf("Number of errors: %d\n", numErrors + tokenErrors);
+   return tokenClass;
+}
 
-   return 0;
+/*
+ * @brief number of terminal symbols, yyerror.cpp translates the names
+ * of all of them once
+*/
+int numParserSymbols() {
+   return YYNTOKENS;
+}
+
+/*
+ * @brief Bison's own name for a symbol
+*/
+const char *parserSymbolName(int symbol) {
+   return yysymbol_name((yysymbol_kind_t)symbol);
 }
 
+/*
+ * @brief called by the parser on a syntax error instead of yyerror. It
+ * hands over the unexpected token and at most four expected tokens as
+ * symbol numbers, none when more than four would do.
+ *
+ * @return 0, the error has been reported
+*/
+static int yyreport_syntax_error(const yypcontext_t *yyctx, void *) {
+   yysymbol_kind_t expected[4];
+   int symbols[4];
+   int n = yypcontext_expected_tokens(yyctx, expected, 4);
+
+   if (n < 0) n = 0;
+   for (int i = 0; i < n; i++) symbols[i] = expected[i];
+   syntaxError(yypcontext_token(yyctx), symbols, n);
+
+   return 0;
+}
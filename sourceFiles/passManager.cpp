@@ -0,0 +1,431 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief The pass registry and the pipeline run for each compile. The
+ * compiler's own passes run in the order registerBuiltinPasses lists
+ * them, a pass added by registerPass runs just after the last pass it
+ * requires. A pass is only ever chosen along with the passes it
+ * requires. The pipeline stops before
+ * a pass when errors have been found, the code made so far is still
+ * written out.
+ *
+ */
+
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "passManager.h"
+#include "compilerContext.h"
+#include "codegen.h"
+#include "deadFunc.h"
+#include "forLoops.h"
+#include "inliner.h"
+#include "intrinsics.h"
+#include "licm.h"
+#include "irgen.h"
+#include "peephole.h"
+#include "regalloc.h"
+#include "semantics.h"
+#include "symbolTable.h"
+#include "treeUtils.h"
+
+namespace bc {
+
+static std::vector<Pass> passes;           // every pass in the order it runs
+static std::vector<std::string> added;     // names of the passes added by registerPass
+
+/*
+ * @brief index of a registered pass
+ *
+ * @param name - name of the pass
+ * @param len - length of the name
+ *
+ * @return the index, -1 if there is no pass by that name
+ */
+static int findPass(const char *name, size_t len) {
+   for (size_t i = 0; i < passes.size(); i++) {
+      if (passes[i].name.size() == len && passes[i].name.compare(0, len, name, len) == 0) {
+         return (int)i;
+      }
+   }
+
+   return -1;
+}
+
+/*
+ * @brief was a pass added by registerPass
+ */
+static bool wasAdded(const std::string &name) {
+   for (const std::string &other : added) {
+      if (other == name) {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+/*
+ * @brief add a pass to the pipeline just after the last pass it
+ * requires, and after the passes added there before it. A pass that
+ * requires none goes to the end.
+ *
+ * @param pass - the pass, every pass it requires must be registered
+ *
+ * @return false if the name is taken, a required pass is missing or
+ * a pass on the IR would run after codegen
+ */
+bool registerPass(const Pass &pass) {
+   size_t at = 0;
+
+   initTables();   // the compiler's own passes come first
+
+   if (pass.run == NULL || findPass(pass.name.c_str(), pass.name.size()) >= 0) {
+      return false;
+   }
+   for (const std::string &required : pass.dependencies) {
+      int index = findPass(required.c_str(), required.size());
+
+      if (index < 0) {
+         return false;
+      }
+      if ((size_t)index + 1 > at) {
+         at = (size_t)index + 1;
+      }
+   }
+   if (pass.dependencies.empty()) {
+      at = passes.size();
+   }
+   while (at < passes.size() && wasAdded(passes[at].name)) {
+      at++;
+   }
+
+   // codegen lowers the IR, a pass on it after that changes nothing
+   if (pass.onIr && (int)at > findPass("codegen", strlen("codegen"))) {
+      return false;
+   }
+   passes.insert(passes.begin() + at, pass);
+   added.push_back(pass.name);
+
+   return true;
+}
+
+/*
+ * @brief check the tree and fill in types, offsets and sizes
+ */
+static void runSemantic(PassUnit &unit) {
+   ctx->syntaxTree = semanticAnalysis(ctx->syntaxTree, unit.symtab, unit.globalOffset);
+}
+
+/*
+ * @brief build the IR of the annotated tree
+ */
+static void runIrgen(PassUnit &unit) {
+   irgen(ctx->syntaxTree, unit.symtab, unit.globalOffset, false, unit.ir);
+}
+
+/*
+ * @brief lower the calls to the IO library functions to IN and OUT
+ */
+static void runIntrinsics(PassUnit &unit) {
+   inlineIntrinsics(unit.ir);
+}
+
+/*
+ * @brief step and test the for loops at their bottom
+ */
+static void runForLoop(PassUnit &unit) {
+   tightenForLoops(unit.ir);
+}
+
+/*
+ * @brief move the invariant expressions out of the loops
+ */
+static void runLicm(PassUnit &unit) {
+   hoistInvariants(unit.ir);
+}
+
+/*
+ * @brief copy small functions into their callers
+ */
+static void runInline(PassUnit &unit) {
+   inlineFunctions(unit.ir);
+}
+
+/*
+ * @brief drop the functions main never calls
+ */
+static void runDeadFunc(PassUnit &unit) {
+   removeDeadFunctions(unit.ir);
+}
+
+/*
+ * @brief order the expressions of the IR for codegen to keep values in
+ * registers
+ */
+static void runRegalloc(PassUnit &unit) {
+   regalloc(unit.ir);
+}
+
+/*
+ * @brief lower the IR to TM code in ctx->emitted
+ */
+static void runCodegen(PassUnit &unit) {
+   codegen(ctx->out, unit.srcFile, unit.ir);
+}
+
+/*
+ * @brief cut redundant instructions out of the TM code
+ */
+static void runPeephole(PassUnit &) {
+   peephole();
+}
+
+/*
+ * @brief register the passes of the compiler itself. Called once by
+ * initTables.
+ *
+ * @return void
+ */
+void registerBuiltinPasses() {
+   passes.push_back(Pass{"semantic", {}, 0, runSemantic});
+   passes.push_back(Pass{"irgen", {"semantic"}, 0, runIrgen, true});
+   passes.push_back(Pass{"intrinsics", {"irgen"}, 1, runIntrinsics, true});
+   passes.push_back(Pass{"forloop", {"irgen"}, 1, runForLoop, true});
+   passes.push_back(Pass{"licm", {"irgen"}, 1, runLicm, true});
+   passes.push_back(Pass{"inline", {"irgen"}, 2, runInline, true});
+   passes.push_back(Pass{"deadfunc", {"irgen"}, 1, runDeadFunc, true});
+   passes.push_back(Pass{"regalloc", {"irgen"}, 1, runRegalloc, true});
+   passes.push_back(Pass{"codegen", {"irgen"}, 0, runCodegen});
+   passes.push_back(Pass{"peephole", {"codegen"}, 1, runPeephole});
+}
+
+/*
+ * @brief add a line to the optimization report of the compile
+ *
+ * @param pass - pass the line is about
+ * @param format - printf format of the line
+ *
+ * @return void
+ */
+void optRemark(const char *pass, const char *format, ...) {
+   char text[256];
+   va_list args;
+
+   if (!ctx->optReport) {
+      return;
+   }
+   va_start(args, format);
+   vsnprintf(text, sizeof(text), format, args);
+   va_end(args);
+
+   ctx->optRemarks.push_back(std::string(pass) + ": " + text);
+}
+
+/*
+ * @brief choose a pass and everything it requires
+ *
+ * @param index - pass to choose
+ * @param chosen - passes chosen so far, by index
+ *
+ * @return void
+ */
+static void choosePass(int index, std::vector<bool> &chosen) {
+   if (chosen[index]) {
+      return;
+   }
+   chosen[index] = true;
+   for (const std::string &required : passes[index].dependencies) {
+      choosePass(findPass(required.c_str(), required.size()), chosen);
+   }
+}
+
+/*
+ * @brief choose the passes to run from -O or --passes=
+ *
+ * @param chosen - set for each pass that will run
+ *
+ * @return false if --passes= names a pass that does not exist
+ */
+static bool choosePipeline(std::vector<bool> &chosen) {
+   const char *list = ctx->passList;
+   bool ok = true;
+
+   if (list == NULL) {
+      for (size_t i = 0; i < passes.size(); i++) {
+         if (passes[i].optLevel <= ctx->optLevel) {
+            choosePass((int)i, chosen);
+         }
+      }
+      return true;
+   }
+
+   while (*list != '\0') {
+      size_t len = strcspn(list, ",");
+
+      if (len > 0) {
+         int index = findPass(list, len);
+
+         if (index < 0) {
+            diagnose(UnknownPass, 0, {{list, len}});
+            ok = false;
+         } else {
+            choosePass(index, chosen);
+         }
+      }
+      list += (list[len] == ',') ? len + 1 : len;
+   }
+
+   return ok;
+}
+
+/*
+ * @brief count the instructions a pass works on
+ *
+ * @param unit - what the passes work on
+ * @param onIr - count the IR rather than the TM code
+ *
+ * @return number of instructions, comments left out of the IR
+ */
+static size_t countInstrs(const PassUnit &unit, bool onIr) {
+   size_t count = 0;
+
+   if (!onIr) {
+      return ctx->emitted.instrs.size();
+   }
+   for (const IrFunction &function : unit.ir.functions) {
+      for (const IrBlock &block : function.blocks) {
+         for (const IrInstr &instr : block.instrs) {
+            count += (instr.op != IrComment && instr.op != IrCommentInt);
+         }
+      }
+   }
+
+   return count;
+}
+
+/*
+ * @brief count the nodes in a tree and all its siblings
+ *
+ * @param tree - tree to count
+ *
+ * @return number of nodes
+ */
+static size_t countNodes(TreeNode *tree) {
+   std::vector<TreeNode *> stack;
+   size_t count = 0;
+
+   if (tree != NULL) {
+      stack.push_back(tree);
+   }
+   while (!stack.empty()) {
+      TreeNode *current = stack.back();
+
+      stack.pop_back();
+      count++;
+      if (current->sibling != NULL) {
+         stack.push_back(current->sibling);
+      }
+      for (int i = 0; i < MAXCHILDREN; i++) {
+         if (current->child[i] != NULL) {
+            stack.push_back(current->child[i]);
+         }
+      }
+   }
+
+   return count;
+}
+
+/*
+ * @brief monotonic clock in seconds
+ */
+static double seconds() {
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+
+   return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/*
+ * @brief run the pipeline chosen by ctx->optLevel or ctx->passList on
+ * ctx->syntaxTree and write the diagnostics to ctx->diag and the code
+ * made to ctx->out
+ *
+ * @param srcFile - name of the file compiled, for the code header
+ * @param symtab - symbol table to fill in
+ *
+ * @return void
+ */
+void runPasses(char *srcFile, SymbolTable *symtab) {
+   std::vector<bool> chosen(passes.size(), false);
+   PassUnit unit;
+   bool measure = ctx->timeReport.isEnabled();
+
+   unit.srcFile = srcFile;
+   unit.symtab = symtab;
+   unit.globalOffset = 0;
+   unit.ir.globalOffset = 0;
+   unit.ir.built = false;
+   unit.ir.registers = false;
+
+   if (ctx->printAfter != NULL && findPass(ctx->printAfter, strlen(ctx->printAfter)) < 0) {
+      diagnose(UnknownPrintAfter, 0, {ctx->printAfter});
+   }
+   if (!choosePipeline(chosen)) {
+      flushDiagnostics();
+      return;
+   }
+
+   for (size_t i = 0; i < passes.size(); i++) {
+      const Pass &pass = passes[i];
+      size_t nodesBefore = 0, instrsBefore = 0;
+      double start = 0;
+
+      if (!chosen[i]) {
+         continue;
+      }
+      if (ctx->numErrors > 0) {
+         break;
+      }
+
+      // the pass starts its own phases with startPhase
+      if (measure) {
+         nodesBefore = countNodes(ctx->syntaxTree);
+         instrsBefore = countInstrs(unit, pass.onIr);
+         start = seconds();
+      }
+      pass.run(unit);
+      if (pass.onIr) {
+         irVerify(unit.ir);
+      }
+      if (measure) {
+         double wall = seconds() - start;
+
+         ctx->timeReport.addPass(pass.name.c_str(), wall, nodesBefore, countNodes(ctx->syntaxTree),
+                                 pass.onIr, instrsBefore, countInstrs(unit, pass.onIr));
+      }
+
+      if (ctx->printAfter != NULL && pass.name == ctx->printAfter) {
+         flushDiagnostics();   // the tree goes after the messages of the pass
+         if (pass.onIr) {
+            fprintf(ctx->diag, "*** IR after %s ***\n", pass.name.c_str());
+            irDump(ctx->diag, unit.ir);
+         } else {
+            fprintf(ctx->diag, "*** tree after %s ***\n", pass.name.c_str());
+            printTree(ctx->diag, ctx->syntaxTree);
+         }
+      }
+   }
+
+   // the messages and code have only been buffered so far
+   startPhase("output");
+   flushDiagnostics();
+   if (!ctx->emitted.instrs.empty()) {
+      emitFlush(ctx->out);
+   }
+}
+
+}
@@ -0,0 +1,68 @@
+#ifndef _PASSMANAGER_H_
+#define _PASSMANAGER_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Runs the compile after the parse as a pipeline of named
+ * passes. Each pass says which passes must run before it and the
+ * lowest -O level whose pipeline includes it. -O picks the pipeline,
+ * --passes= names the passes to run instead and --print-after= dumps
+ * the tree, or the IR for a pass on the IR, after a pass. Every pass
+ * is timed and the change it made to the tree and the code is added
+ * to the time report. The optimization passes say what they did in
+ * the optimization report (--opt-report).
+ *
+ */
+
+#include <string>
+#include <vector>
+#include "ir.h"
+
+class SymbolTable;
+
+namespace bc {
+
+// What the passes of one compile work on, the tree is ctx->syntaxTree
+// and the code is ctx->emitted
+struct PassUnit {
+    char *srcFile;                         // name of the file compiled, for the code header
+    SymbolTable *symtab;                   // global symbol table
+    int globalOffset;                      // size of the global frame, set by semantic analysis
+    IrProgram ir;                          // IR built by irgen from the annotated tree
+};
+
+typedef void (*PassFunction)(PassUnit &unit);
+
+struct Pass {
+    std::string name;                      // name used by --passes= and --print-after=
+    std::vector<std::string> dependencies; // passes that must run before this one
+    int optLevel;                          // lowest -O level that runs it
+    PassFunction run;                      // does the work
+    bool onIr = false;                     // works on unit.ir, which is verified after it
+};
+
+#define MAX_OPT_LEVEL 2                    // highest -O level
+#define INLINE_LIMIT 12                    // instructions of a function always inlined, --inline-limit=
+#define MAX_INLINE_LIMIT 100000           // largest --inline-limit=
+
+// Add a pass to the pipeline. It runs just after the last pass it
+// requires, after the passes added there before it, or at the end when
+// it requires none. Its required passes must already be registered, and
+// a pass on the IR must run before codegen. Call before starting any
+// compile.
+bool registerPass(const Pass &pass);
+
+// Register the passes of the compiler itself, called by initTables
+void registerBuiltinPasses();
+
+// Run the passes chosen by the options in ctx on the parsed tree
+void runPasses(char *srcFile, SymbolTable *symtab);
+
+// Add a line, as printf would format it, to the optimization report of
+// the compile. It is only kept when ctx->optReport is set.
+void optRemark(const char *pass, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+}
+
+#endif
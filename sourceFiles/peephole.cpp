@@ -0,0 +1,471 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Peephole optimizer over the TM code in ctx->emitted. The rules
+ * are a table of instruction patterns written as they read in the
+ * listing. A window of instructions in a row matching a pattern has
+ * the instructions the rule drops removed, the window never reaches
+ * past its first instruction into one that is jumped to. The rules are
+ * applied until none matches, then the code is closed up and every pc
+ * relative instruction (the jumps and the return addresses of calls)
+ * is moved to where its target went. A target that was removed becomes
+ * the instruction after it. The comments of a removed instruction stay
+ * with the one after it.
+ *
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "peephole.h"
+#include "compilerContext.h"
+#include "passManager.h"
+
+using namespace bc;
+
+#define DEAD_WINDOW 16                 // instructions looked at to find a register is dead
+
+// What else has to hold for a rule to apply
+enum PeepCheck {
+   CheckNone,
+   CheckDistinct,                      // a and b are different registers
+   CheckDead,                          // register a is written again before it is read
+   CheckNext                           // the jump goes to the instruction after it
+};
+
+// A rule: instructions in a row matching pattern lose those marked '-'
+// in keep. A pattern instruction is "OP r,d(s)" or "OP r,s,t" with
+// alternative opcodes separated by '|'. A number only matches itself, a
+// letter matches any number but the same one everywhere in the pattern.
+struct PeepRule {
+   const char *name;                   // name in the report
+   std::vector<const char *> pattern;  // instructions in a row
+   const char *keep;                   // 'k' keeps the instruction at that place, '-' drops it
+   PeepCheck check;
+};
+
+static const PeepRule rules[] = {
+   // a value just stored is still in its register
+   {"store-load", {"ST a,x(b)", "LD a,x(b)"}, "k-", CheckNone},
+
+   // storing back what was just loaded
+   {"load-store", {"LD a,x(b)", "ST a,x(b)"}, "k-", CheckDistinct},
+
+   // the result of a call made as a statement
+   {"unused-call-result", {"LDA a,0(2)"}, "-", CheckDead},
+
+   // the standard closing of a function right after a return
+   {"return-after-return", {"JMP 7,0(a)", "LDC 2,0(6)", "LD a,-1(1)", "LD 1,0(1)", "JMP 7,0(a)"},
+    "k----", CheckNone},
+
+   {"jump-to-next", {"JMP|JZR|JNZ a,x(7)"}, "-", CheckNext},
+};
+
+#define NUM_RULES (int)(sizeof(rules) / sizeof(rules[0]))
+
+// An operand of a pattern instruction
+struct PeepOperand {
+   bool isVar;                         // a letter rather than a number
+   long long int value;                // the number, or the letter as 0 to 25
+};
+
+// A pattern instruction ready to match
+struct PeepPattern {
+   std::vector<std::string> ops;       // opcodes it matches
+   bool isRM;                          // r,d(s) form
+   PeepOperand r, s, t;
+};
+
+/*
+ * @brief read an operand of a pattern instruction
+ *
+ * @param text - the operand, left after it
+ *
+ * @return the operand
+ */
+static PeepOperand parseOperand(const char *&text) {
+   PeepOperand operand;
+   char *end;
+
+   if (*text >= 'a' && *text <= 'z') {
+      operand.isVar = true;
+      operand.value = *text++ - 'a';
+   } else {
+      operand.isVar = false;
+      operand.value = strtoll(text, &end, 10);
+      text = end;
+   }
+
+   return operand;
+}
+
+/*
+ * @brief the patterns of every rule, made the first time they are used
+ *
+ * @return the patterns of each rule, indexed as rules
+ */
+static const std::vector<std::vector<PeepPattern>> &patterns() {
+   static const std::vector<std::vector<PeepPattern>> compiled = [] {
+      std::vector<std::vector<PeepPattern>> all;
+
+      for (const PeepRule &rule : rules) {
+         std::vector<PeepPattern> instrs;
+
+         for (const char *text : rule.pattern) {
+            PeepPattern pattern;
+            size_t len = strcspn(text, " ");
+            std::string ops(text, len);
+            size_t start = 0, bar;
+
+            while ((bar = ops.find('|', start)) != std::string::npos) {
+               pattern.ops.push_back(ops.substr(start, bar - start));
+               start = bar + 1;
+            }
+            pattern.ops.push_back(ops.substr(start));
+
+            text += len + 1;
+            pattern.r = parseOperand(text);
+            text++;
+            pattern.s = parseOperand(text);
+            pattern.isRM = (*text == '(');
+            text++;
+            pattern.t = parseOperand(text);
+            instrs.push_back(pattern);
+         }
+         all.push_back(instrs);
+      }
+
+      return all;
+   }();
+
+   return compiled;
+}
+
+// How an instruction touches a register
+enum RegEffect {
+   RegNone,                            // not at all
+   RegRead,                            // reads it, maybe writes it too
+   RegWritten,                         // writes it without reading it
+   RegStop                             // control goes elsewhere
+};
+
+/*
+ * @brief how an instruction touches a register
+ *
+ * @param instr - the instruction
+ * @param reg - the register
+ *
+ * @return the effect
+ */
+static RegEffect regEffect(const EmitInstr &instr, long long int reg) {
+   static const char *alu[] = {"ADD", "SUB", "MUL", "DIV", "MOD", "AND", "OR", "XOR", "NOT", "NEG",
+                               "TLT", "TLE", "TEQ", "TNE", "TGE", "TGT", "RND", NULL};
+   static const char *reads[] = {"SWP", "SLT", "MOV", "OUT", "OUTB", "OUTC", "OUTNL", NULL};
+   const char *op = instr.op;
+
+   if (instr.isRM) {
+      if (strcmp(op, "LDC") == 0) {
+         return (instr.r == PC) ? RegStop : ((instr.r == reg) ? RegWritten : RegNone);
+      }
+      if (strcmp(op, "LD") == 0 || strcmp(op, "LDA") == 0) {
+         if (instr.r == PC) {
+            return RegStop;
+         }
+         if (instr.t == reg) {
+            return RegRead;
+         }
+         return (instr.r == reg) ? RegWritten : RegNone;
+      }
+      if (strcmp(op, "ST") == 0) {
+         return (instr.r == reg || instr.t == reg) ? RegRead : RegNone;
+      }
+      return RegStop;
+   }
+
+   if (strcmp(op, "IN") == 0 || strcmp(op, "INB") == 0 || strcmp(op, "INC") == 0) {
+      return (instr.r == reg) ? RegWritten : RegNone;
+   }
+   for (int i = 0; reads[i] != NULL; i++) {
+      if (strcmp(op, reads[i]) == 0) {
+         return (instr.r == reg || instr.s == reg || instr.t == reg) ? RegRead : RegNone;
+      }
+   }
+   for (int i = 0; alu[i] != NULL; i++) {
+      if (strcmp(op, alu[i]) == 0) {
+         if (instr.s == reg || instr.t == reg) {
+            return RegRead;
+         }
+         return (instr.r == reg) ? RegWritten : RegNone;
+      }
+   }
+
+   return RegStop;
+}
+
+// Runs the rules over the code of one compile
+class Peephole {
+private:
+   std::vector<EmitInstr> &instrs;     // code being optimized, by address
+   std::vector<bool> removed;          // instruction at each address has been removed
+   std::vector<int> live;              // addresses of the instructions left, in order
+   std::vector<bool> target;           // instruction at each address is jumped to
+   std::vector<int> hits;              // times each rule applied
+
+   bool isPcRelative(const EmitInstr &instr);
+   void findLive();
+   bool match(int rule, size_t pos, long long int vars[26]);
+   bool regDead(size_t pos, long long int reg);
+   bool jumpsToNext(size_t pos);
+   void relocate();
+
+public:
+   Peephole(std::vector<EmitInstr> &instrs) : instrs(instrs) {}
+   void run();
+};
+
+/*
+ * @brief does an instruction refer to code relative to itself
+ */
+bool Peephole::isPcRelative(const EmitInstr &instr) {
+   return instr.op != NULL && instr.isRM && instr.t == PC;
+}
+
+/*
+ * @brief list the instructions left and mark the ones jumped to, a jump
+ * to a removed instruction goes to the next one left
+ *
+ * @return void
+ */
+void Peephole::findLive() {
+   size_t size = instrs.size();
+   std::vector<int> nextLive(size + 1, (int)size);
+
+   live.clear();
+   for (size_t addr = 0; addr < size; addr++) {
+      if (instrs[addr].op != NULL && !removed[addr]) {
+         live.push_back((int)addr);
+      }
+   }
+   for (size_t addr = size; addr-- > 0;) {
+      nextLive[addr] = (instrs[addr].op != NULL && !removed[addr]) ? (int)addr : nextLive[addr + 1];
+   }
+
+   // address 0 is where a break outside any loop goes
+   target.assign(size + 1, false);
+   target[nextLive[0]] = true;
+   for (int addr : live) {
+      if (isPcRelative(instrs[addr])) {
+         long long int to = addr + 1 + instrs[addr].s;
+
+         if (to >= 0 && to <= (long long int)size) {
+            target[nextLive[to]] = true;
+         }
+      }
+   }
+}
+
+/*
+ * @brief does a rule match the instructions from a place on
+ *
+ * @param rule - rule to try
+ * @param pos - place in live of the first instruction
+ * @param vars - set to the number each letter matched
+ *
+ * @return true if it does
+ */
+bool Peephole::match(int rule, size_t pos, long long int vars[26]) {
+   const std::vector<PeepPattern> &pattern = patterns()[rule];
+   bool bound[26] = {false};
+
+   if (pos + pattern.size() > live.size()) {
+      return false;
+   }
+
+   for (size_t k = 0; k < pattern.size(); k++) {
+      const PeepPattern &want = pattern[k];
+      const EmitInstr &instr = instrs[live[pos + k]];
+      const PeepOperand *operands[3] = {&want.r, &want.s, &want.t};
+      long long int values[3] = {instr.r, instr.s, instr.t};
+      bool opMatches = false;
+
+      if (k > 0 && target[live[pos + k]]) {
+         return false;
+      }
+      for (const std::string &op : want.ops) {
+         opMatches = opMatches || op == instr.op;
+      }
+      if (!opMatches || want.isRM != instr.isRM) {
+         return false;
+      }
+
+      for (int j = 0; j < 3; j++) {
+         const PeepOperand &operand = *operands[j];
+
+         if (!operand.isVar) {
+            if (operand.value != values[j]) {
+               return false;
+            }
+         } else if (!bound[operand.value]) {
+            bound[operand.value] = true;
+            vars[operand.value] = values[j];
+         } else if (vars[operand.value] != values[j]) {
+            return false;
+         }
+      }
+   }
+
+   switch (rules[rule].check) {
+      case CheckDistinct:
+         return vars['a' - 'a'] != vars['b' - 'a'];
+
+      case CheckDead:
+         return regDead(pos + pattern.size(), vars['a' - 'a']);
+
+      case CheckNext:
+         return jumpsToNext(pos);
+
+      default:
+         return true;
+   }
+}
+
+/*
+ * @brief is a register written before it is read going on from a place
+ * without leaving the straight line code
+ *
+ * @param pos - place in live to start at
+ * @param reg - the register
+ *
+ * @return true if it is dead there
+ */
+bool Peephole::regDead(size_t pos, long long int reg) {
+   for (size_t i = pos; i < live.size() && i < pos + DEAD_WINDOW; i++) {
+      switch (regEffect(instrs[live[i]], reg)) {
+         case RegWritten:
+            return true;
+
+         case RegNone:
+            break;
+
+         default:
+            return false;
+      }
+   }
+
+   return false;
+}
+
+/*
+ * @brief does the jump at a place go to the instruction left after it
+ */
+bool Peephole::jumpsToNext(size_t pos) {
+   int addr = live[pos];
+   long long int to = addr + 1 + instrs[addr].s;
+   int next = (pos + 1 < live.size()) ? live[pos + 1] : (int)instrs.size();
+
+   return to > addr && to <= next;
+}
+
+/*
+ * @brief close up the code over the removed instructions, moving the pc
+ * relative instructions to their targets and the comments to the
+ * instruction after them
+ *
+ * @return void
+ */
+void Peephole::relocate() {
+   size_t size = instrs.size();
+   std::vector<int> newAddr(size + 1);
+   int next = 0;
+
+   for (size_t addr = 0; addr < size; addr++) {
+      newAddr[addr] = next;
+      if (!removed[addr]) {
+         next++;
+      }
+   }
+   newAddr[size] = next;
+
+   for (size_t addr = 0; addr < size; addr++) {
+      if (!removed[addr] && isPcRelative(instrs[addr])) {
+         long long int to = addr + 1 + instrs[addr].s;
+
+         if (to >= 0 && to <= (long long int)size) {
+            instrs[addr].s = newAddr[to] - (newAddr[addr] + 1);
+         }
+      }
+   }
+
+   for (size_t addr = 0; addr < size; addr++) {
+      if (!removed[addr]) {
+         instrs[newAddr[addr]] = instrs[addr];
+      }
+   }
+   instrs.resize(next);
+
+   for (EmitNote &note : ctx->emitted.notes) {
+      note.loc = newAddr[((size_t)note.loc < size) ? note.loc : size];
+   }
+   ctx->emitLoc = next;
+}
+
+/*
+ * @brief apply the rules until none matches
+ *
+ * @return void
+ */
+void Peephole::run() {
+   size_t before = instrs.size();
+   bool changed = true;
+   long long int vars[26];
+
+   removed.assign(instrs.size(), false);
+   hits.assign(NUM_RULES, 0);
+
+   while (changed) {
+      changed = false;
+      findLive();
+
+      for (size_t pos = 0; pos < live.size(); pos++) {
+         for (int rule = 0; rule < NUM_RULES; rule++) {
+            size_t len = rules[rule].pattern.size();
+
+            if (!match(rule, pos, vars)) {
+               continue;
+            }
+            for (size_t k = 0; k < len; k++) {
+               if (rules[rule].keep[k] == '-') {
+                  removed[live[pos + k]] = true;
+               }
+            }
+            hits[rule]++;
+            changed = true;
+            pos += len - 1;
+            break;
+         }
+      }
+   }
+
+   relocate();
+
+   for (int rule = 0; rule < NUM_RULES; rule++) {
+      if (hits[rule] > 0) {
+         optRemark("peephole", "%s: %d", rules[rule].name, hits[rule]);
+      }
+   }
+   optRemark("peephole", "%zu of %zu instructions removed", before - instrs.size(), before);
+}
+
+/*
+ * @brief apply the rules to ctx->emitted until none matches, the hits
+ * of each rule are added to the optimization report
+ *
+ * @return void
+ */
+void peephole() {
+   startPhase("peephole");
+
+   Peephole(ctx->emitted.instrs).run();
+}
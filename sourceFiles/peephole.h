@@ -0,0 +1,20 @@
+#ifndef _PEEPHOLE_H_
+#define _PEEPHOLE_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Peephole optimizer over the TM code left in ctx->emitted by
+ * codegen. Windows of instructions matching a rule of the rule table
+ * are cut down and the pc relative jumps are moved to the addresses
+ * their targets end up at.
+ *
+ */
+
+/*
+ * @brief apply the rules to ctx->emitted until none matches, the hits
+ * of each rule are added to the optimization report
+ */
+void peephole();
+
+#endif
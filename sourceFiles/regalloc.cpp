@@ -0,0 +1,246 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Sethi-Ullman ordering of the expressions of each block. An
+ * expression tree is a run of instructions with no side effects, each
+ * operand made just before it is used and used only once. Every node is
+ * labelled with the registers it needs: a leaf needs one, a node with
+ * two children needs the larger of theirs, or one more when they are
+ * the same. The child needing more is then evaluated first, so a tree
+ * labelled 4 or less is evaluated in AC to AC3 without a spill. The
+ * registers themselves are chosen by codegen as it lowers the IR.
+ *
+ */
+
+#include <vector>
+#include "regalloc.h"
+#include "scanType.h"
+#include "parser.tab.h"
+
+using namespace bc;
+
+// Orders the blocks of one function
+class SethiUllman {
+private:
+   std::vector<int> uses;                 // uses of each value
+   std::vector<int> defAt;                // instruction of the block defining each value, -1 for none
+   std::vector<int> label;                // registers the tree rooted at each instruction needs, 0 if none is
+   std::vector<int> first;                // first instruction of the tree rooted at each instruction
+
+   bool isPure(const IrInstr &instr);
+   int treeStart(int index, const int operands[2], int count);
+   int evalOrder(const IrInstr &instr, int operands[2]);
+   void orderTree(std::vector<IrInstr> &instrs, int root, int start);
+
+public:
+   void orderFunction(IrFunction &function);
+};
+
+/*
+ * @brief can an instruction be moved within an expression. Input and
+ * ?, which draws the next random number, have to stay in order.
+ */
+bool SethiUllman::isPure(const IrInstr &instr) {
+   switch (instr.op) {
+      case IrConst:
+      case IrString:
+      case IrLoad:
+      case IrAddr:
+      case IrBinary:
+      case IrElem:
+         return true;
+
+      case IrUnary:
+         return instr.oper != '?';
+
+      default:
+         return false;
+   }
+}
+
+/*
+ * @brief first instruction of the trees of the operands of an
+ * instruction, if they are trees laid out one after the other just
+ * before it
+ *
+ * @param index - the instruction
+ * @param operands - its operands
+ * @param count - how many
+ *
+ * @return the first instruction, -1 if the operands are not trees
+ */
+int SethiUllman::treeStart(int index, const int operands[2], int count) {
+   int end = index - 1;
+
+   for (int j = count - 1; j >= 0; j--) {
+      int at = defAt[operands[j]];
+
+      if (at < 0 || at != end || label[at] == 0 || uses[operands[j]] != 1) {
+         return -1;
+      }
+      end = first[at] - 1;
+   }
+
+   return end + 1;
+}
+
+/*
+ * @brief the operands of an instruction in the order their trees are
+ * evaluated, the one needing more registers first
+ *
+ * @param instr - the instruction
+ * @param operands - set to its operands
+ *
+ * @return how many
+ */
+int SethiUllman::evalOrder(const IrInstr &instr, int operands[2]) {
+   int count = irUses(instr, operands);
+
+   if (count == 2 && label[defAt[operands[1]]] > label[defAt[operands[0]]]) {
+      int swap = operands[0];
+
+      operands[0] = operands[1];
+      operands[1] = swap;
+   }
+
+   return count;
+}
+
+/*
+ * @brief reorder the operand trees of an instruction, which are the
+ * instructions from start up to it
+ *
+ * @param instrs - instructions of the block
+ * @param root - the instruction
+ * @param start - first instruction of its operand trees
+ *
+ * @return void
+ */
+void SethiUllman::orderTree(std::vector<IrInstr> &instrs, int root, int start) {
+   // an instruction is emitted once its operands have been
+   struct Visit {
+      int index;
+      bool expanded;
+   };
+   std::vector<Visit> stack;
+   std::vector<IrInstr> ordered;
+   int operands[2], count;
+
+   count = evalOrder(instrs[root], operands);
+   for (int j = count - 1; j >= 0; j--) {
+      stack.push_back(Visit{defAt[operands[j]], false});
+   }
+
+   while (!stack.empty()) {
+      Visit visit = stack.back();
+
+      stack.pop_back();
+      if (visit.expanded) {
+         ordered.push_back(instrs[visit.index]);
+         continue;
+      }
+      stack.push_back(Visit{visit.index, true});
+      count = evalOrder(instrs[visit.index], operands);
+      for (int j = count - 1; j >= 0; j--) {
+         stack.push_back(Visit{defAt[operands[j]], false});
+      }
+   }
+
+   for (size_t i = 0; i < ordered.size(); i++) {
+      instrs[start + i] = ordered[i];
+   }
+}
+
+/*
+ * @brief order the expression trees of each block of a function
+ *
+ * @param function - function to order
+ *
+ * @return void
+ */
+void SethiUllman::orderFunction(IrFunction &function) {
+   int operands[2], count;
+
+   uses.assign(function.numValues, 0);
+   defAt.assign(function.numValues, -1);
+   for (const IrBlock &block : function.blocks) {
+      for (const IrInstr &instr : block.instrs) {
+         count = irUses(instr, operands);
+         for (int j = 0; j < count; j++) {
+            uses[operands[j]]++;
+         }
+      }
+   }
+
+   for (IrBlock &block : function.blocks) {
+      std::vector<IrInstr> &instrs = block.instrs;
+      int size = (int)instrs.size();
+
+      label.assign(size, 0);
+      first.assign(size, -1);
+
+      // label the trees
+      for (int i = 0; i < size; i++) {
+         const IrInstr &instr = instrs[i];
+
+         if (instr.dst >= 0) {
+            defAt[instr.dst] = i;
+         }
+         if (!isPure(instr)) {
+            continue;
+         }
+         count = irUses(instr, operands);
+         first[i] = treeStart(i, operands, count);
+         if (first[i] < 0) {
+            continue;
+         }
+
+         if (count == 0) {
+            label[i] = 1;
+         } else if (count == 1) {
+            // NOT needs a register for the 1
+            label[i] = (instr.oper == NOT && label[i - 1] < 2) ? 2 : label[i - 1];
+         } else {
+            int left = label[defAt[operands[0]]], right = label[defAt[operands[1]]];
+
+            label[i] = (left == right) ? left + 1 : ((left > right) ? left : right);
+         }
+      }
+
+      // the last instruction using a tree is its root, the trees inside
+      // it are ordered along with it
+      for (int i = size - 1; i >= 0; i--) {
+         int start;
+
+         count = irUses(instrs[i], operands);
+         if (count == 0 || (start = treeStart(i, operands, count)) < 0) {
+            continue;
+         }
+         orderTree(instrs, i, start);
+         i = start;
+      }
+
+      for (const IrInstr &instr : instrs) {
+         if (instr.dst >= 0) {
+            defAt[instr.dst] = -1;
+         }
+      }
+   }
+}
+
+/*
+ * @brief order the expression trees of every block by the registers
+ * they need and have codegen keep values in registers
+ *
+ * @param program - IR to order
+ *
+ * @return void
+ */
+void regalloc(IrProgram &program) {
+   SethiUllman order;
+
+   for (IrFunction &function : program.functions) {
+      order.orderFunction(function);
+   }
+   program.registers = true;
+}
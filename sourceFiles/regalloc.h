@@ -0,0 +1,20 @@
+#ifndef _REGALLOC_H_
+#define _REGALLOC_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Orders the expressions of the IR for codegen to evaluate in
+ * the registers AC to AC3 instead of on the temporaries.
+ *
+ */
+
+#include "ir.h"
+
+/*
+ * @brief order the expression trees of every block by the registers
+ * they need and have codegen keep values in registers
+ */
+void regalloc(bc::IrProgram &program);
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Builds the token records the scanner (scanner.cpp) hands to
+ * the parser.
+ *
+*/
+
+#include <limits.h>
+#include "compilerContext.h"
+#include "scanType.h"
+#include "treeNodes.h"
+#include "parser.tab.h"
+
+/*
+ * @brief atoi for text that is not null terminated
+ *
+ * @param s - text starting with an optional sign and digits
+ * @param len - number of chars that may be looked at
+ *
+ * @return value of the leading number, 0 if there is none
+*/
+static int lexemeToInt(const char *s, int len) {
+    long value = 0;
+    bool negative = false;
+    int i = 0;
+
+    if (i < len && (s[i] == '-' || s[i] == '+')) {
+        negative = (s[i] == '-');
+        i++;
+    }
+    for (; i < len && s[i] >= '0' && s[i] <= '9'; i++) {
+        if (value > (LONG_MAX - (s[i] - '0')) / 10) {
+            value = LONG_MAX;     // clamp like strtol does
+            continue;
+        }
+        value = value * 10 + (s[i] - '0');
+    }
+
+    return (int)(negative ? -value : value);
+}
+/*
+ * @brief initialize the value of the TokenData node. The record lives
+ * in the compile arena, its lexeme is a view into the source buffer
+ * and its strings are interned in the string pool.
+ *
+ * @param tinfo - set to the new record, the scanner passes &yylval->tinfo
+ * @param tokenClass - which type of terminal was found, ex. a '+' or a 'char'
+ * @param svalue - the token's text in the source buffer, it need not be
+ *                 null terminated
+ * @param len - number of chars in the token's text
+ *
+ * @return tokenClass value
+*/
+int setValue(TokenData **tinfo, int tokenClass, char *svalue, int len) {
+    TokenData *token = ctx->arena.make<TokenData>();
+
+    *tinfo = token;
+
+    token->tokenclass = tokenClass;
+    token->linenum = ctx->line;
+    token->lexeme = std::string_view(svalue, len);
+    token->cvalue = svalue[0];
+    token->nvalue = lexemeToInt(svalue, len);
+    token->svalue = ctx->stringPool.intern(svalue, len);
+
+    token->tokenstr = ctx->lastToken = token->svalue;
+
+    switch (tokenClass) {
+
+    case NUMCONST:
+         token->nvalue = lexemeToInt(svalue, len);
+         break;
+
+    case '\\' || '*' || '+' || '-' || '=' || 
+            ';' || '(' || ')' || '{' || '}' 
+            || '<' || '>' || ',' || ':' || 
+            '?' || '%' || '[' || ']' || '/':
+         token->cvalue = svalue[0];
+         // token->nvalue = 1;
+         break;
+    case BOOLCONST:
+         if (token->cvalue == 't') {
+            token->nvalue = 1;
+         } else {
+            token->nvalue = 0;
+         }
+         
+         break;
+
+    case STRINGCONST:
+         token->nvalue = len-2;
+         token->tokenstr = ctx->stringPool.intern(&svalue[1], token->nvalue);
+         break;
+
+    case CHARCONST:
+         token->cvalue = svalue[1];
+         token->nvalue = 1;
+         if (svalue[1] == '\\') {
+            if (svalue[2] == 'n') token->cvalue ='\n';
+            else if (svalue[2] == '0') token->cvalue = '\0';
+         }
+    }
+
+    return tokenClass;
+}
@@ -1,5 +1,6 @@
 #ifndef _SCANTYPE_H_
 #define _SCANTYPE_H_
+#include <string_view>
 //
 //  SCANNER TOKENDATA
 //
@@ -8,10 +9,15 @@ struct TokenData
 {
     int  tokenclass;        // token class
     int  linenum;           // line where found
+    std::string_view lexeme; // the token's text viewed in place in the source buffer
     char *tokenstr;         // what string was read (pointer)
     char cvalue;            // any character value
     int  nvalue;            // any numeric value or Boolean value
     char *svalue;           // any string value e.g. an id (pointer)
 
 };
+
+// Make the record for a token of len chars at svalue and return tokenClass
+int setValue(TokenData **tinfo, int tokenClass, char *svalue, int len);
+
 #endif
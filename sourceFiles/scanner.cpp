@@ -0,0 +1,457 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Hand written scanner of bC. It replaced the flex scanner the
+ * compiler was first built with and makes exactly the tokens, line
+ * numbers and token errors that one made.
+ *
+ * Whitespace, comments and identifier runs are scanned a block of
+ * bytes at a time with SSE2 (16 bytes) or AVX2 (32 bytes, when built
+ * with -mavx2) compares. Keywords are found with a perfect hash that
+ * is built and checked at compile time.
+ *
+ * The scanner is reentrant, all of its state is in the Scanner made by
+ * scannerBegin() and handed to the pure parser.
+ *
+*/
+
+#include <stdio.h>
+#include <string.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "compilerContext.h"
+#include "source.h"
+#include "scanType.h"
+#include "treeNodes.h"
+
+#include "parser.tab.h" // This has to be the last include
+
+struct Scanner {
+   char *bufferStart;   // first byte of the source being scanned
+   char *cursor;        // next byte to scan
+   char *limit;         // one past the last byte of source
+};
+
+// // // // // // // // // // // // // // // // // // // //
+//
+// Block operations. A block is BLOCK_SIZE bytes of source and a
+// mask has one bit per byte of a block.
+//
+
+#if defined(__AVX2__)
+
+#define BLOCK_SIZE 32
+typedef __m256i Block;
+typedef unsigned int Mask;
+
+static inline Block loadBlock(const char *p) { return _mm256_loadu_si256((const __m256i *)p); }
+static inline Block splat(char c) { return _mm256_set1_epi8(c); }
+static inline Block equalTo(Block b, char c) { return _mm256_cmpeq_epi8(b, splat(c)); }
+static inline Block either(Block a, Block b) { return _mm256_or_si256(a, b); }
+static inline Block addBytes(Block a, Block b) { return _mm256_add_epi8(a, b); }
+static inline Block lessThan(Block a, Block b) { return _mm256_cmpgt_epi8(b, a); }
+static inline Mask toMask(Block b) { return (Mask)_mm256_movemask_epi8(b); }
+
+#elif defined(__SSE2__)
+
+#define BLOCK_SIZE 16
+typedef __m128i Block;
+typedef unsigned int Mask;
+
+static inline Block loadBlock(const char *p) { return _mm_loadu_si128((const __m128i *)p); }
+static inline Block splat(char c) { return _mm_set1_epi8(c); }
+static inline Block equalTo(Block b, char c) { return _mm_cmpeq_epi8(b, splat(c)); }
+static inline Block either(Block a, Block b) { return _mm_or_si128(a, b); }
+static inline Block addBytes(Block a, Block b) { return _mm_add_epi8(a, b); }
+static inline Block lessThan(Block a, Block b) { return _mm_cmplt_epi8(a, b); }
+static inline Mask toMask(Block b) { return (Mask)_mm_movemask_epi8(b); }
+
+#endif
+
+#ifdef BLOCK_SIZE
+
+#define FULL_MASK ((Mask)((BLOCK_SIZE == 32) ? 0xffffffffu : ((1u << BLOCK_SIZE) - 1)))
+
+// bytes of b in the range lo..hi. Adding 0x80-lo moves lo to -128 so
+// a single signed compare checks both ends of the range.
+static inline Block inRange(Block b, char lo, char hi) {
+   return lessThan(addBytes(b, splat((char)(0x80 - lo))), splat((char)(-128 + (hi - lo + 1))));
+}
+
+// bytes of b that can be part of an identifier: [a-zA-Z0-9_]
+static inline Mask identMask(Block b) {
+   Block letters = either(inRange(b, 'a', 'z'), inRange(b, 'A', 'Z'));
+   return toMask(either(either(letters, inRange(b, '0', '9')), equalTo(b, '_')));
+}
+
+#endif
+
+static inline bool isLetter(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+static inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+static inline bool isIdent(char c) { return isLetter(c) || isDigit(c) || c == '_'; }
+
+/*
+ * @brief skip spaces, tabs and newlines counting the newlines
+ *
+ * @param sc - the scanner
+ *
+ * @return void
+ */
+static void skipWhitespace(Scanner *sc) {
+#ifdef BLOCK_SIZE
+   while (sc->cursor + BLOCK_SIZE <= sc->limit) {
+      Block b = loadBlock(sc->cursor);
+      Mask newlines = toMask(equalTo(b, '\n'));
+      Mask space = toMask(either(equalTo(b, ' '), equalTo(b, '\t'))) | newlines;
+      Mask rest = ~space & FULL_MASK;
+
+      if (rest == 0) {
+         ctx->line += __builtin_popcount(newlines);
+         sc->cursor += BLOCK_SIZE;
+         continue;
+      }
+
+      int skip = __builtin_ctz(rest);
+      ctx->line += __builtin_popcount(newlines & ((1u << skip) - 1));
+      sc->cursor += skip;
+      return;
+   }
+#endif
+
+   while (sc->cursor < sc->limit && (*sc->cursor == ' ' || *sc->cursor == '\t' || *sc->cursor == '\n')) {
+      if (*sc->cursor == '\n') {
+         ctx->line++;
+      }
+      sc->cursor++;
+   }
+}
+
+/*
+ * @brief move to the newline ending the current line (or the end of
+ * the source) without passing it
+ *
+ * @param sc - the scanner
+ * @param p - where to start looking
+ *
+ * @return the newline or limit
+ */
+static char *findNewline(Scanner *sc, char *p) {
+#ifdef BLOCK_SIZE
+   while (p + BLOCK_SIZE <= sc->limit) {
+      Mask newlines = toMask(equalTo(loadBlock(p), '\n'));
+
+      if (newlines != 0) {
+         return p + __builtin_ctz(newlines);
+      }
+      p += BLOCK_SIZE;
+   }
+#endif
+
+   while (p < sc->limit && *p != '\n') {
+      p++;
+   }
+
+   return p;
+}
+
+/*
+ * @brief find the end of a run of identifier characters
+ *
+ * @param sc - the scanner
+ * @param p - where to start looking
+ *
+ * @return first byte that is not [a-zA-Z0-9_]
+ */
+static char *findIdentEnd(Scanner *sc, char *p) {
+#ifdef BLOCK_SIZE
+   while (p + BLOCK_SIZE <= sc->limit) {
+      Mask rest = ~identMask(loadBlock(p)) & FULL_MASK;
+
+      if (rest != 0) {
+         return p + __builtin_ctz(rest);
+      }
+      p += BLOCK_SIZE;
+   }
+#endif
+
+   while (p < sc->limit && isIdent(*p)) {
+      p++;
+   }
+
+   return p;
+}
+
+// // // // // // // // // // // // // // // // // // // //
+//
+// Keywords. Every keyword is at least two characters long so the hash
+// uses the first two characters and the length. The multipliers were
+// picked so that no two keywords share a slot, which is checked by the
+// static_assert below when the table is built.
+//
+
+#define KEYWORD_SLOTS 32
+#define KEYWORD_MUL0 7
+#define KEYWORD_MUL1 2
+
+struct Keyword {
+   const char *text;
+   int len;
+   int token;
+};
+
+static constexpr Keyword keywords[] = {
+   {"and", 3, AND}, {"or", 2, OR}, {"if", 2, IF}, {"else", 4, ELSE},
+   {"break", 5, BREAK}, {"by", 2, BY}, {"do", 2, DO}, {"to", 2, TO},
+   {"while", 5, WHILE}, {"for", 3, FOR}, {"then", 4, THEN},
+   {"return", 6, RETURN}, {"not", 3, NOT}, {"char", 4, CHAR},
+   {"int", 3, INT}, {"static", 6, STATIC}, {"bool", 4, BOOL},
+   {"true", 4, BOOLCONST}, {"false", 5, BOOLCONST},
+};
+
+static constexpr int NUM_KEYWORDS = sizeof(keywords) / sizeof(keywords[0]);
+
+static constexpr int keywordHash(const char *s, int len) {
+   return ((unsigned char)s[0] * KEYWORD_MUL0 + (unsigned char)s[1] * KEYWORD_MUL1 + len) % KEYWORD_SLOTS;
+}
+
+struct KeywordTable {
+   int slot[KEYWORD_SLOTS];   // index into keywords or -1
+   bool perfect;              // no two keywords hash to the same slot
+
+   constexpr KeywordTable() : slot(), perfect(true) {
+      for (int i = 0; i < KEYWORD_SLOTS; i++) {
+         slot[i] = -1;
+      }
+      for (int i = 0; i < NUM_KEYWORDS; i++) {
+         int h = keywordHash(keywords[i].text, keywords[i].len);
+         if (slot[h] != -1) {
+            perfect = false;
+         }
+         slot[h] = i;
+      }
+   }
+};
+
+static constexpr KeywordTable keywordTable;
+static_assert(keywordTable.perfect, "keyword hash has a collision, pick new multipliers");
+
+/*
+ * @brief token class for an identifier shaped word
+ *
+ * @param s - first char of the word
+ * @param len - length of the word
+ *
+ * @return keyword token or ID
+ */
+static int wordToken(const char *s, int len) {
+   if (len < 2 || len > 6) {
+      return ID;
+   }
+
+   int index = keywordTable.slot[keywordHash(s, len)];
+   if (index >= 0 && keywords[index].len == len && memcmp(keywords[index].text, s, len) == 0) {
+      return keywords[index].token;
+   }
+
+   return ID;
+}
+
+// // // // // // // // // // // // // // // // // // // //
+//
+// Scanner
+//
+
+/*
+ * @brief build the token of len chars at the cursor and move past it
+ */
+static int token(Scanner *sc, YYSTYPE *lvalp, int tokenClass, int len) {
+   char *text = sc->cursor;
+
+   sc->cursor += len;
+   return setValue(&lvalp->tinfo, tokenClass, text, len);
+}
+
+/*
+ * @brief length of a string constant at the cursor, 0 if it is not
+ * closed on this line (matches ["](\\[^\n]|[^\"\n\\])*["])
+ */
+static int stringLength(Scanner *sc) {
+   char *p = sc->cursor + 1;
+
+   while (p < sc->limit) {
+      if (*p == '"') {
+         return (int)(p + 1 - sc->cursor);
+      } else if (*p == '\\') {
+         if (p + 1 >= sc->limit || p[1] == '\n') {
+            return 0;
+         }
+         p += 2;
+      } else if (*p == '\n') {
+         return 0;
+      } else {
+         p++;
+      }
+   }
+
+   return 0;
+}
+
+/*
+ * @brief length of a character constant at the cursor, 0 if there is
+ * none (matches \'\\?.\', preferring the longer match)
+ */
+static int charLength(Scanner *sc) {
+   if (sc->cursor + 3 < sc->limit && sc->cursor[1] == '\\' && sc->cursor[2] != '\n' && sc->cursor[3] == '\'') {
+      return 4;
+   }
+   if (sc->cursor + 2 < sc->limit && sc->cursor[1] != '\n' && sc->cursor[2] == '\'') {
+      return 3;
+   }
+
+   return 0;
+}
+
+/*
+ * @brief does the text at the cursor start with s
+ */
+static inline bool startsWith(Scanner *sc, const char *s, int len) {
+   return sc->cursor + len <= sc->limit && memcmp(sc->cursor, s, len) == 0;
+}
+
+/*
+ * @brief the scanner called by the bison parser
+ *
+ * @param lvalp - where the token record is left for the parser
+ * @param scanner - scanner made by scannerBegin
+ *
+ * @return the next token class, 0 at the end of the source
+ */
+int yylex(YYSTYPE *lvalp, void *scanner) {
+   Scanner *sc = (Scanner *)scanner;
+
+   for (;;) {
+      skipWhitespace(sc);
+      if (sc->cursor >= sc->limit) {
+         return 0;
+      }
+
+      char c = *sc->cursor;
+
+      if (isLetter(c)) {
+         int len = (int)(findIdentEnd(sc, sc->cursor + 1) - sc->cursor);
+         return token(sc, lvalp, wordToken(sc->cursor, len), len);
+      }
+
+      if (isDigit(c)) {
+         char *end = sc->cursor + 1;
+         while (end < sc->limit && isDigit(*end)) {
+            end++;
+         }
+         return token(sc, lvalp, NUMCONST, (int)(end - sc->cursor));
+      }
+
+      switch (c) {
+         case '/':
+            if (startsWith(sc, "//", 2)) {
+               sc->cursor = findNewline(sc, sc->cursor + 2);
+               continue;
+            }
+            if (startsWith(sc, "/=", 2)) return token(sc, lvalp, DIVASS, 2);
+            return token(sc, lvalp, '/', 1);
+
+         case '#':
+            // precompiler lines only count at the start of a line
+            if ((sc->cursor == sc->bufferStart || sc->cursor[-1] == '\n') &&
+                  (startsWith(sc, "#DRBC ", 6) || startsWith(sc, "#DRBCRUN ", 9))) {
+               return token(sc, lvalp, PRECOMPILER, (int)(findNewline(sc, sc->cursor) - sc->cursor));
+            }
+            break;
+
+         case '\'': {
+            int len = charLength(sc);
+            if (len) return token(sc, lvalp, CHARCONST, len);
+            break;
+         }
+
+         case '"': {
+            int len = stringLength(sc);
+            if (len) return token(sc, lvalp, STRINGCONST, len);
+            break;
+         }
+
+         case ':':
+            if (startsWith(sc, ":>:", 3)) return token(sc, lvalp, MAX, 3);
+            if (startsWith(sc, ":<:", 3)) return token(sc, lvalp, MIN, 3);
+            return token(sc, lvalp, ':', 1);
+
+         case '!':
+            if (startsWith(sc, "!=", 2)) return token(sc, lvalp, NEQ, 2);
+            break;
+
+         case '=':
+            if (startsWith(sc, "==", 2)) return token(sc, lvalp, EQ, 2);
+            return token(sc, lvalp, '=', 1);
+
+         case '<':
+            if (startsWith(sc, "<=", 2)) return token(sc, lvalp, LEQ, 2);
+            return token(sc, lvalp, '<', 1);
+
+         case '>':
+            if (startsWith(sc, ">=", 2)) return token(sc, lvalp, GEQ, 2);
+            return token(sc, lvalp, '>', 1);
+
+         case '-':
+            if (startsWith(sc, "--", 2)) return token(sc, lvalp, DEC, 2);
+            if (startsWith(sc, "-=", 2)) return token(sc, lvalp, SUBASS, 2);
+            return token(sc, lvalp, '-', 1);
+
+         case '+':
+            if (startsWith(sc, "++", 2)) return token(sc, lvalp, INC, 2);
+            if (startsWith(sc, "+=", 2)) return token(sc, lvalp, ADDASS, 2);
+            return token(sc, lvalp, '+', 1);
+
+         case '*':
+            if (startsWith(sc, "*=", 2)) return token(sc, lvalp, MULASS, 2);
+            return token(sc, lvalp, '*', 1);
+
+         case ';': case '{': case '}': case '(': case ')': case ',':
+         case '?': case '%': case '\\': case '[': case ']':
+            return token(sc, lvalp, c, 1);
+
+         default:
+            break;
+      }
+
+      bc::diagnose(bc::BadCharacter, ctx->line, {c});
+      sc->cursor++;
+   }
+}
+
+/*
+ * @brief make a scanner that scans the source buffer in place
+ *
+ * @param src - source to scan, must stay alive while its tokens are used
+ *
+ * @return the scanner to hand to yyparse()
+ */
+void *scannerBegin(SourceBuffer *src) {
+   Scanner *sc = new Scanner;
+
+   sc->bufferStart = src->base;
+   sc->cursor = src->base;
+   sc->limit = src->base + src->size;
+
+   return sc;
+}
+
+/*
+ * @brief free a scanner made by scannerBegin, the source is not touched
+ *
+ * @return void
+ */
+void scannerEnd(void *scanner) {
+   delete (Scanner *)scanner;
+}
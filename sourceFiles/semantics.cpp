@@ -7,31 +7,124 @@
  */
 
 #include <string.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
 #include "treeNodes.h"
 #include "treeUtils.h"
+#include "compilerContext.h"
 #include "symbolTable.h"
 #include "parser.tab.h"
 
-static int goffset = 0;
-static int foffset = 0;
-static int varCounter = 0;
-static int newScope = 0;
-static bool foundReturn = false;
-static TreeNode *funcInside = NULL; // store which function the children are currently inside
+// offsets, counters and the function being checked are kept in the
+// compiler context (ctx->goffset, ctx->funcInside, ...)
+
+// Changes a function body makes to a global while it is being checked
+// on its own thread.  They are made when the results are merged so the
+// order of the warnings they cause does not depend on the threads.
+enum NoteKind {NoteAssigned, NoteUninitialized};
+
+struct SemanticNote {
+   size_t at;                             // number of diagnostics of the item before it happened
+   NoteKind kind;                         // what happened
+   TreeNode *decl;                        // global it happened to
+   int lineno;                            // line of the use for NoteUninitialized
+};
+
+// A top level declaration checked on its own.  The global declarations
+// and function headers are checked in order first, then the function
+// bodies are checked on a pool of threads and the items are merged back
+// in source order.
+struct SemanticItem {
+   TreeNode *decl;                        // the declaration
+   size_t numGlobals;                     // globals its body can see
+   int goffset;                           // global offset it started at when checked
+   int gsize;                             // global space taken by it, its statics and strings
+   int numErrors;                         // errors found in the body
+   int numWarnings;                       // warnings found in the body
+   bc::Diagnostics diagnostics;           // messages in the order they were made
+   std::vector<SemanticNote> notes;       // changes to globals in the order they were made
+   std::vector<TreeNode *> used;          // globals it used
+   std::vector<TreeNode *> relocations;   // nodes with a global offset, in the order they got it
+   std::vector<TreeNode *> statics;       // static locals still to be given a global name
+};
+
+// A node being checked.  Nodes are checked on an explicit stack of
+// these rather than by recursion so deep nesting cannot run the thread
+// out of stack.  Each step does the work of the node up to its next
+// child.
+struct Visit {
+   TreeNode *node;                        // node being checked
+   int step;                              // how far its check has got
+   bool chain;                            // check its siblings after it
+   bool done;                             // its check is finished
+   bool scoped;                           // it entered a scope of its own
+   int remOffset;                         // frame offset to put back when it leaves its scope
+   TreeNode *decl;                        // declaration an IdK refers to
+};
 
-extern int numErrors;
-extern int numWarnings;
 extern char *largerTokens[LASTTERM+1];
 
+// What an operator expects of its operands and the type it gives back
+struct OpSignature {
+   ExpectType expect;
+   ReturnType ret;
+};
+
+struct OpTable {
+   OpSignature sig[LASTTERM+1];           // indexed by token number
+};
+
+/*
+ * @brief build the operator signatures, run by the compiler. Tokens
+ * not listed, including not, are unchecked and have the type of their
+ * lhs.
+ *
+ * @return the table
+ */
+static constexpr OpTable makeOpTable() {
+   OpTable table = {};
+   const int intInt[] = {'+', '-', '*', '/', '%', MIN, MAX, ADDASS, SUBASS, MULASS, DIVASS};
+   const int equal[] = {EQ, NEQ, '<', LEQ, '>', GEQ};
+
+   for (int op = 0; op <= LASTTERM; op++) {
+      table.sig[op] = {NoCheck, RetLHS};
+   }
+   for (int op : intInt) {
+      table.sig[op] = {IntInt, RetLHS};
+   }
+   for (int op : equal) {
+      table.sig[op] = {Equal, RetBool};
+   }
+   table.sig['='] = {Equal, RetLHS};      // an assignment has the type of its lhs
+   table.sig[AND] = {BoolBool, RetLHS};
+   table.sig[OR] = {BoolBool, RetLHS};
+   table.sig['?'] = {OneInt, RetLHS};
+   table.sig[CHSIGN] = {OneInt, RetLHS};
+   table.sig[INC] = {OneInt, RetLHS};
+   table.sig[DEC] = {OneInt, RetLHS};
+   table.sig[SIZEOF] = {OneArray, RetInt};
+   table.sig['['] = {ArrayInt, RetLHS};
+
+   return table;
+}
+
+static constexpr OpTable opTable = makeOpTable();
+
 void treeTraverse(TreeNode *current, SymbolTable *symtab);
 TreeNode *loadIOLib(TreeNode *syntree);
 bool insertError(TreeNode *current, SymbolTable *symtab);
-void treeStmtTraverse(TreeNode *current, SymbolTable *symtab);
-void treeExpTraverse(TreeNode *current, SymbolTable *symtab);
-void treeDeclTraverse(TreeNode *current, SymbolTable *symtab);
-void treeTraverse(TreeNode *current, SymbolTable *symtab);
 TreeNode *semanticAnalysis(TreeNode *syntree, SymbolTable *symtabX, int &globalOffset);
 void checkIsUsed(std::string str, void *node);
+TreeNode *resolve(TreeNode *use, SymbolTable *symtab);
+void markUsed(TreeNode *decl);
+void markAssigned(TreeNode *decl);
+void checkInitialized(TreeNode *use, TreeNode *decl);
+void warnUninitialized(int lineno, TreeNode *decl);
+void nameStatic(TreeNode *current, SymbolTable *symtab);
+void declareFunction(TreeNode *current, SymbolTable *symtab);
+void checkFunction(TreeNode *current, SymbolTable *symtab);
 
 /*
  * @brief load IO libraries and link them to syntax tree
@@ -46,55 +139,55 @@ TreeNode *loadIOLib(TreeNode *syntree) {
 
    input = newDeclNode(FuncK, Integer);
    input->lineno = -1;
-   input->attr.name = strdup("input");
+   input->attr.name = ctx->stringPool.intern("input");
    input->type = Integer;
 
    inputb = newDeclNode(FuncK, Boolean);
    inputb->lineno = -1;
-   inputb->attr.name = strdup("inputb");
+   inputb->attr.name = ctx->stringPool.intern("inputb");
    inputb->type = Boolean;
 
    inputc = newDeclNode(FuncK, Boolean);
    inputc->lineno = -1;
-   inputc->attr.name = strdup("inputc");
+   inputc->attr.name = ctx->stringPool.intern("inputc");
    inputc->type = Char;
 
    paramOutput = newDeclNode(ParamK, Void);
    paramOutput->lineno = -1;
-   paramOutput->attr.name = strdup("*dummy*");
+   paramOutput->attr.name = ctx->stringPool.intern("*dummy*");
    paramOutput->type = Integer;
 
    output = newDeclNode(FuncK, Void);
    output->lineno = -1;
-   output->attr.name = strdup("output");
+   output->attr.name = ctx->stringPool.intern("output");
    output->type = Void;
    output->child[0] = paramOutput;
 
    paramOutputb = newDeclNode(ParamK, Void);
    paramOutputb->lineno = -1;
-   paramOutputb->attr.name = strdup("*dummy*");
+   paramOutputb->attr.name = ctx->stringPool.intern("*dummy*");
    paramOutputb->type = Boolean;
 
    outputb = newDeclNode(FuncK, Void);
    outputb->lineno = -1;
-   outputb->attr.name = strdup("outputb");
+   outputb->attr.name = ctx->stringPool.intern("outputb");
    outputb->type = Void;
    outputb->child[0] = paramOutputb;
 
    paramOutputc = newDeclNode(ParamK, Void);
    paramOutputc->lineno = -1;
-   paramOutputc->attr.name = strdup("*dummy*");
+   paramOutputc->attr.name = ctx->stringPool.intern("*dummy*");
    paramOutputc->type = Char;
 
    outputc = newDeclNode(FuncK, Void);
    outputc->lineno = -1;
-   outputc->attr.name = strdup("outputc");
+   outputc->attr.name = ctx->stringPool.intern("outputc");
    outputc->type = Void;
    outputc->child[0] = paramOutputc;
 
    outnl = newDeclNode(FuncK, Void, NULL);
    outnl->lineno = -1;
-   outnl->attr.name = strdup("outnl");
+   outnl->attr.name = ctx->stringPool.intern("outnl");
    outnl->type = Void;
 
    // link them and prefix the tree we are interested in traversing
@@ -110,30 +203,143 @@ TreeNode *loadIOLib(TreeNode *syntree) {
    return input;
 }
 
+/*
+ * @brief find the declaration an IdK or CallK refers to. The symbol
+ * table is only asked the first time, the answer is kept on the node
+ * so later checks and codegen follow use->decl instead.
+ *
+ * @param use - IdK or CallK node
+ * @param symtab - Symbol table for looking up the name
+ *
+ * @return the declaration, NULL if the name is not declared
+ */
+TreeNode *resolve(TreeNode *use, SymbolTable *symtab) {
+   if (!use->isResolved) {
+      use->decl = (TreeNode *)symtab->lookup(use->attr.name);
+      use->isResolved = true;
+   }
+
+   return use->decl;
+}
+
+/*
+ * @brief is decl shared with declarations being checked on other
+ * threads, so changes to it have to wait for the merge
+ */
+static bool isShared(TreeNode *decl) {
+   return ctx->semItem != NULL && decl->varKind == Global;
+}
+
+/*
+ * @brief note a change to a shared global. Only a warning needs to know
+ * where it goes in the messages, anything else goes with the note
+ * before it.
+ *
+ * @return void
+ */
+static void addNote(NoteKind kind, TreeNode *decl, int lineno) {
+   SemanticItem *item = ctx->semItem;
+   SemanticNote note;
+
+   if (kind == NoteUninitialized) {
+      note.at = item->diagnostics.size();
+   } else {
+      note.at = item->notes.empty() ? 0 : item->notes.back().at;
+   }
+   note.kind = kind;
+   note.decl = decl;
+   note.lineno = lineno;
+   item->notes.push_back(note);
+}
+
+/*
+ * @brief remember a node given a global offset while checking an item,
+ * the offset is only final once the items before it are merged
+ *
+ * @return void
+ */
+static void addRelocation(TreeNode *node) {
+   if (ctx->semItem != NULL) ctx->semItem->relocations.push_back(node);
+}
+
+/*
+ * @brief mark a declaration as used
+ *
+ * @return void
+ */
+void markUsed(TreeNode *decl) {
+   if (!isShared(decl)) decl->isUsed = true;
+   else if (!decl->isUsed) ctx->semItem->used.push_back(decl);
+}
+
+/*
+ * @brief mark a declaration as given a value
+ *
+ * @return void
+ */
+void markAssigned(TreeNode *decl) {
+   if (!isShared(decl)) decl->isAssigned = true;
+   else if (!decl->isAssigned) addNote(NoteAssigned, decl, 0);
+}
+
+/*
+ * @brief warn about a variable used before it is given a value, once
+ *
+ * @param lineno - line of the use
+ * @param decl - declaration of the variable
+ *
+ * @return void
+ */
+void warnUninitialized(int lineno, TreeNode *decl) {
+   if (!decl->isAssigned && !decl->isArray && decl->kind.decl == VarK) {
+      bc::diagnose(bc::MaybeUninitialized, lineno, {decl->attr.name});
+      decl->isAssigned = true;
+   }
+}
+
+/*
+ * @brief check a use of a variable that might not have a value yet.
+ * Whether a global has one depends on the functions before this one, so
+ * for a shared global the check waits for the merge. Shared globals are
+ * only changed before and after the bodies are checked, so they can be
+ * read here.
+ *
+ * @return void
+ */
+void checkInitialized(TreeNode *use, TreeNode *decl) {
+   if (!isShared(decl)) {
+      warnUninitialized(use->lineno, decl);
+   } else if (!decl->isAssigned && !decl->isArray && decl->kind.decl == VarK) {
+      addNote(NoteUninitialized, decl, use->lineno);
+   }
+}
+
 /*
  * @brief handle error conditions for operators and assignments
  * not having the correct lhs and rhs types
+ *
+ * @param current - OpK or AssignK node
+ * @param sig - signature of its operator from opTable
+ *
+ * @return void
  */
-void handleOpErrors(TreeNode *current, SymbolTable *symtab) {
+void handleOpErrors(TreeNode *current, const OpSignature &sig) {
    int op = current->attr.op;
    TreeNode *lhs = NULL, *rhs = NULL; 
 
-   TreeNode *lookupNode = (TreeNode *)symtab->lookup(current->attr.name);
-
    if (current->child[0] == NULL) {
-      printf("SYNTAX ERROR(%d): child 0 cannot be NULL\n", current->lineno);
-      numErrors++;
+      bc::diagnose(bc::MissingChild, current->lineno);
       return;
    } else {
       if (current->child[0]->attr.op == '[') {
          lhs = current->child[0];
       } else {
-         lhs = (TreeNode *)symtab->lookup(current->child[0]->attr.name);
+         lhs = current->child[0]->decl;
       }
    }
 
    if (current->child[1] != NULL) {
-      rhs = (TreeNode *)symtab->lookup(current->child[1]->attr.name);
+      rhs = current->child[1]->decl;
    }
 
    if (current->child[0] != NULL && lhs == NULL) {
@@ -148,92 +354,79 @@ void handleOpErrors(TreeNode *current, SymbolTable *symtab) {
    }
 
 
-   if (op == '/' || op == '-' || op == '*' || op == '+' || op == '%' || op == MIN
-         || op == MAX || op == ADDASS || op == SUBASS || op == MULASS
-         || op == DIVASS) {
-            
-      if (lhs->type != Integer) {
-         printf("SEMANTIC ERROR(%d): '%s' requires operands of type int but lhs is of %s.\n",
-               current->lineno, largerTokens[op], expToStr(lhs->type, false, false));
-         numErrors++;
-      }
+   switch (sig.expect) {
+      case IntInt:
+         if (lhs->type != Integer) {
+            bc::diagnose(bc::OperandsNotInt, current->lineno, {largerTokens[op], "lhs", typeName(lhs->type)});
+         }
 
-      if (rhs->type != Integer) {
-         printf("SEMANTIC ERROR(%d): '%s' requires operands of type int but rhs is of %s.\n",
-               current->lineno, largerTokens[op], expToStr(rhs->type, false, false));
-         numErrors++;
-      }
+         if (rhs->type != Integer) {
+            bc::diagnose(bc::OperandsNotInt, current->lineno, {largerTokens[op], "rhs", typeName(rhs->type)});
+         }
 
-     if ((lhs->isArray && lhs->attr.op != '[') || (rhs->isArray && rhs->attr.op != '[')) { 
-         printf("SEMANTIC ERROR(%d): The operation '%s' does not work with arrays.\n", 
-            current->lineno, largerTokens[op]);
-         numErrors++;
-      }
-   } else if (op == AND || op == OR) {
-      if (lhs->type != Boolean) {
-         printf("SEMANTIC ERROR(%d): '%s' requires operands of type bool but lhs is of %s.\n",
-               current->lineno, largerTokens[op], expToStr(lhs->type, false, false));
-         numErrors++;
-      }
+         if ((lhs->isArray && lhs->attr.op != '[') || (rhs->isArray && rhs->attr.op != '[')) { 
+            bc::diagnose(bc::OperationOnArray, current->lineno, {largerTokens[op]});
+         }
+         break;
 
-      if (rhs->type != Boolean) {
-         printf("SEMANTIC ERROR(%d): '%s' requires operands of type bool but rhs is of %s.\n",
-               current->lineno, largerTokens[op], expToStr(rhs->type, false, false));
-         numErrors++;
-      }
+      case BoolBool:
+         if (lhs->type != Boolean) {
+            bc::diagnose(bc::OperandsNotBool, current->lineno, {largerTokens[op], "lhs", typeName(lhs->type)});
+         }
 
-      if ((lhs->isArray && lhs->attr.op != '[') || (rhs->isArray && rhs->attr.op != '[')) {
-         printf("SEMANTIC ERROR(%d): The operation '%s' does not work with arrays.\n", 
-            current->lineno, largerTokens[op]);
-         numErrors++;
-      }
-   } else if (op == '=' || op == EQ || op == NEQ || op == '>' || op == GEQ || op == '<' || op == LEQ) {
-      if (lhs->type != rhs->type) {
-         printf("SEMANTIC ERROR(%d): '%s' requires operands of the same type but lhs is %s and rhs is %s.\n",
-               current->lineno, largerTokens[op], expToStr(lhs->type, false, false), expToStr(rhs->type, false, false));
-         numErrors++;
-      }
+         if (rhs->type != Boolean) {
+            bc::diagnose(bc::OperandsNotBool, current->lineno, {largerTokens[op], "rhs", typeName(rhs->type)});
+         }
 
-      if (lhs->isArray && !rhs->isArray && lhs->attr.op != '[' ) {
-         printf("SEMANTIC ERROR(%d): '%s' requires both operands be arrays or not but lhs is an array and rhs is not an array.\n", 
-               current->lineno, largerTokens[op]);
-         numErrors++;
-      } else if (!lhs->isArray && rhs->isArray && rhs->attr.op != '[') {
-         printf("SEMANTIC ERROR(%d): '%s' requires both operands be arrays or not but lhs is not an array and rhs is an array.\n",
-               current->lineno, largerTokens[op]);
-         numErrors++;
-      }
-   } else if (op == SIZEOF) {
-     if (!lhs->isArray) {
-        printf("SEMANTIC ERROR(%d): The operation 'sizeof' only works with arrays.\n", current->lineno);
-        numErrors++;
-     } 
-   } else if (op == '?' || op == CHSIGN || op == INC || op == DEC) {
-      if (lhs->type != Integer) {
-         printf("SEMANTIC ERROR(%d): Unary '%s' requires an operand of type int but was given %s.\n", 
-               current->lineno, largerTokens[op], expToStr(lhs->type, false, false));
-         numErrors++;
-      }
+         if ((lhs->isArray && lhs->attr.op != '[') || (rhs->isArray && rhs->attr.op != '[')) {
+            bc::diagnose(bc::OperationOnArray, current->lineno, {largerTokens[op]});
+         }
+         break;
 
-      if (lhs->isArray && lhs->attr.op != '[') {
-         printf("SEMANTIC ERROR(%d): The operation '%s' does not work with arrays.\n", current->lineno, largerTokens[op]);
-        numErrors++;
-      } 
-   } else if (op == '[') {
-      if (!lhs->isArray || lhs->type == UndefinedType) {
-         printf("SEMANTIC ERROR(%d): Cannot index nonarray '%s'.\n", current->lineno, lhs->attr.name);
-         numErrors++;
-      }
-      else if (rhs->type != Integer) {
-         printf("SEMANTIC ERROR(%d): Array '%s' should be indexed by type int but got %s.\n", current->lineno, lhs->attr.name, expToStr(rhs->type, false, false));
-         numErrors++;
-      }
-      if (rhs->isArray) {
-         printf("SEMANTIC ERROR(%d): Array index is the unindexed array '%s'.\n", current->lineno, rhs->attr.name);
-         numErrors++;
-      }
-   }
+      case Equal:
+         if (lhs->type != rhs->type) {
+            bc::diagnose(bc::OperandsNotSameType, current->lineno, {largerTokens[op], typeName(lhs->type), typeName(rhs->type)});
+         }
 
+         if (lhs->isArray && !rhs->isArray && lhs->attr.op != '[' ) {
+            bc::diagnose(bc::OperandsArrayMismatch, current->lineno, {largerTokens[op], "an", "not an"});
+         } else if (!lhs->isArray && rhs->isArray && rhs->attr.op != '[') {
+            bc::diagnose(bc::OperandsArrayMismatch, current->lineno, {largerTokens[op], "not an", "an"});
+         }
+         break;
+
+      case OneArray:
+         if (!lhs->isArray) {
+            bc::diagnose(bc::SizeofNotArray, current->lineno);
+         } 
+         break;
+
+      case OneInt:
+         if (lhs->type != Integer) {
+            bc::diagnose(bc::UnaryNotInt, current->lineno, {largerTokens[op], typeName(lhs->type)});
+         }
+
+         if (lhs->isArray && lhs->attr.op != '[') {
+            bc::diagnose(bc::OperationOnArray, current->lineno, {largerTokens[op]});
+         } 
+         break;
+
+      case ArrayInt:
+         if (!lhs->isArray || lhs->type == UndefinedType) {
+            bc::diagnose(bc::IndexNonArray, current->lineno, {lhs->attr.name});
+         }
+         else if (rhs->type != Integer) {
+            bc::diagnose(bc::IndexNotInt, current->lineno, {lhs->attr.name, typeName(rhs->type)});
+         }
+         if (rhs->isArray) {
+            bc::diagnose(bc::IndexIsArray, current->lineno, {rhs->attr.name});
+         }
+         break;
+
+      case OneBool:
+      case NoCheck:
+         break;
+   }
 
    return;
 }
@@ -271,309 +464,331 @@ bool insertError(TreeNode *current, SymbolTable *symtab) {
 }
 
 /*
- * @brief Perform semantic analysis on a Statement node
+ * @brief enter a scope of its own for the node being checked
+ *
+ * @param v - visit of the node
+ * @param symtab - symbol table to enter the scope in
+ * @param name - name of the scope
+ *
+ * @return void
+ */
+static void enterScope(Visit &v, SymbolTable *symtab, const char *name) {
+   symtab->enter((char *)name);
+   v.remOffset = ctx->foffset;
+   v.scoped = true;
+}
+
+/*
+ * @brief leave the scope entered with enterScope, if there was one
+ *
+ * @return void
+ */
+static void leaveScope(Visit &v, SymbolTable *symtab) {
+   if (v.scoped) {
+      ctx->foffset = v.remOffset;
+      symtab->leave();
+   }
+}
+
+/*
+ * @brief Perform the next step of semantic analysis on a Statement node
  * 
- * @param current - Tree node to be analyzed
+ * @param v - visit of the node to be analyzed
  * @param symtab - Symbol table for looking up children nodes
  * 
- * @return void
+ * @return child to check before the next step, NULL for none
  */
-void treeStmtTraverse(TreeNode *current, SymbolTable *symtab) {
-   if (current->kind.stmt != CompoundK) {
-      newScope = 1;
-   }
-   
+static TreeNode *stepStmt(Visit &v, SymbolTable *symtab) {
+   TreeNode *current = v.node;
    TreeNode *lookupNode;
-   int remOffset;
+
+   if (v.step == 0 && current->kind.stmt != CompoundK) {
+      ctx->newScope = 1;
+   }
 
    switch (current->kind.stmt) {
+      // newScope was just set so if, while and for always have a scope
       case IfK:
-         if (newScope) {   
-            symtab->enter((char *)"IfStmt");
-            remOffset = foffset;
-            treeTraverse(current->child[0], symtab);
+         switch (v.step++) {
+            case 0:
+               enterScope(v, symtab, "IfStmt");
+               return current->child[0];
 
-            if (current->child[0]) {
-               lookupNode = (TreeNode *)symtab->lookup(current->child[0]->attr.name);
-            }
+            case 1:
+               lookupNode = (current->child[0]) ? current->child[0]->decl : NULL;
    
-            if (lookupNode == NULL) {
-               lookupNode = current->child[0];
-            }
+               if (lookupNode == NULL) {
+                  lookupNode = current->child[0];
+               }
 
-            if (lookupNode != NULL && lookupNode->type != Boolean && lookupNode->type != UndefinedType) {
-               printf("SEMANTIC ERROR(%d): Expecting Boolean test condition in if statement but got %s.\n", current->lineno, expToStr(lookupNode->type, false, false));
-               numErrors++;
-            }
+               if (lookupNode != NULL && lookupNode->type != Boolean && lookupNode->type != UndefinedType) {
+                  bc::diagnose(bc::TestNotBool, current->lineno, {"if", typeName(lookupNode->type)});
+               }
 
-            if (lookupNode != NULL && lookupNode->isArray) {
-               printf("SEMANTIC ERROR(%d): Cannot use array as test condition in if statement.\n", current->lineno);
-               numErrors++;
-            }
+               if (lookupNode != NULL && lookupNode->isArray) {
+                  bc::diagnose(bc::TestIsArray, current->lineno, {"if"});
+               }
 
-            current->size = foffset;
-            treeTraverse(current->child[1], symtab);
-            treeTraverse(current->child[2], symtab);
+               current->size = ctx->foffset;
+               return current->child[1];
 
-            foffset = remOffset;
-            symtab->leave();
-         } else {
-            newScope = 1;
-            treeTraverse(current->child[0], symtab);
-            current->size = foffset;
-            treeTraverse(current->child[1], symtab);
-            treeTraverse(current->child[2], symtab);
+            case 2:
+               return current->child[2];
          }
          break;
 
       case WhileK:
-         if (newScope) {   
-            symtab->enter((char *)"WhileStmt");
-            remOffset = foffset;
-            treeTraverse(current->child[0], symtab);
-            if (current->child[0] && current->child[0]->type != Boolean && current->child[0]->type != UndefinedType) {
-               // Suppress UndefinedType error, shows up elsewhere
-               printf("SEMANTIC ERROR(%d): Expecting Boolean test condition in while statement but got %s.\n", current->lineno, expToStr(current->child[0]->type, false, false));
-               numErrors++;
-            }
+         switch (v.step++) {
+            case 0:
+               enterScope(v, symtab, "WhileStmt");
+               return current->child[0];
+
+            case 1:
+               if (current->child[0] && current->child[0]->type != Boolean && current->child[0]->type != UndefinedType) {
+                  // Suppress UndefinedType error, shows up elsewhere
+                  bc::diagnose(bc::TestNotBool, current->lineno, {"while", typeName(current->child[0]->type)});
+               }
 
-            if (current->child[0] && current->child[0]->isArray) {
-               printf("SEMANTIC ERROR(%d): Cannot use array as test condition in while statement.\n", current->lineno);
-               numErrors++;
-            }
-            current->size = foffset;
-            treeTraverse(current->child[1], symtab);
-            treeTraverse(current->child[2], symtab);
-            foffset = remOffset;
-            symtab->leave();
-         } else {
-            newScope = 1;
-            treeTraverse(current->child[0], symtab);
-            current->size = foffset;
-            treeTraverse(current->child[1], symtab);
-            treeTraverse(current->child[2], symtab);
+               if (current->child[0] && current->child[0]->isArray) {
+                  bc::diagnose(bc::TestIsArray, current->lineno, {"while"});
+               }
+               current->size = ctx->foffset;
+               return current->child[1];
+
+            case 2:
+               return current->child[2];
          }
          break;
 
       case ForK:
-         if (newScope) {   
-            symtab->enter((char *)"ForStmt");
-            remOffset = foffset;
-            treeTraverse(current->child[0], symtab);
-            foffset -= 2;
-            current->size = foffset;
-            treeTraverse(current->child[1], symtab);
-            treeTraverse(current->child[2], symtab);
-            foffset = remOffset;
-            symtab->leave();
-         } else {
-            newScope = 1;
-            treeTraverse(current->child[0], symtab);
-            current->size = foffset;
-            treeTraverse(current->child[1], symtab);
-            treeTraverse(current->child[2], symtab);
+         switch (v.step++) {
+            case 0:
+               enterScope(v, symtab, "ForStmt");
+               return current->child[0];
+
+            case 1:
+               ctx->foffset -= 2;
+               current->size = ctx->foffset;
+               return current->child[1];
+
+            case 2:
+               return current->child[2];
          }
          break;
 
       case CompoundK:
-         if (newScope) {
-            symtab->enter((char*)"CompoundStatement");
-            remOffset = foffset;
-
-            treeTraverse(current->child[0], symtab);
-            current->size = foffset;
-            treeTraverse(current->child[1], symtab);
-            treeTraverse(current->child[2], symtab);
+         switch (v.step++) {
+            case 0:
+               if (ctx->newScope) {
+                  enterScope(v, symtab, "CompoundStatement");
+               } else {
+                  ctx->newScope = 1;
+               }
+               return current->child[0];
 
-            foffset = remOffset;
-            symtab->leave();
-         } else {
-            newScope = 1;
+            case 1:
+               current->size = ctx->foffset;
+               return current->child[1];
 
-            treeTraverse(current->child[0], symtab);
-            current->size = foffset;
-            treeTraverse(current->child[1], symtab);
-            treeTraverse(current->child[2], symtab);
+            case 2:
+               return current->child[2];
          }
          break;
 
       case ReturnK:
+         switch (v.step++) {
+            case 0:
+               ctx->foundReturn = true;
+               return current->child[0];
 
-         foundReturn = true;
+            case 1:
+               return current->child[1];
 
-         treeTraverse(current->child[0], symtab);
-         treeTraverse(current->child[1], symtab);
-         treeTraverse(current->child[2], symtab);
+            case 2:
+               return current->child[2];
+         }
 
-         if (current->child[0] == NULL && funcInside != NULL) {
-            printf("SEMANTIC ERROR(%d): Function '%s' at line %d is expecting to return %s but return has no value.\n",
-                  current->lineno, funcInside->attr.name, funcInside->lineno, expToStr(funcInside->type, false, false));
-            numErrors++;
+         if (current->child[0] == NULL && ctx->funcInside != NULL) {
+            bc::diagnose(bc::ReturnMissingValue, current->lineno,
+                  {ctx->funcInside->attr.name, ctx->funcInside->lineno, typeName(ctx->funcInside->type)});
          } 
          
          if (current->child[0] != NULL) {
-            lookupNode = (TreeNode *) symtab->lookup(current->child[0]->attr.name);
+            lookupNode = current->child[0]->decl;
 
             if (current->child[0]->type == UndefinedType) {
                // error thrown elsewhere
             } else if (lookupNode != NULL && lookupNode->isArray) {
-               printf("SEMANTIC ERROR(%d): Cannot return an array.\n", current->lineno);
-               numErrors++;
-            } else if (funcInside != NULL && funcInside->type != current->child[0]->type) {
-               if (funcInside->type == Void) {
-                  printf("SEMANTIC ERROR(%d): Function '%s' at line %d is expecting no return value, but return has a value.\n", 
-                        current->lineno, funcInside->attr.name, funcInside->lineno);
+               bc::diagnose(bc::ReturnArray, current->lineno);
+            } else if (ctx->funcInside != NULL && ctx->funcInside->type != current->child[0]->type) {
+               if (ctx->funcInside->type == Void) {
+                  bc::diagnose(bc::ReturnUnexpectedValue, current->lineno,
+                        {ctx->funcInside->attr.name, ctx->funcInside->lineno});
                } else {
-                  printf("SEMANTIC ERROR(%d): Function '%s' at line %d is expecting to return %s but returns %s.\n",
-                     current->lineno, funcInside->attr.name, funcInside->lineno,
-                     expToStr(funcInside->type, false, false), expToStr(current->child[0]->type, false, false));
+                  bc::diagnose(bc::ReturnWrongType, current->lineno,
+                     {ctx->funcInside->attr.name, ctx->funcInside->lineno,
+                      typeName(ctx->funcInside->type), typeName(current->child[0]->type)});
                }
-               numErrors++;
             }
          }
-
          break;
 
       case BreakK:
-         if (symtab->depth() <= 2) {
-            printf("SEMANTIC ERROR(%d): Cannot have a break statement outside of loop.\n", current->lineno);
-            numErrors++;
-         }
-         treeTraverse(current->child[0], symtab);
-         treeTraverse(current->child[1], symtab);
-         treeTraverse(current->child[2], symtab);
+         switch (v.step++) {
+            case 0:
+               if (symtab->depth() <= 2) {
+                  bc::diagnose(bc::BreakOutsideLoop, current->lineno);
+               }
+               return current->child[0];
+
+            case 1:
+               return current->child[1];
 
+            case 2:
+               return current->child[2];
+         }
          break;
 
       case RangeK:
-         for (int i = 0; i < MAXCHILDREN; i++) {
-            if (current->child[i] != NULL) {
-               if (current->child[i]->type != Integer) {
-                  printf("SEMANTIC ERROR(%d): Expecting type int in position %d in range of for statement but got %s.\n",
-                        current->lineno, i+1, expToStr(current->child[i]->type, false, false));
-                  numErrors++;
+         switch (v.step++) {
+            case 0:
+               for (int i = 0; i < MAXCHILDREN; i++) {
+                  if (current->child[i] != NULL) {
+                     if (current->child[i]->type != Integer) {
+                        bc::diagnose(bc::RangeNotInt, current->lineno, {i+1, typeName(current->child[i]->type)});
+                     }
+                     if (current->child[i]->isArray) {
+                        bc::diagnose(bc::RangeIsArray, current->lineno, {i+1});
+                     }
+                  }
                }
-               if (current->child[i]->isArray) {
-                  printf("SEMANTIC ERROR(%d): Cannot use array in position %d in range of for statement.\n",
-                        current->lineno, i+1);
-                  numErrors++;
-               }
-            }
+               return current->child[0];
 
+            case 1:
+               return current->child[1];
+
+            case 2:
+               return current->child[2];
          }
+         break;
+   }
 
-         treeTraverse(current->child[0], symtab);
-         treeTraverse(current->child[1], symtab);
-         treeTraverse(current->child[2], symtab);
+   leaveScope(v, symtab);
+   v.done = true;
 
+   return NULL;
+}
 
-         break;
+/*
+ * @brief check the arguments of a call, already checked themselves,
+ * against the parameters of the function
+ *
+ * @param current - the call
+ * @param lookupNode - declaration of the function called
+ *
+ * @return void
+ */
+static void checkArguments(TreeNode *current, TreeNode *lookupNode) {
+   TreeNode *params = current->child[0];
+   TreeNode *lookups = lookupNode->child[0];
+   int i = 1;
+
+   while (params && lookups) {
+      if (params->type != lookups->type) {
+         bc::diagnose(bc::ParamWrongType, current->lineno,
+            {typeName(lookups->type), i, lookupNode->attr.name, lookupNode->lineno, typeName(params->type)});
+      }
+      if (lookups->isArray && !params->isArray) {
+         bc::diagnose(bc::ParamNotArray, current->lineno, {i, lookupNode->attr.name, lookupNode->lineno});
+      } else if (!lookups->isArray && params->isArray && params->attr.op != '[') {
+         bc::diagnose(bc::ParamIsArray, current->lineno, {i, lookupNode->attr.name, lookupNode->lineno});
+      }
+
+      params = params->sibling;
+      lookups = lookups->sibling;
+      i++;
+   }
+
+   if (params && !lookups) {
+      bc::diagnose(bc::TooManyParams, current->lineno, {current->attr.name, lookupNode->lineno});
+   } else if (!params && lookups) {
+      bc::diagnose(bc::TooFewParams, current->lineno, {current->attr.name, lookupNode->lineno});
    }
 }
 
 /*
- * @brief Perform semantic analysis on an Expression node
+ * @brief Perform the next step of semantic analysis on an Expression node
  * 
- * @param current - Tree node to be analyzed
+ * @param v - visit of the node to be analyzed
  * @param symtab - Symbol table for looking up children nodes
  * 
- * @return void
+ * @return child to check before the next step, NULL for none
  */
-void treeExpTraverse(TreeNode *current, SymbolTable *symtab) {
-   newScope = 1;
-
+static TreeNode *stepExp(Visit &v, SymbolTable *symtab) {
+   TreeNode *current = v.node;
    TreeNode *lookupNode;
 
+   if (v.step == 0) {
+      ctx->newScope = 1;
+   }
+
    switch(current->kind.exp) {
       case AssignK:
+         switch (v.step++) {
+            case 0:
+               if (current->child[0] == NULL) {
+                  //fprintf(ctx->diag, "ERROR: left child has no type - semantics.cpp::stepExp()\t%s\n", current->attr.name);
+               } else {
+                  // look up childs type and set it to current type, before the
+                  // child is checked so it is not warned about as uninitialized
+                  lookupNode = NULL;
+                  if (current->child[0]->nodekind == ExpK && current->child[0]->kind.exp == IdK) {
+                     lookupNode = resolve(current->child[0], symtab);
+                  }
+
+                  if (lookupNode == NULL) {
+                     // child is not in the symbol table, but it does exist
+                     // FIX for array not being in symbol table, but the child existing. 
+                     current->type = current->child[0]->type;
+                     current->child[0]->isAssigned = true;
+                  } else {
+                     markAssigned(lookupNode);
+                     current->type = lookupNode->type;
+                  }
+               }
+               return current->child[0];
 
-         if (current->child[0] == NULL) {
-            //printf("ERROR: left child has no type - semantics.cpp::treeExpTraverse()\t%s\n", current->attr.name);
-         } else {
-            // look up childs type and set it to current type
-            lookupNode = 
-               (TreeNode *) symtab->lookup(current->child[0]->attr.name);
-
-            if (lookupNode == NULL) {
-               // child is not in the symbol table, but it does exist
-               // FIX for array not being in symbol table, but the child existing. 
-               current->type = current->child[0]->type;
-               current->child[0]->isAssigned = true;
-            } else {
-               lookupNode->isAssigned = true;
-               current->type = lookupNode->type;
-            }
+            case 1:
+               return current->child[1];
 
+            case 2:
+               return current->child[2];
          }
 
-         treeTraverse(current->child[0], symtab);
-         treeTraverse(current->child[1], symtab);
-         treeTraverse(current->child[2], symtab);
-         handleOpErrors(current, symtab);
-
+         handleOpErrors(current, opTable.sig[current->attr.op]);
          break;
 
       case CallK:
-         treeTraverse(current->child[0], symtab);
-         lookupNode = (TreeNode *) symtab->lookup(current->attr.name);
+         // the arguments are checked once, before the call itself
+         if (v.step++ == 0) {
+            return current->child[0];
+         }
+
+         lookupNode = resolve(current, symtab);
 
          if (lookupNode == NULL) {
-            printf("SEMANTIC ERROR(%d): Symbol '%s' is not declared.\n", current->lineno, current->attr.name);
+            bc::diagnose(bc::Undeclared, current->lineno, {current->attr.name});
             current->type = UndefinedType;
-            numErrors++;
          } else {
             if (lookupNode->kind.decl != FuncK) {
-               printf("SEMANTIC ERROR(%d): '%s' is a simple variable and cannot be called.\n",
-                     current->lineno, current->attr.name);
-               numErrors++;
+               bc::diagnose(bc::CallSimpleVariable, current->lineno, {current->attr.name});
             }
 
             current->type = lookupNode->type;
             current->offset = lookupNode->offset;
             current->isUsed = true;
-            lookupNode->isUsed = true;
-            TreeNode *params = current->child[0];
-            TreeNode *lookups = lookupNode->child[0];
-            TreeNode *tmp;
-            int i = 1;
-
-            while (params && lookups) {
-               tmp = params->sibling;
-               params->sibling = NULL;
-               treeTraverse(params, symtab);
-
-               params->sibling = tmp;
-
-               if (params->type != lookups->type) {
-                  printf("SEMANTIC ERROR(%d): Expecting %s in parameter %d of call to '%s' declared on line %d but got %s.\n",
-                     current->lineno, expToStr(lookups->type, false, false), i, lookupNode->attr.name, lookupNode->lineno,
-                     expToStr(params->type, false, false));
-                  numErrors++;
-               }
-               if (lookups->isArray && !params->isArray) {
-                  printf("SEMANTIC ERROR(%d): Expecting array in parameter %d of call to '%s' declared on line %d.\n",
-                        current->lineno, i, lookupNode->attr.name, lookupNode->lineno);
-                  numErrors++;
-               } else if (!lookups->isArray && params->isArray && params->attr.op != '[') {
-                  printf("SEMANTIC ERROR(%d): Not expecting array in parameter %d of call to '%s' declared on line %d.\n",
-                        current->lineno, i, lookupNode->attr.name, lookupNode->lineno);
-                  numErrors++;
-               }
-
-               params = params->sibling;
-               lookups = lookups->sibling;
-               i++;
-            }
-
-            if (params && !lookups) {
-               printf("SEMANTIC ERROR(%d): Too many parameters passed for function '%s' declared on line %d.\n",
-                  current->lineno, current->attr.name, lookupNode->lineno);
-               numErrors++;
-            } else if (!params && lookups) {
-               printf("SEMANTIC ERROR(%d): Too few parameters passed for function '%s' declared on line %d.\n",
-                  current->lineno, current->attr.name, lookupNode->lineno);
-               numErrors++;
-            }
+            markUsed(lookupNode);
+            checkArguments(current, lookupNode);
          }
 
          break;
@@ -581,211 +796,370 @@ void treeExpTraverse(TreeNode *current, SymbolTable *symtab) {
       case ConstantK:
          // All constant strings are global
          if (current->type == Char && current->isArray) {
+            addRelocation(current);
             current->varKind = Global;
-            current->offset = goffset-1;
-            goffset -= current->size;
+            current->offset = ctx->goffset-1;
+            ctx->goffset -= current->size;
          }
          break;
 
       case IdK:
-         lookupNode = (TreeNode *)symtab->lookup(current->attr.name);
+         switch (v.step++) {
+            case 0:
+               v.decl = resolve(current, symtab);
 
-         if (lookupNode == NULL) {
-            printf("SEMANTIC ERROR(%d): Symbol '%s' is not declared.\n", current->lineno, current->attr.name);
-            current->type = UndefinedType;
-            numErrors++;
-         }
+               if (v.decl == NULL) {
+                  bc::diagnose(bc::Undeclared, current->lineno, {current->attr.name});
+                  current->type = UndefinedType;
+               }
+               return current->child[0];
+
+            case 1:
+               return current->child[1];
 
-         treeTraverse(current->child[0], symtab);
-         treeTraverse(current->child[1], symtab);
-         treeTraverse(current->child[2], symtab);
+            case 2:
+               return current->child[2];
+         }
 
+         lookupNode = v.decl;
          if (lookupNode != NULL) {
             if (lookupNode->kind.decl == FuncK) {
-               printf("SEMANTIC ERROR(%d): Cannot use function '%s' as a variable.\n", current->lineno, lookupNode->attr.name);
-               numErrors++;
+               bc::diagnose(bc::FunctionAsVariable, current->lineno, {lookupNode->attr.name});
+               current->type = lookupNode->type;
+            } else {
+               // a function's frame size may still be being worked out
+               // on another thread, only variables are copied
+               current->offset = lookupNode->offset;
+               current->type = lookupNode->type;
+               current->size = lookupNode->size;
+               current->varKind = lookupNode->varKind;
+               current->isArray = lookupNode->isArray;
+               current->isStatic = lookupNode->isStatic;
+               if (current->varKind == Global || current->varKind == LocalStatic) addRelocation(current);
             }
-
-            current->offset = lookupNode->offset;
-            current->type = lookupNode->type;
-            current->size = lookupNode->size;
-            current->varKind = lookupNode->varKind;
-            current->isArray = lookupNode->isArray;
-            current->isStatic = lookupNode->isStatic;
             current->isUsed = true;
-            lookupNode->isUsed = true;
-
-            if (!lookupNode->isAssigned && !lookupNode->isArray && lookupNode->kind.decl == VarK) {
-               printf("SEMANTIC WARNING(%d): Variable '%s' may be uninitialized when used here.\n", current->lineno, lookupNode->attr.name);
-               lookupNode->isAssigned = true;
-               numWarnings++;
-            }
+            markUsed(lookupNode);
+            checkInitialized(current, lookupNode);
          }
          break;
 
       case OpK:
-         int op = current->attr.op;
-
-         treeTraverse(current->child[0], symtab);
-         treeTraverse(current->child[1], symtab);
-         treeTraverse(current->child[2], symtab);
-         if (op == EQ || op == NEQ || op == LEQ || op == GEQ || op == '<' || op == '>') {
-            current->type = Boolean;
-         } else if (op == SIZEOF) {
-            current->type = Integer;
-         } else {
+         if (v.step < MAXCHILDREN) {
+            return current->child[v.step++];
+         }
 
-            if (current->child[0] == NULL) {
-               printf("ERROR: Op child can not be NULL - semantics.cpp::treeExpTraverse\n");
-            } else {
-               lookupNode = (TreeNode *)symtab->lookup(current->child[0]->attr.name);
-               if (lookupNode == NULL) {
-                  current->type = current->child[0]->type;
+         const OpSignature &sig = opTable.sig[current->attr.op];
+
+         switch (sig.ret) {
+            case RetBool:
+               current->type = Boolean;
+               break;
+            case RetInt:
+               current->type = Integer;
+               break;
+            case RetLHS:
+               if (current->child[0] == NULL) {
+                  bc::diagnose(bc::InternalError, current->lineno, {"operator has no operand in stepExp"});
                } else {
-                  current->type = lookupNode->type;
+                  lookupNode = current->child[0]->decl;
+                  if (lookupNode == NULL) {
+                     current->type = current->child[0]->type;
+                  } else {
+                     current->type = lookupNode->type;
+                  }
                }
-            }
+               break;
          }
 
-         if (op == '[') {
+         if (sig.expect == ArrayInt) {
             current->isArray = true;
          }
 
-         handleOpErrors(current, symtab);
+         handleOpErrors(current, sig);
          break;
    }
 
-   return;
+   v.done = true;
+
+   return NULL;
+}
+
+/*
+ * @brief check the initializer of a variable after it has been checked
+ *
+ * @param current - declaration of the variable
+ *
+ * @return void
+ */
+static void checkInitializer(TreeNode *current) {
+   if (current->type != current->child[0]->type) {
+      bc::diagnose(bc::InitializerWrongType, current->lineno,
+            {current->attr.name, typeName(current->type), typeName(current->child[0]->type)});
+   }
+
+   if (current->child[0]->kind.exp != ConstantK) {
+      bc::diagnose(bc::InitializerNotConstant, current->lineno, {current->attr.name});
+   }
+
+   if (current->isArray && !current->child[0]->isArray) {
+      bc::diagnose(bc::InitializerArrayMismatch, current->lineno, {current->attr.name, "an", "not an"});
+   }
+   if (!current->isArray && current->child[0]->isArray) {
+      bc::diagnose(bc::InitializerArrayMismatch, current->lineno, {current->attr.name, "not an", "an"});
+   }
+}
+
+/*
+ * @brief put a variable or parameter in the symbol table and give it
+ * its place in memory
+ *
+ * @param current - declaration of the variable or parameter
+ * @param symtab - symbol table to put it in
+ *
+ * @return void
+ */
+static void declareVariable(TreeNode *current, SymbolTable *symtab) {
+   TreeNode *lookupNode;
+
+   if (current->child[0] != NULL) {
+     current->isAssigned = true; 
+   }
+
+   if (insertError(current, symtab)) {
+      if (symtab->depth() == 1) {
+         current->varKind = Global;
+         current->offset = ctx->goffset;
+         ctx->goffset -= current->size;
+         addRelocation(current);
+      } else if (current->isStatic) {
+         current->varKind = LocalStatic;
+         current->offset = ctx->goffset;
+         ctx->goffset -= current->size;
+         addRelocation(current);
+         nameStatic(current, symtab);
+      } else {
+         current->varKind = Local;
+         current->offset = ctx->foffset;
+         ctx->foffset -= current->size;
+      }
+   } else {
+      lookupNode = (TreeNode *)symtab->lookup(current->attr.name);
+      bc::diagnose(bc::AlreadyDeclared, current->lineno, {current->attr.name, lookupNode->lineno});
+   }
+
+   if (current->kind.decl == ParamK) {
+      current->varKind = Parameter;
+   } else if (current->isArray) {
+      current->offset--;
+   }
 }
 
 /*
- * @brief Perform semantic analysis on a Declaration node
+ * @brief Perform the next step of semantic analysis on a Declaration node
  * 
- * @param current - Tree node to be analyzed
+ * @param v - visit of the node to be analyzed
  * @param symtab - Symbol table for looking up children nodes
  * 
- * @return void
+ * @return child to check before the next step, NULL for none
  */
-void treeDeclTraverse(TreeNode *current, SymbolTable *symtab) {
-   newScope = 1;
-   TreeNode *lookupNode;
+static TreeNode *stepDecl(Visit &v, SymbolTable *symtab) {
+   TreeNode *current = v.node;
+
+   if (v.step == 0) {
+      ctx->newScope = 1;
+   }
 
    switch (current->kind.decl) {
       case VarK:
-         treeTraverse(current->child[0], symtab);      
-         if (current->child[0] != NULL) {
-            if (current->type != current->child[0]->type) {
-               printf("SEMANTIC ERROR(%d): Initializer for variable '%s' of %s is of %s\n", 
-                     current->lineno, current->attr.name, expToStr(current->type, false, false), 
-                     expToStr(current->child[0]->type, false, false));
-               numErrors++;
-            }
-
-            if (current->child[0]->kind.exp != ConstantK) {
-               printf("SEMANTIC ERROR(%d): Initializer for variable '%s' is not a constant expression.\n", current->lineno, current->attr.name);
-               numErrors++;
-            }
-
-            if (current->isArray && !current->child[0]->isArray) {
-               printf("SEMANTIC ERROR(%d): Initializer for variable '%s' requires both operands be arrays or not but variable is an array and rhs is not an array.\n",
-                     current->lineno, current->attr.name);
-               numErrors++;
-            }
-            if (!current->isArray && current->child[0]->isArray) {
-               printf("SEMANTIC ERROR(%d): Initializer for variable '%s' requires both operands be arrays or not but variable is not an array and rhs is an array.\n",
-                     current->lineno, current->attr.name);
-               numErrors++;
-            }
-         }
-         // no break on purpose, follow through into ParamK
       case ParamK:
-         if (current->child[0] != NULL) {
-           current->isAssigned = true; 
-         }
-
-         if (insertError(current, symtab)) {
-            if (symtab->depth() == 1) {
-               current->varKind = Global;
-               current->offset = goffset;
-               goffset -= current->size;
-            } else if (current->isStatic) {
-               current->varKind = LocalStatic;
-               current->offset = goffset;
-               goffset -= current->size;
-
-               {
-                  char *newName;
-                  newName = new char[strlen(current->attr.name)+10];
-                  snprintf(newName, strlen(current->attr.name)+10, "%s-%d", current->attr.name, ++varCounter);
-                  symtab->insertGlobal(newName, current);
-                  delete [] newName;
+         switch (v.step++) {
+            case 0:
+               // only a variable has an initializer to check first
+               return (current->kind.decl == VarK) ? current->child[0] : NULL;
+
+            case 1:
+               if (current->kind.decl == VarK && current->child[0] != NULL) {
+                  checkInitializer(current);
                }
+               declareVariable(current, symtab);
+               return current->child[1];
 
-            } else {
-               current->varKind = Local;
-               current->offset = foffset;
-               foffset -= current->size;
-            }
-         } else {
-            lookupNode = (TreeNode *)symtab->lookup(current->attr.name);
-            printf("SEMANTIC ERROR(%d): Symbol '%s' is already declared at line %d.\n", 
-                  current->lineno, current->attr.name, lookupNode->lineno);
-            numErrors++;
+            case 2:
+               return current->child[2];
          }
+         break;
+
+      case FuncK:
+         // checkFunction starts at step 1 with the header declared
+         switch (v.step++) {
+            case 0:
+               declareFunction(current, symtab);
+               return NULL;
 
-         if (current->kind.decl == ParamK) {
-            current->varKind = Parameter;
-         } else if (current->isArray) {
-            current->offset--;
+            case 1:
+               ctx->newScope = 0;
+               ctx->foffset = -2;
+
+               symtab->enter(current->attr.name);
+
+               // store which function we are in for children to reference
+               ctx->funcInside = current;
+               return current->child[0];
+
+            case 2:
+               current->size = ctx->foffset;
+               return current->child[1];
+
+            case 3:
+               return current->child[2];
          }
 
-         treeTraverse(current->child[1], symtab);
-         treeTraverse(current->child[2], symtab);
+         symtab->applyToAll(checkIsUsed);
 
-         break;
-      case FuncK:
-         newScope = 0;
-         foffset = -2;
-         
-         if (insertError(current, symtab) == false) {
-            lookupNode = (TreeNode *)symtab->lookup(current->attr.name);
-            printf("SEMANTIC ERROR(%d): Symbol '%s' is already declared at line %d.\n", 
-                  current->lineno, current->attr.name, lookupNode->lineno);
-            numErrors++;
+         if ((current->lineno != -1) && !ctx->foundReturn && current->type != Void) {
+            bc::diagnose(bc::NoReturn, current->lineno, {typeName(current->type), current->attr.name});
          }
 
-         symtab->enter(current->attr.name);
+         symtab->leave();
 
+         ctx->foundReturn = false;
+         break;
+   }
 
-         // store which function we are in for children to reference
-         funcInside = current;
-         
-         treeTraverse(current->child[0], symtab);
-         current->size = foffset;
-         treeTraverse(current->child[1], symtab);
-         treeTraverse(current->child[2], symtab);
+   v.done = true;
 
-         current->varKind = Global;
+   return NULL;
+}
 
-         symtab->applyToAll(checkIsUsed);
+/*
+ * @brief give a static local its global name. Statics are numbered in
+ * source order, when the bodies are checked on their own threads this
+ * waits for the merge.
+ *
+ * @param current - declaration of the static
+ * @param symtab - symbol table the name goes in the globals of
+ *
+ * @return void
+ */
+void nameStatic(TreeNode *current, SymbolTable *symtab) {
+   char *newName;
 
-         if ((current->lineno != -1) && !foundReturn && current->type != Void) {
-            printf("SEMANTIC WARNING(%d): Expecting to return %s but function '%s' has no return statement.\n",
-                  current->lineno, expToStr(current->type, false, false), current->attr.name);
-            numWarnings++;
-         }
+   if (ctx->semItem != NULL) {
+      ctx->semItem->statics.push_back(current);
+      return;
+   }
 
+   newName = new char[strlen(current->attr.name)+10];
+   snprintf(newName, strlen(current->attr.name)+10, "%s-%d", current->attr.name, ++ctx->varCounter);
+   symtab->insertGlobal(ctx->stringPool.intern(newName), current);
+   delete [] newName;
+}
 
-         symtab->leave();
+/*
+ * @brief put a function in the globals, the header part of a FuncK
+ *
+ * @param current - function declaration
+ * @param symtab - symbol table at global scope
+ *
+ * @return void
+ */
+void declareFunction(TreeNode *current, SymbolTable *symtab) {
+   TreeNode *lookupNode;
+
+   if (insertError(current, symtab) == false) {
+      lookupNode = (TreeNode *)symtab->lookup(current->attr.name);
+      bc::diagnose(bc::AlreadyDeclared, current->lineno, {current->attr.name, lookupNode->lineno});
+   }
 
-         foundReturn = false;
+   current->varKind = Global;
+}
 
-         break;
+/*
+ * @brief start checking a node
+ *
+ * @param stack - visits in progress
+ * @param node - node to check
+ * @param step - step to start at
+ * @param chain - check its siblings after it
+ *
+ * @return void
+ */
+static void pushVisit(std::vector<Visit> &stack, TreeNode *node, int step, bool chain) {
+   Visit v = Visit();
+
+   v.node = node;
+   v.step = step;
+   v.chain = chain;
+   stack.push_back(v);
+}
+
+/*
+ * @brief analyze a node, its children and, if chain, its siblings. The
+ * children are checked on an explicit stack and a sibling replaces the
+ * node before it, so the stack only grows with the nesting of the tree.
+ *
+ * @param start - node to start at
+ * @param step - step of that node to start at
+ * @param chain - check the siblings of start too
+ * @param symtab - Symbol table for looking up children nodes
+ *
+ * @return void
+ */
+static void runVisits(TreeNode *start, int step, bool chain, SymbolTable *symtab) {
+   std::vector<Visit> stack;
+
+   pushVisit(stack, start, step, chain);
+   while (!stack.empty()) {
+      Visit &v = stack.back();
+      TreeNode *child = NULL;
+
+      if (v.done) {
+         TreeNode *sibling = v.chain ? v.node->sibling : NULL;
+
+         stack.pop_back();
+         if (sibling != NULL) {
+            pushVisit(stack, sibling, 0, true);
+         }
+         continue;
+      }
+
+      switch (v.node->nodekind) {
+         case DeclK:
+            child = stepDecl(v, symtab);
+            break;
+         case ExpK:
+            child = stepExp(v, symtab);
+            break;
+         case StmtK:
+            child = stepStmt(v, symtab);
+            break;
+         default:
+            v.done = true;
+            break;
+      }
+
+      if (child != NULL) {
+         pushVisit(stack, child, 0, true);
+      }
    }
 }
 
 /*
- * @brief recursively analyze every node in the tree
+ * @brief check the parameters and body of a function declared with
+ * declareFunction. Only needs the globals declared before it, so it can
+ * run on its own symbol table and context.
+ *
+ * @param current - function declaration
+ * @param symtab - symbol table at global scope
+ *
+ * @return void
+ */
+void checkFunction(TreeNode *current, SymbolTable *symtab) {
+   runVisits(current, 1, false, symtab);
+}
+
+/*
+ * @brief analyze every node in a tree and its siblings
  * 
  * @param current - Current node to be analyzed
  * @param symtab - Symbol table for looking up children nodes
@@ -793,60 +1167,35 @@ void treeDeclTraverse(TreeNode *current, SymbolTable *symtab) {
  * @return void
  */
 void treeTraverse(TreeNode *current, SymbolTable *symtab) {
-   if (current == NULL) {
-      return;
-   }
-
-   switch(current->nodekind) {
-      case DeclK:
-         treeDeclTraverse(current, symtab);
-         break;
-      case ExpK:
-         treeExpTraverse(current, symtab);
-         break;
-      case StmtK:
-         treeStmtTraverse(current, symtab);
-         break;
-   }
-
-   if (current->sibling) {
-      treeTraverse(current->sibling, symtab);
+   if (current != NULL) {
+      runVisits(current, 0, true, symtab);
    }
 }
 
-void checkIsUsed(std::string str, void *node) {
+void checkIsUsed(std::string, void *node) {
    TreeNode *tree = (TreeNode *)node;
 
    if (tree && !tree->isUsed && tree->lineno != -1) {
       switch (tree->kind.decl) {
          case VarK: {
-            char *pos = strchr(tree->attr.name, '-');
-            if (pos != NULL) {
-               *pos = '\0';
-            }
-
-            printf("SEMANTIC WARNING(%d): The variable '%s' seems not to be used.\n",
-                  tree->lineno, tree->attr.name);
+            // names are shared through the string pool so print only up to
+            // any '-' rather than cutting the string
+            bc::diagnose(bc::UnusedVariable, tree->lineno, {{tree->attr.name, strcspn(tree->attr.name, "-")}});
             tree->isUsed = true;
-            numWarnings++;
             break;           
          }
          case ParamK:
-            printf("SEMANTIC WARNING(%d): The parameter '%s' seems not to be used.\n",
-                  tree->lineno, tree->attr.name);
-            numWarnings++;
+            bc::diagnose(bc::UnusedParameter, tree->lineno, {tree->attr.name});
             tree->isUsed = true;
             break;
 
          case FuncK:
-            if (strcmp(tree->attr.name, "main") == 0) {
+            if (tree->attr.name == ctx->stringPool.intern("main")) {
                break;
             }
             
-            printf("SEMANTIC WARNING(%d): The function '%s' seems not to be used.\n",
-                  tree->lineno, tree->attr.name);
+            bc::diagnose(bc::UnusedFunction, tree->lineno, {tree->attr.name});
             tree->isUsed = true;
-            numWarnings++;
             break;
 
       }
@@ -854,6 +1203,191 @@ void checkIsUsed(std::string str, void *node) {
    }
 }
 
+/*
+ * @brief send the messages of an item to the item
+ *
+ * @return void
+ */
+static void beginItem(SemanticItem *item) {
+   ctx->diagnostics = &item->diagnostics;
+   ctx->semItem = item;
+}
+
+/*
+ * @brief end the messages of the item begun
+ *
+ * @return void
+ */
+static void endItem() {
+   ctx->diagnostics = &ctx->messages;
+   ctx->semItem = NULL;
+}
+
+/*
+ * @brief check the bodies of the functions on numThreads threads. Each
+ * thread has its own context for the frame offsets and counts and each
+ * body gets a symbol table of its own that sees the globals declared
+ * before it.
+ *
+ * @param funcs - function items, their headers already declared
+ * @param symtab - symbol table holding the globals
+ * @param numThreads - threads to run, 0 for one per core
+ *
+ * @return void
+ */
+static void checkBodies(std::vector<SemanticItem *> &funcs, SymbolTable *symtab, int numThreads) {
+   std::atomic<size_t> next(0);
+   std::vector<std::thread> workers;
+   bc::CompilerContext *saved = ctx;
+
+   if (numThreads <= 0) {
+      numThreads = (int)std::thread::hardware_concurrency();
+   }
+   if ((size_t)numThreads > funcs.size()) {
+      numThreads = (int)funcs.size();
+   }
+
+   auto work = [&]() {
+      bc::CompilerContext context(NULL, NULL);
+      SymbolTable scopes(symtab, 0);
+      size_t index;
+
+      ctx = &context;
+      while ((index = next.fetch_add(1)) < funcs.size()) {
+         SemanticItem *item = funcs[index];
+
+         scopes.seeGlobals(item->numGlobals);
+         context.goffset = item->goffset;
+         context.numErrors = 0;
+         context.numWarnings = 0;
+         beginItem(item);
+         checkFunction(item->decl, &scopes);
+         endItem();
+         item->gsize = context.goffset - item->goffset;
+         item->numErrors = context.numErrors;
+         item->numWarnings = context.numWarnings;
+      }
+   };
+
+   for (int i = 1; i < numThreads; i++) {
+      workers.emplace_back(work);
+   }
+   work();   // this thread works too
+   for (std::thread &worker : workers) {
+      worker.join();
+   }
+   ctx = saved;
+}
+
+/*
+ * @brief move the global offsets given out while checking an item by
+ * shift now that the space taken by the items before it is known. Uses
+ * of globals copy the offset of their declaration again, it is in an
+ * earlier item so it has already moved.
+ *
+ * @return void
+ */
+static void relocate(SemanticItem *item, int shift) {
+   for (TreeNode *node : item->relocations) {
+      if (node->nodekind == ExpK && node->kind.exp == IdK) {
+         node->offset = node->decl->offset;
+      } else {
+         node->offset += shift;
+      }
+   }
+}
+
+/*
+ * @brief write the messages of an item, making the changes it noted to
+ * the globals at the point they happened
+ *
+ * @return void
+ */
+static void mergeItem(SemanticItem *item) {
+   size_t at = 0;
+
+   for (SemanticNote &note : item->notes) {
+      ctx->diagnostics->append(item->diagnostics, at, note.at);
+      at = note.at;
+      switch (note.kind) {
+         case NoteAssigned:
+            note.decl->isAssigned = true;
+            break;
+         case NoteUninitialized:
+            warnUninitialized(note.lineno, note.decl);
+            break;
+      }
+   }
+   ctx->diagnostics->append(item->diagnostics, at, item->diagnostics.size());
+   for (TreeNode *decl : item->used) {
+      decl->isUsed = true;
+   }
+
+   ctx->numErrors += item->numErrors;
+   ctx->numWarnings += item->numWarnings;
+}
+
+/*
+ * @brief check the top level declarations in two stages. The globals
+ * and function headers are checked in order, then the function bodies
+ * on numThreads threads. The messages are merged in source order so
+ * they are the same as treeTraverse gives.
+ *
+ * @param syntree - the top level declarations
+ * @param symtab - symbol table to be filled in
+ * @param numThreads - threads to run, 0 for one per core
+ *
+ * @return void
+ */
+static void checkInStages(TreeNode *syntree, SymbolTable *symtab, int numThreads) {
+   std::vector<SemanticItem> items(countSiblings(syntree));
+   std::vector<SemanticItem *> funcs;
+   int goffset = ctx->goffset;
+   size_t i = 0;
+
+   // globals and function headers, the bodies only need these
+   for (TreeNode *current = syntree; current != NULL; current = current->sibling, i++) {
+      SemanticItem *item = &items[i];
+      TreeNode *sibling = current->sibling;
+
+      item->decl = current;
+      item->goffset = ctx->goffset;
+      item->numErrors = 0;
+      item->numWarnings = 0;
+      beginItem(item);
+      current->sibling = NULL;
+      if (current->nodekind == DeclK && current->kind.decl == FuncK) {
+         declareFunction(current, symtab);
+         item->numGlobals = symtab->numGlobals();
+         funcs.push_back(item);
+      } else {
+         treeTraverse(current, symtab);
+      }
+      current->sibling = sibling;
+      endItem();
+      item->gsize = ctx->goffset - item->goffset;
+   }
+
+   if (!funcs.empty()) {
+      checkBodies(funcs, symtab, numThreads);
+   }
+
+   // in source order: messages, names of statics and global offsets
+   ctx->goffset = goffset;
+   for (SemanticItem &item : items) {
+      int shift = ctx->goffset - item.goffset;
+
+      mergeItem(&item);
+      for (TreeNode *decl : item.statics) {
+         nameStatic(decl, symtab);
+      }
+      if (shift != 0) {
+         relocate(&item, shift);
+      }
+      ctx->goffset += item.gsize;
+   }
+}
+
 /*
  * @brief Perform semantic analysis on an AST
  * 
@@ -864,21 +1398,28 @@ void checkIsUsed(std::string str, void *node) {
  * @return Annotated syntax tree
  */
 TreeNode *semanticAnalysis(TreeNode *syntree, SymbolTable *symtabX, int &globalOffset) {
-
+   bc::startPhase("ioLib");
    syntree = loadIOLib(syntree);
 
-   treeTraverse(syntree, symtabX);
+   bc::startPhase("semantic");
+   if (ctx->semanticThreads == 1) {
+      treeTraverse(syntree, symtabX);
+   } else {
+      checkInStages(syntree, symtabX, ctx->semanticThreads);
+   }
 
+   bc::startPhase("unused");
    symtabX->applyToAll(checkIsUsed);
 
-   TreeNode *lookupNode = (TreeNode *)symtabX->lookup("main");
+   TreeNode *lookupNode = (TreeNode *)symtabX->lookup(ctx->stringPool.intern("main"));
 
    if (lookupNode == NULL || lookupNode->kind.decl != FuncK || lookupNode->child[0] != NULL) {
-      printf("LINKER ERROR: A function named 'main' with no parameters must be defined.\n");
-      numErrors++;
-   } 
+      bc::diagnose(bc::NoMain, 0);
+   } else {
+      ctx->mainFunc = lookupNode;
+   }
 
-   globalOffset = goffset;
+   globalOffset = ctx->goffset;
    
    return syntree;
 }
@@ -0,0 +1,168 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Loads source files for the scanner. Files are mapped with
+ * two null bytes after the last character, which is what the scanner
+ * needs to run over the bytes without copying them.
+ *
+ */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "source.h"
+
+#define READ_CHUNK_SIZE (64 * 1024)   // bytes read at a time from a stream
+
+/*
+ * @brief memory map a source file followed by two null bytes
+ *
+ * A private anonymous mapping one page longer than needed is reserved
+ * first and the file is mapped over the front of it. Whatever follows
+ * the end of the file is then zero filled memory, even when the file
+ * is an exact number of pages. The mapping is private and writable
+ * because the scanner temporarily writes a null after each token.
+ *
+ * @param path - file to map
+ * @param src - filled in with the mapped source
+ *
+ * @return true if the file was mapped
+ */
+bool openSource(const char *path, SourceBuffer *src) {
+   struct stat info;
+   size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+   int fd;
+   char *base;
+
+   fd = open(path, O_RDONLY);
+   if (fd < 0) {
+      return false;
+   }
+
+   if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+      // not something we can map (a pipe for example), read it instead
+      FILE *in = fdopen(fd, "r");
+      bool ok = (in != NULL) && readSource(in, src);
+      if (in != NULL) {
+         fclose(in);
+      } else {
+         close(fd);
+      }
+      return ok;
+   }
+
+   src->size = (size_t)info.st_size;
+   src->mapped = (src->size + 2 + pageSize - 1) / pageSize * pageSize;
+
+   base = (char *)mmap(NULL, src->mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (base == MAP_FAILED) {
+      close(fd);
+      return false;
+   }
+
+   if (src->size > 0 && mmap(base, src->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+      munmap(base, src->mapped);
+      close(fd);
+      return false;
+   }
+
+   // the mapping stays valid after the descriptor is closed
+   close(fd);
+   madvise(base, src->size, MADV_SEQUENTIAL);
+   src->base = base;
+
+   return true;
+}
+
+/*
+ * @brief read an entire stream into memory followed by two null bytes
+ *
+ * @param in - stream to read
+ * @param src - filled in with the source
+ *
+ * @return true if the stream was read without error
+ */
+bool readSource(FILE *in, SourceBuffer *src) {
+   size_t capacity = READ_CHUNK_SIZE;
+   size_t got;
+
+   src->base = (char *)malloc(capacity);
+   src->size = 0;
+   src->mapped = 0;
+
+   while (src->base != NULL) {
+      if (capacity - src->size < READ_CHUNK_SIZE + 2) {
+         capacity *= 2;
+         src->base = (char *)realloc(src->base, capacity);
+         if (src->base == NULL) {
+            break;
+         }
+      }
+      got = fread(src->base + src->size, 1, READ_CHUNK_SIZE, in);
+      src->size += got;
+      if (got < READ_CHUNK_SIZE) {
+         break;
+      }
+   }
+
+   if (src->base == NULL) {
+      printf("ERROR(SYSTEM): out of memory reading the source\n");
+      exit(1);
+   }
+
+   src->base[src->size] = '\0';
+   src->base[src->size + 1] = '\0';
+
+   return !ferror(in);
+}
+
+/*
+ * @brief copy source text that is already in memory, like a string
+ * handed to bc::compile(), into a buffer followed by two null bytes
+ *
+ * @param text - the source text, need not be null terminated
+ * @param len - number of chars of source
+ * @param src - filled in with the copied source
+ *
+ * @return void
+ */
+void copySource(const char *text, size_t len, SourceBuffer *src) {
+   src->base = (char *)malloc(len + 2);
+   src->size = len;
+   src->mapped = 0;
+
+   if (src->base == NULL) {
+      printf("ERROR(SYSTEM): out of memory copying the source\n");
+      exit(1);
+   }
+
+   memcpy(src->base, text, len);
+   src->base[len] = '\0';
+   src->base[len + 1] = '\0';
+}
+
+/*
+ * @brief release the source
+ *
+ * @param src - source from openSource, readSource or copySource
+ *
+ * @return void
+ */
+void closeSource(SourceBuffer *src) {
+   if (src->base == NULL) {
+      return;
+   }
+
+   if (src->mapped) {
+      munmap(src->base, src->mapped);
+   } else {
+      free(src->base);
+   }
+
+   src->base = NULL;
+   src->size = 0;
+   src->mapped = 0;
+}
@@ -0,0 +1,41 @@
+#ifndef _SOURCE_H_
+#define _SOURCE_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Source input for the scanner. A file is memory mapped and
+ * scanned in place so token text can be viewed directly in the mapping
+ * instead of being copied out of a stdio buffer.
+ *
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+
+struct SourceBuffer
+{
+    char *base;            // first byte of the source
+    size_t size;           // bytes of source, base[size] and base[size+1] are always null
+    size_t mapped;         // bytes mapped with mmap, 0 when base came from malloc
+};
+
+// Memory map the file at path, returns false if it cannot be opened
+bool openSource(const char *path, SourceBuffer *src);
+
+// Read all of a stream (like stdin) that cannot be mapped, returns false on a read error
+bool readSource(FILE *in, SourceBuffer *src);
+
+// Copy len chars of text already in memory into a source buffer
+void copySource(const char *text, size_t len, SourceBuffer *src);
+
+// Unmap or free the source. Token views into it are invalid afterwards.
+void closeSource(SourceBuffer *src);
+
+// Make a scanner that scans the source in place, pass it to yyparse()
+void *scannerBegin(SourceBuffer *src);
+
+// Free a scanner made by scannerBegin
+void scannerEnd(void *scanner);
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Interning table shared by the scanner, symbol table and
+ * code generator. Strings are copied into the compile arena once and
+ * the same pointer is returned for every later request of that string.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "stringPool.h"
+
+#define POOL_START_CAPACITY 1024           // slots in a fresh table
+
+/*
+ * @brief FNV-1a hash of the first len chars of s
+ */
+static unsigned int hashString(const char *s, size_t len) {
+   unsigned int hash = 2166136261u;
+
+   for (size_t i = 0; i < len; i++) {
+      hash ^= (unsigned char)s[i];
+      hash *= 16777619u;
+   }
+
+   return hash;
+}
+
+StringPool::StringPool(Arena *store) {
+   this->store = store;
+   table = NULL;
+   capacity = 0;
+   count = 0;
+}
+
+StringPool::~StringPool() {
+   free(table);
+}
+
+/*
+ * @brief move every entry into a new table with newCapacity slots
+ *
+ * @param newCapacity - number of slots, must be a power of 2
+ *
+ * @return void
+ */
+void StringPool::rehash(unsigned int newCapacity) {
+   Entry *oldTable = table;
+   unsigned int oldCapacity = capacity;
+
+   table = (Entry *)calloc(newCapacity, sizeof(Entry));
+   if (table == NULL) {
+      printf("ERROR(SYSTEM): out of memory growing the string pool\n");
+      exit(1);
+   }
+   capacity = newCapacity;
+
+   for (unsigned int i = 0; i < oldCapacity; i++) {
+      if (oldTable[i].str != NULL) {
+         unsigned int slot = oldTable[i].hash & (capacity - 1);
+         while (table[slot].str != NULL) {
+            slot = (slot + 1) & (capacity - 1);
+         }
+         table[slot] = oldTable[i];
+      }
+   }
+
+   free(oldTable);
+}
+
+/*
+ * @brief get the handle for a null terminated string
+ */
+char *StringPool::intern(const char *s) {
+   return intern(s, strlen(s));
+}
+
+/*
+ * @brief get the handle for the first len chars of s. The string is
+ * copied into the arena the first time it is seen.
+ *
+ * @param s - chars of the string, need not be null terminated
+ * @param len - number of chars in the string
+ *
+ * @return interned, null terminated copy of the string
+ */
+char *StringPool::intern(const char *s, size_t len) {
+   unsigned int hash = hashString(s, len);
+   unsigned int slot;
+
+   // keep the table at most half full
+   if (2 * (count + 1) > capacity) {
+      rehash(capacity ? 2 * capacity : POOL_START_CAPACITY);
+   }
+
+   slot = hash & (capacity - 1);
+   while (table[slot].str != NULL) {
+      if (table[slot].hash == hash && table[slot].len == len && memcmp(table[slot].str, s, len) == 0) {
+         return table[slot].str;
+      }
+      slot = (slot + 1) & (capacity - 1);
+   }
+
+   table[slot].str = store->copyString(s, len);
+   table[slot].hash = hash;
+   table[slot].len = len;
+   count++;
+
+   return table[slot].str;
+}
+
+/*
+ * @brief number of distinct strings in the pool
+ */
+unsigned int StringPool::size() {
+   return count;
+}
+
+/*
+ * @brief forget every string. The strings themselves belong to the
+ * arena and go away when it is released.
+ *
+ * @return void
+ */
+void StringPool::clear() {
+   free(table);
+   table = NULL;
+   capacity = 0;
+   count = 0;
+}
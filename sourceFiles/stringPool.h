@@ -0,0 +1,41 @@
+#ifndef _STRINGPOOL_H_
+#define _STRINGPOOL_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Interning table for identifiers and literals. Every distinct
+ * string is stored exactly once in the compile arena and handed out as
+ * a stable char * handle, so two names are the same name exactly when
+ * their handles are the same pointer.
+ *
+ */
+
+#include <stddef.h>
+#include "arena.h"
+
+class StringPool {
+private:
+    struct Entry {
+        char *str;                         // interned copy, NULL if the slot is empty
+        unsigned int hash;                 // full hash of the string
+        unsigned int len;                  // length of the string
+    };
+
+    Arena *store;                          // arena the strings are copied into
+    Entry *table;                          // open addressing table
+    unsigned int capacity;                 // number of slots, always a power of 2
+    unsigned int count;                    // number of slots in use
+
+    void rehash(unsigned int newCapacity); // move every entry into a table of newCapacity slots
+
+public:
+    StringPool(Arena *store);
+    ~StringPool();
+    char *intern(const char *s);           // handle for the null terminated string s
+    char *intern(const char *s, size_t len);  // handle for the first len chars of s
+    unsigned int size();                   // number of distinct strings interned
+    void clear();                          // forget every string (call when the arena is released)
+};
+
+#endif
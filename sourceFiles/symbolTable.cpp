@@ -1,3 +1,7 @@
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include "compilerContext.h"
 #include "symbolTable.h"
 
 // // // // // // // // // // // // // // // // // // // // 
@@ -5,9 +9,7 @@
 // Introduction
 //
 // This symbol table library supplies basic insert and lookup for
-// symbols linked to void * pointers of data. The is expected to use
-// ONLY the SymbolTable class and NOT the Scope class. The Scope class
-// is used by SymbolTable in its implementation.
+// symbols linked to void * pointers of data.
 //
 // Plenty of room for improvement inlcuding: better debugging setup,
 // passing of refs rather than values and purpose built char *
@@ -31,7 +33,7 @@
 //
 
 // print nothing about the pointer
-void pointerPrintNothing(void *data)
+void pointerPrintNothing(void *)
 {
 }
    
@@ -55,108 +57,179 @@ void pointerPrintStr(void *data)
 
 // // // // // // // // // // // // // // // // // // // // 
 //
-// Class: Scope
+// Class: SymbolTable
+//
+//  This is a stack of scopes that represents a symbol table.  The
+//  scopes share one hash table and the stack only records where each
+//  scope starts in the undo log.
 //
 
-Scope::Scope(std::string newname) {
-    name = newname;
+#define INITIAL_SLOTS 256       // must be a power of 2
+
+SymbolTable::SymbolTable()
+{
     debugFlg = false;
+    slots.assign(INITIAL_SLOTS, Slot());
+    slotsUsed = 0;
+    freeBindings = NULL;
+    outer = NULL;
+    outerGlobals = 0;
+    enter((std::string )"Global");
 }
 
 
-Scope::~Scope() {
+// A table whose global scope is the first numGlobals globals of outer.
+// Lookups only read outer so many of these can be used at once.
+SymbolTable::SymbolTable(SymbolTable *outer, size_t numGlobals) : SymbolTable()
+{
+    this->outer = outer;
+    outerGlobals = numGlobals;
 }
 
-// returns char *name of scope
-std::string Scope::scopeName() {
-    return name;
+
+SymbolTable::~SymbolTable()
+{
 }
 
-// set scope debugging
-void Scope::debug(bool state) {
+
+void SymbolTable::debug(bool state)
+{
     debugFlg = state;
 }
 
 
-// print the scope
-void Scope::print(void (*printData)(void *)) {
-    printf("Scope: %-15s -----------------\n", name.c_str());
-    for (std::map<std::string , void *>::iterator it=symbols.begin(); it!=symbols.end(); it++) {
-        printf("%20s: ", (it->first).c_str());
-        printData(it->second);
-        printf("\n");
-    }
-    
+// Returns the number of scopes in the symbol table
+int SymbolTable::depth()
+{
+    return stack.size();
 }
 
 
-// apply the function to each symbol in this scope
-void Scope::applyToAll(void (*action)(std::string , void *)) {
-    for (std::map<std::string , void *>::iterator it=symbols.begin(); it!=symbols.end(); it++) {
-        action(it->first, it->second);
-    }
+// Returns the number of symbols in the global scope
+size_t SymbolTable::numGlobals()
+{
+    return globals.size();
 }
 
 
-// returns true if insert was successful and false if symbol already in this scope
-bool Scope::insert(std::string sym, void *ptr) {
-    if (symbols.find(sym) == symbols.end()) {
-        if (debugFlg) printf("DEBUG(Scope): insert in \"%s\" the symbol \"%s\".\n",
-                             name.c_str(),
-                             sym.c_str());
-        if (ptr==NULL) {
-            printf("ERROR(SymbolTable): Attempting to save a NULL pointer for the symbol '%s'.\n",
-                   sym.c_str());
+// Change how many of the outer globals are seen, for checking the next
+// function on the same table
+void SymbolTable::seeGlobals(size_t numGlobals)
+{
+    outerGlobals = numGlobals;
+}
+
+
+// the slot for sym.  If sym is not in the table yet an empty slot is
+// claimed for it when make is true, otherwise NULL is returned.
+// Handles are interned so the pointer is the key.
+SymbolTable::Slot *SymbolTable::findSlot(const char *sym, bool make)
+{
+    size_t mask, i;
+
+    if (make && 2 * (slotsUsed + 1) > slots.size()) grow();
+
+    mask = slots.size() - 1;
+    i = (size_t)(((uintptr_t)sym * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (slots[i].sym != sym) {
+        if (slots[i].sym == NULL) {
+            if (!make) return NULL;
+            slots[i].sym = sym;
+            slotsUsed++;
+            break;
         }
-        symbols[sym] = ptr;
-        return true;
+        i = (i + 1) & mask;
     }
-    else {
-        if (debugFlg) printf("DEBUG(Scope): insert in \"%s\" the symbol \"%s\" but symbol already there!\n", name.c_str(), sym.c_str());
-        return false;
+
+    return &slots[i];
+}
+
+
+// double the hash table, names with no binding left are dropped
+void SymbolTable::grow()
+{
+    std::vector<Slot> old;
+    size_t mask, i;
+
+    old.swap(slots);
+    slots.assign(old.size() * 2, Slot());
+    mask = slots.size() - 1;
+    slotsUsed = 0;
+    for (size_t j=0; j<old.size(); j++) {
+        if (old[j].top == NULL) continue;
+        i = (size_t)(((uintptr_t)old[j].sym * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        while (slots[i].sym != NULL) i = (i + 1) & mask;
+        slots[i] = old[j];
+        slotsUsed++;
     }
 }
 
-void *Scope::lookup(std::string sym) {
-    if (symbols.find(sym) != symbols.end()) {
-        if (debugFlg) printf("DEBUG(Scope): lookup in \"%s\" for the symbol \"%s\" and found it.\n", name.c_str(), sym.c_str());
-        return symbols[sym];
+
+// a binding from the free list or the pool
+SymbolTable::Binding *SymbolTable::newBinding(const char *sym, void *ptr, int depth, Binding *shadowed)
+{
+    Binding *b;
+
+    if (freeBindings != NULL) {
+        b = freeBindings;
+        freeBindings = b->shadowed;
     }
     else {
-        if (debugFlg) printf("DEBUG(Scope): lookup in \"%s\" for the symbol \"%s\" and did NOT find it.\n", name.c_str(), sym.c_str());
-        return NULL;
+        pool.push_back(Binding());
+        b = &pool.back();
     }
+    b->sym = sym;
+    b->data = ptr;
+    b->depth = depth;
+    b->shadowed = shadowed;
+
+    return b;
 }
 
-bool Scope::debugFlg;
 
+// the global binding of sym if it was one of the first limit globals
+SymbolTable::Binding *SymbolTable::findGlobal(const char *sym, size_t limit)
+{
+    Slot *slot = findSlot(sym, false);
+    Binding *b = slot ? slot->top : NULL;
 
+    while (b != NULL && b->depth != 0) b = b->shadowed;
 
+    return (b != NULL && b->order < limit) ? b : NULL;
+}
 
-// // // // // // // // // // // // // // // // // // // // 
-//
-// Class: SymbolTable
-//
-//  This is a stack of scopes that represents a symbol table
-//
 
-SymbolTable::SymbolTable()
+// the bindings of the scope at depth in alphabetical order so printing
+// and applying do not depend on the order they were made in
+std::vector<SymbolTable::Binding *> SymbolTable::sortedScope(int depth)
 {
-    debugFlg = false;
-    enter((std::string )"Global");
-}
+    std::vector<Binding *> syms;
 
+    if (depth == 0) {
+        syms = globals;
+    }
+    else {
+        size_t end = ((size_t)depth + 1 < stack.size()) ? stack[depth + 1].undoStart : undo.size();
+        syms.assign(undo.begin() + stack[depth].undoStart, undo.begin() + end);
+    }
+    std::sort(syms.begin(), syms.end(),
+              [](Binding *a, Binding *b) { return strcmp(a->sym, b->sym) < 0; });
 
-void SymbolTable::debug(bool state)
-{
-    debugFlg = state;
+    return syms;
 }
 
 
-// Returns the number of scopes in the symbol table
-int SymbolTable::depth()
+// print the scope at depth
+void SymbolTable::printScope(int depth, void (*printData)(void *))
 {
-    return stack.size();
+    std::vector<Binding *> syms = sortedScope(depth);
+
+    printf("Scope: %-15s -----------------\n", stack[depth].name.c_str());
+    for (size_t i=0; i<syms.size(); i++) {
+        printf("%20s: ", syms[i]->sym);
+        printData(syms[i]->data);
+        printf("\n");
+    }
 }
 
 
@@ -164,8 +237,8 @@ int SymbolTable::depth()
 void SymbolTable::print(void (*printData)(void *))
 {
     printf("===========  Symbol Table  ===========\n");
-    for (std::vector<Scope *>::iterator it=stack.begin(); it!=stack.end(); it++) {
-        (*it)->print(printData);
+    for (size_t i=0; i<stack.size(); i++) {
+        printScope(i, printData);
     }
     printf("===========  ============  ===========\n");
 }
@@ -174,17 +247,32 @@ void SymbolTable::print(void (*printData)(void *))
 // Enter a scope
 void SymbolTable::enter(std::string name)                    
 {
+    ScopeMark mark;
+
     if (debugFlg) printf("DEBUG(SymbolTable): enter scope \"%s\".\n", name.c_str());
-    stack.push_back(new Scope(name));
+    mark.name = name;
+    mark.undoStart = undo.size();
+    stack.push_back(mark);
 }
 
 
 // Leave a scope (not allowed to leave global)
+// Only the bindings made in the scope are touched.  They are always
+// the innermost of their names so each one is unlinked from the top.
 void SymbolTable::leave()
 {
-    if (debugFlg) printf("DEBUG(SymbolTable): leave scope \"%s\".\n", (stack.back()->scopeName()).c_str());
+    if (debugFlg) printf("DEBUG(SymbolTable): leave scope \"%s\".\n", stack.back().name.c_str());
     if (stack.size()>1) {
-        delete stack.back();
+        size_t start = stack.back().undoStart;
+
+        while (undo.size() > start) {
+            Binding *b = undo.back();
+
+            findSlot(b->sym, false)->top = b->shadowed;
+            b->shadowed = freeBindings;
+            freeBindings = b;
+            undo.pop_back();
+        }
         stack.pop_back();
     }
     else {
@@ -193,70 +281,134 @@ void SymbolTable::leave()
 }
 
 
+// With debugging on, complain about a symbol that did not come from the StringPool
+// since it can never match anything in the table
+void SymbolTable::checkInterned(const char *sym)
+{
+    if (debugFlg && ctx->stringPool.intern(sym) != sym) {
+        printf("ERROR(SymbolTable): the symbol \"%s\" is not an interned string.\n", sym);
+    }
+}
+
+
 // Lookup a symbol anywhere in the stack of scopes
 // Returns NULL if symbol not found, otherwise it returns the stored void * associated with the symbol
-void * SymbolTable::lookup(std::string sym)
+void * SymbolTable::lookup(const char *sym)
 {
-    void *data;
-    std::string name;
+    Slot *slot;
+    Binding *b;
 
-    data = NULL;  // set even though the scope stack should never be empty
-    for (std::vector<Scope *>::reverse_iterator it=stack.rbegin(); it!=stack.rend(); it++) {
-        data = (*it)->lookup(sym);
-        name = (*it)->scopeName();
-        if (data!=NULL) break;
-    }
+    checkInterned(sym);
+    slot = findSlot(sym, false);
+    b = slot ? slot->top : NULL;
+    if (b == NULL && outer != NULL) b = outer->findGlobal(sym, outerGlobals);
 
     if (debugFlg) {
-        printf("DEBUG(SymbolTable): lookup the symbol \"%s\" and ", sym.c_str());
-        if (data) printf("found it in the scope named \"%s\".\n", name.c_str());
+        printf("DEBUG(SymbolTable): lookup the symbol \"%s\" and ", sym);
+        if (b) printf("found it in the scope named \"%s\".\n", stack[b->depth].name.c_str());
         else printf("did NOT find it!\n");
     }
 
-    return data;
+    return b ? b->data : NULL;
+}
+
+void * SymbolTable::lookup(std::string sym)
+{
+    return lookup(ctx->stringPool.intern(sym.c_str(), sym.size()));
 }
 
 
 // Lookup a symbol in the global scope
 // returns NULL if symbol not found, otherwise it returns the stored void * associated with the symbol
-void * SymbolTable::lookupGlobal(std::string sym)
+void * SymbolTable::lookupGlobal(const char *sym)
 {
-    void *data;
-
-    data = stack[0]->lookup(sym);
-    if (debugFlg) printf("DEBUG(SymbolTable): lookup the symbol \"%s\" in the Globals and %s.\n", sym.c_str(),
-                         (data ? "found it" : "did NOT find it"));
+    Slot *slot;
+    Binding *b;
+
+    checkInterned(sym);
+    slot = findSlot(sym, false);
+    b = slot ? slot->top : NULL;
+    while (b != NULL && b->depth != 0) b = b->shadowed;
+    if (b == NULL && outer != NULL) b = outer->findGlobal(sym, outerGlobals);
+    if (debugFlg) printf("DEBUG(SymbolTable): lookup the symbol \"%s\" in the Globals and %s.\n", sym,
+                         (b ? "found it" : "did NOT find it"));
+
+    return b ? b->data : NULL;
+}
 
-    return data;
+void * SymbolTable::lookupGlobal(std::string sym)
+{
+    return lookupGlobal(ctx->stringPool.intern(sym.c_str(), sym.size()));
 }
 
 
 // Insert a symbol into the most recent scope
 // Returns true if insert was successful and false if symbol already in the most recent scope
-bool SymbolTable::insert(std::string sym, void *ptr)
+bool SymbolTable::insert(const char *sym, void *ptr)
 {
+    Slot *slot;
+    int depth = stack.size() - 1;
+
+    checkInterned(sym);
     if (debugFlg) {
         printf("DEBUG(symbolTable): insert in scope \"%s\" the symbol \"%s\"",
-               (stack.back()->scopeName()).c_str(), sym.c_str());
+               stack.back().name.c_str(), sym);
         if(ptr==NULL) printf(" WARNING: The inserted pointer is NULL!!");
         printf("\n");
     }
 
-    return (stack.back())->insert(sym, ptr);
+    slot = findSlot(sym, true);
+    if (slot->top != NULL && slot->top->depth == depth) return false;
+
+    slot->top = newBinding(sym, ptr, depth, slot->top);
+    slot->top->order = globals.size();
+    if (depth == 0) globals.push_back(slot->top);
+    else undo.push_back(slot->top);
+    if (ptr==NULL) {
+        printf("ERROR(SymbolTable): Attempting to save a NULL pointer for the symbol '%s'.\n", sym);
+    }
+
+    return true;
+}
+
+bool SymbolTable::insert(std::string sym, void *ptr)
+{
+    return insert(ctx->stringPool.intern(sym.c_str(), sym.size()), ptr);
 }
 
 
 // Insert a symbol into the global scope
 // Returns true is insert was successful and false if symbol already in the global scope
-bool SymbolTable::insertGlobal(std::string sym, void *ptr)
+// A global goes at the bottom of its chain, under any bindings of the
+// same name in the scopes that are open.
+bool SymbolTable::insertGlobal(const char *sym, void *ptr)
 {
+    Binding **link;
+
+    checkInterned(sym);
     if (debugFlg) {
-        printf("DEBUG(Scope): insert the global symbol \"%s\"", sym.c_str());
+        printf("DEBUG(Scope): insert the global symbol \"%s\"", sym);
         if(ptr==NULL) printf(" WARNING: The inserted pointer is NULL!!");
         printf("\n");
     }
 
-    return stack[0]->insert(sym, ptr);
+    link = &findSlot(sym, true)->top;
+    while (*link != NULL && (*link)->depth != 0) link = &(*link)->shadowed;
+    if (*link != NULL) return false;
+
+    *link = newBinding(sym, ptr, 0, NULL);
+    (*link)->order = globals.size();
+    globals.push_back(*link);
+    if (ptr==NULL) {
+        printf("ERROR(SymbolTable): Attempting to save a NULL pointer for the symbol '%s'.\n", sym);
+    }
+
+    return true;
+}
+
+bool SymbolTable::insertGlobal(std::string sym, void *ptr)
+{
+    return insertGlobal(ctx->stringPool.intern(sym.c_str(), sym.size()), ptr);
 }
 
 
@@ -264,7 +416,11 @@ bool SymbolTable::insertGlobal(std::string sym, void *ptr)
 // string and the associated pointer.
 void SymbolTable::applyToAll(void (*action)(std::string , void *))
 {
-    stack[stack.size()-1]->applyToAll(action);
+    std::vector<Binding *> syms = sortedScope(stack.size()-1);
+
+    for (size_t i=0; i<syms.size(); i++) {
+        action(syms[i]->sym, syms[i]->data);
+    }
 }
 
 
@@ -272,7 +428,11 @@ void SymbolTable::applyToAll(void (*action)(std::string , void *))
 // string and the associated pointer.
 void SymbolTable::applyToAllGlobal(void (*action)(std::string , void *))
 {
-    stack[0]->applyToAll(action);
+    std::vector<Binding *> syms = sortedScope(0);
+
+    for (size_t i=0; i<syms.size(); i++) {
+        action(syms[i]->sym, syms[i]->data);
+    }
 }
 
 
@@ -302,19 +462,6 @@ void countSymbols(std::string sym, void *ptr) {
 /*
 int main()
 {
-    Scope s("global");
-
-    s.debug(true);
-    s.insert("dog", (char *)"woof");
-    s.insert("cat", (char *)"meow");
-    printf("%s\n", (char *)(s.lookup("cat")));
-    printf("%s\n", (char *)(s.lookup("dog")));
-
-    if (s.lookup("fox")==NULL) printf("not found\n");
-    else printf("found\n");
-    s.print(pointerPrintAddr);
-    s.print(pointerPrintStr);
-
     SymbolTable st;
     st.debug(true);
 
@@ -1,6 +1,6 @@
 #ifndef _SYMBOLTABLE_H_
 #define _SYMBOLTABLE_H_
-#include <map>
+#include <deque>
 #include <vector>
 #include <string>
 #include <stdio.h>
@@ -20,9 +20,7 @@ void pointerPrintStr(void *data);
 // Introduction
 //
 // This symbol table library supplies basic insert and lookup for
-// symbols linked to void * pointers of data. The is expected to use
-// ONLY the SymbolTable class and NOT the Scope class. The Scope class
-// is used by SymbolTable in its implementation.
+// symbols linked to void * pointers of data.
 //
 // Plenty of room for improvement inlcuding: better debugging setup,
 // passing of refs rather than values and purpose built char *
@@ -32,40 +30,17 @@ void pointerPrintStr(void *data);
 // This means the void * cannot have zero as a legal value! Attempting
 // to save a NULL pointer will get a error.
 //
+// Symbols are keyed on the handles handed out by the StringPool
+// (stringPool.h) so comparing two names is comparing two pointers.
+// The char * routines expect an interned handle, the std::string
+// routines intern their argument first.
+//
 // A main() is commented out and has testing code in it.
 //
 // Robert Heckendorn   Apr 3, 2021
 //
 
 
-// // // // // // // // // // // // // // // // // // // // 
-//
-// Class: Scope
-//
-// Helper class for SymbolTable
-//
-
-class Scope {
-private:
-    static bool debugFlg;                      // turn on tedious debugging
-    std::string name;                          // name of scope
-    std::map<std::string , void *> symbols;    // use an ordered map (not as fast as unordered)
-
-public:
-    Scope(std::string newname);
-    ~Scope();
-    std::string scopeName();                   // returns name of scope
-    void debug(bool state);                    // sets the debug flag to state
-    void print(void (*printData)(void *));     // prints the table using the supplied function to print the void *
-    void applyToAll(void (*action)(std::string , void *));  // applies func to all symbol/data pairs 
-    bool insert(std::string sym, void *ptr);   // inserts a new ptr associated with symbol sym 
-                                               // returns false if already defined
-    void *lookup(std::string sym);             // returns the ptr associated with sym
-                                               // returns NULL if symbol not found
-};
-
-
-
 // // // // // // // // // // // // // // // // // // // // 
 //
 // Class: SymbolTable
@@ -73,30 +48,79 @@ public:
 // Is a stack of scopes.   The global scope is created when the table is
 // is constructed and remains for the lifetime of the object instance.
 // SymbolTable manages nested scopes as a result.
+//
+// All scopes share one open addressing hash table keyed on the
+// interned handle.  Each slot heads a chain of the bindings of that
+// name, innermost first, so a lookup is a single probe no matter how
+// deeply scopes are nested.  Each scope remembers where its bindings
+// start in an undo log and leaving it unlinks just those bindings.
+//
+// A table can be made on top of another one to check a function on its
+// own thread.  Its global scope is then the first few globals of the
+// outer table, which must not change while the inner table is in use.
 // 
 
 class SymbolTable {
 private:
-    std::vector<Scope *> stack;
+    struct Binding {
+        const char *sym;                             // interned name
+        void *data;                                  // what the name is bound to
+        int depth;                                   // scope it is in, 0 is global
+        Binding *shadowed;                           // next outer binding of the same name
+        size_t order;                                // position in globals when depth is 0
+    };
+
+    struct Slot {
+        const char *sym;                             // interned name, NULL for an empty slot
+        Binding *top;                                // innermost binding, NULL if none right now
+    };
+
+    struct ScopeMark {
+        std::string name;                            // name of scope
+        size_t undoStart;                            // first entry of undo that belongs to the scope
+    };
+
+    std::vector<Slot> slots;                         // hash table, size is a power of 2
+    size_t slotsUsed;                                // slots with a name in them
+    std::vector<ScopeMark> stack;                    // open scopes, global first
+    std::vector<Binding *> globals;                  // bindings in the global scope
+    std::vector<Binding *> undo;                     // bindings of the nested scopes in the order made
+    std::deque<Binding> pool;                        // storage for every binding
+    Binding *freeBindings;                           // bindings unlinked by leave() ready for reuse
+    SymbolTable *outer;                              // table whose globals this one sees, NULL if none
+    size_t outerGlobals;                             // how many of the outer globals are seen
     bool debugFlg;
 
+    void checkInterned(const char *sym);             // complain about non-interned symbols when debugging
+    Slot *findSlot(const char *sym, bool make);      // slot for sym, NULL if not there unless make
+    void grow();                                     // double the hash table
+    Binding *newBinding(const char *sym, void *ptr, int depth, Binding *shadowed);
+    Binding *findGlobal(const char *sym, size_t limit);  // global binding of sym among the first limit
+    std::vector<Binding *> sortedScope(int depth);   // bindings of a scope in alphabetical order
+    void printScope(int depth, void (*printData)(void *));
+
 public:
     SymbolTable();
+    SymbolTable(SymbolTable *outer, size_t numGlobals);  // sees the first numGlobals globals of outer
+    ~SymbolTable();
     void debug(bool state);                          // sets the debug flags
     int depth();                                     // what is the depth of the scope stack?
+    size_t numGlobals();                             // how many symbols are in the global scope
+    void seeGlobals(size_t numGlobals);              // see the first numGlobals globals of the outer table
     void print(void (*printData)(void *));           // print all scopes using data printing function
     void enter(std::string name);                    // enter a scope with given name
     void leave();                                    // leave a scope (not allowed to leave global)
-    void *lookup(std::string sym);                   // returns ptr associated with sym anywhere in symbol table
-                                                     // returns NULL if symbol not found
-    void *lookupGlobal(std::string sym);             // returns ptr associated with sym in globals
-                                                     // returns NULL if symbol not found
-    bool insert(std::string sym, void *ptr);         // inserts new ptr associated with symbol sym in current scope
-                                                     // returns false if already defined
-    bool insertGlobal(std::string sym, void *ptr);   // inserts a new ptr associated with symbol sym 
-                                                     // returns false if already defined
+    void *lookup(const char *sym);                   // returns ptr associated with sym anywhere in symbol table
+    void *lookup(std::string sym);                   // returns NULL if symbol not found
+    void *lookupGlobal(const char *sym);             // returns ptr associated with sym in globals
+    void *lookupGlobal(std::string sym);             // returns NULL if symbol not found
+    bool insert(const char *sym, void *ptr);         // inserts new ptr associated with symbol sym in current scope
+    bool insert(std::string sym, void *ptr);         // returns false if already defined
+    bool insertGlobal(const char *sym, void *ptr);   // inserts a new ptr associated with symbol sym 
+    bool insertGlobal(std::string sym, void *ptr);   // returns false if already defined
     void applyToAll(void (*action)(std::string , void *));        // apply func to all symbol/data pairs in local scope
     void applyToAllGlobal(void (*action)(std::string , void *));  // apply func to all symbol/data pairs in global scope
+                                                     // both apply in alphabetical order
 };
 
 #endif
@@ -0,0 +1,282 @@
+/*
+ * @author Lance Townsend
+ *
+ * @brief Measures each phase of a compile for bC --time-report. The
+ * scanner runs inside the parse, so its time is collected token by
+ * token and split out of the parse as its own "lex" row. Only the
+ * wall time of the scanner can be measured that way, the cpu and
+ * peak memory of the parse row include the scanner.
+ *
+ */
+
+#include <time.h>
+#include <sys/resource.h>
+#include "timeReport.h"
+#include "arena.h"
+
+TimeReport::TimeReport(Arena *arena) {
+   enabled = false;
+   this->arena = arena;
+   phaseName = NULL;
+   lex = Phase();
+}
+
+/*
+ * @brief start measuring, phases started before this are not reported
+ *
+ * @return void
+ */
+void TimeReport::enable() {
+   enabled = true;
+   sample(first);
+}
+
+/*
+ * @brief read the clocks, the peak resident set and the arena counters
+ *
+ * @param s - where to put them
+ *
+ * @return void
+ */
+void TimeReport::sample(Sample &s) {
+   struct timespec now;
+   struct rusage usage;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   s.wall = now.tv_sec + now.tv_nsec / 1e9;
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+   s.cpu = now.tv_sec + now.tv_nsec / 1e9;
+   getrusage(RUSAGE_SELF, &usage);
+   s.rss = usage.ru_maxrss;
+   s.allocs = arena->allocs();
+   s.bytes = arena->used();
+}
+
+/*
+ * @brief end the phase being measured and start measuring a new one
+ *
+ * @param name - name of the phase starting now, NULL to start none
+ *
+ * @return void
+ */
+void TimeReport::phase(const char *name) {
+   Sample now;
+
+   if (!enabled) {
+      return;
+   }
+
+   sample(now);
+   if (phaseName != NULL) {
+      Phase done;
+
+      done.name = phaseName;
+      done.wall = now.wall - start.wall;
+      done.cpu = now.cpu - start.cpu;
+      done.rss = now.rss - start.rss;
+      done.allocs = now.allocs - start.allocs;
+      done.bytes = now.bytes - start.bytes;
+
+      // the scanner was timed inside this phase, report it on its own
+      if (lex.allocs > 0 || lex.wall > 0) {
+         lex.name = "lex";
+         lex.cpu = -1;
+         lex.rss = -1;
+         phases.push_back(lex);
+         done.wall -= lex.wall;
+         done.allocs -= lex.allocs;
+         done.bytes -= lex.bytes;
+         lex = Phase();
+      }
+      phases.push_back(done);
+   }
+
+   phaseName = name;
+   start = now;
+}
+
+/*
+ * @brief end the phase being measured
+ *
+ * @return void
+ */
+void TimeReport::finish() {
+   phase(NULL);
+}
+
+/*
+ * @brief add time spent in the scanner to the phase being measured
+ *
+ * @param wall - seconds in the scanner
+ * @param allocs - arena allocations made by the scanner
+ * @param bytes - arena bytes handed out to the scanner
+ *
+ * @return void
+ */
+void TimeReport::addLex(double wall, size_t allocs, size_t bytes) {
+   lex.wall += wall;
+   lex.allocs += allocs;
+   lex.bytes += bytes;
+}
+
+/*
+ * @brief record a pass run by the pass manager
+ *
+ * @param name - name of the pass, must live as long as the report
+ * @param wall - seconds the pass took
+ * @param nodesBefore - tree nodes before the pass
+ * @param nodesAfter - tree nodes after the pass
+ * @param ir - the pass works on the IR, the instructions are IR ones
+ * @param instrsBefore - IR or TM instructions before the pass
+ * @param instrsAfter - IR or TM instructions after the pass
+ *
+ * @return void
+ */
+void TimeReport::addPass(const char *name, double wall, size_t nodesBefore, size_t nodesAfter,
+                         bool ir, size_t instrsBefore, size_t instrsAfter) {
+   PassStat pass;
+
+   pass.name = name;
+   pass.wall = wall;
+   pass.nodesBefore = nodesBefore;
+   pass.nodesAfter = nodesAfter;
+   pass.ir = ir;
+   pass.instrsBefore = instrsBefore;
+   pass.instrsAfter = instrsAfter;
+   passes.push_back(pass);
+}
+
+/*
+ * @brief end the current phase and measure everything since enable()
+ *
+ * @return the totals as a phase named total
+ */
+TimeReport::Phase TimeReport::finishTotal() {
+   Phase total;
+   Sample now;
+
+   finish();
+   sample(now);
+   total.name = "total";
+   total.wall = now.wall - first.wall;
+   total.cpu = now.cpu - first.cpu;
+   total.rss = now.rss - first.rss;
+   total.allocs = now.allocs - first.allocs;
+   total.bytes = now.bytes - first.bytes;
+
+   return total;
+}
+
+/*
+ * @brief print one row of the table
+ */
+void TimeReport::printPhase(FILE *out, const Phase &p, double totalWall) {
+   fprintf(out, "%-10s %10.3f (%3.0f%%)", p.name, p.wall * 1e3, (totalWall > 0) ? 100 * p.wall / totalWall : 0.0);
+   if (p.cpu >= 0) fprintf(out, " %10.3f", p.cpu * 1e3);
+   else fprintf(out, " %10s", "-");
+   if (p.rss >= 0) fprintf(out, " %10ld", p.rss);
+   else fprintf(out, " %10s", "-");
+   fprintf(out, " %10zu %12zu\n", p.allocs, p.bytes);
+}
+
+/*
+ * @brief print the time, memory and allocations of each phase
+ *
+ * @param out - stream to print to
+ *
+ * @return void
+ */
+void TimeReport::print(FILE *out) {
+   Phase total;
+
+   if (!enabled) {
+      return;
+   }
+
+   total = finishTotal();
+
+   fprintf(out, "=================  Time Report  =================\n");
+   fprintf(out, "%-10s %17s %10s %10s %10s %12s\n", "phase", "wall ms", "cpu ms", "rss KB", "allocs", "bytes");
+   for (size_t i = 0; i < phases.size(); i++) {
+      printPhase(out, phases[i], total.wall);
+   }
+   printPhase(out, total, total.wall);
+   fprintf(out, "================= ============= =================\n");
+   printPasses(out);
+}
+
+/*
+ * @brief print the time of each pass and how it changed the tree and
+ * the code, IR instructions for the passes on the IR and TM ones for
+ * the rest
+ */
+void TimeReport::printPasses(FILE *out) {
+   if (passes.empty()) {
+      return;
+   }
+
+   fprintf(out, "=================  Pass Report  =================\n");
+   fprintf(out, "%-10s %10s %10s %10s %4s %10s %10s\n", "pass", "wall ms", "nodes", "+/-", "code", "instrs", "+/-");
+   for (size_t i = 0; i < passes.size(); i++) {
+      const PassStat &p = passes[i];
+
+      fprintf(out, "%-10s %10.3f %10zu %+10ld %4s %10zu %+10ld\n", p.name, p.wall * 1e3,
+              p.nodesAfter, (long)p.nodesAfter - (long)p.nodesBefore, p.ir ? "IR" : "TM",
+              p.instrsAfter, (long)p.instrsAfter - (long)p.instrsBefore);
+   }
+   fprintf(out, "================= ============= =================\n");
+}
+
+/*
+ * @brief print one phase as a JSON object, unmeasured values are null
+ */
+void TimeReport::printJsonPhase(FILE *out, const Phase &p) {
+   fprintf(out, "{\"name\": \"%s\", \"wallSeconds\": %.6f, ", p.name, p.wall);
+   if (p.cpu >= 0) fprintf(out, "\"cpuSeconds\": %.6f, ", p.cpu);
+   else fprintf(out, "\"cpuSeconds\": null, ");
+   if (p.rss >= 0) fprintf(out, "\"peakRssDeltaKB\": %ld, ", p.rss);
+   else fprintf(out, "\"peakRssDeltaKB\": null, ");
+   fprintf(out, "\"allocs\": %zu, \"bytes\": %zu}", p.allocs, p.bytes);
+}
+
+/*
+ * @brief print the phases as one JSON object for tools to read
+ *
+ * @param out - stream to print to
+ * @param fileName - file compiled, NULL for standard input
+ *
+ * @return void
+ */
+void TimeReport::printJson(FILE *out, const char *fileName) {
+   Phase total;
+
+   if (!enabled) {
+      return;
+   }
+
+   total = finishTotal();
+
+   fprintf(out, "{\"file\": \"");
+   for (const char *c = (fileName != NULL) ? fileName : "-"; *c; c++) {
+      if (*c == '"' || *c == '\\') fputc('\\', out);
+      fputc(*c, out);
+   }
+   fprintf(out, "\",\n \"phases\": [\n");
+   for (size_t i = 0; i < phases.size(); i++) {
+      fprintf(out, "  ");
+      printJsonPhase(out, phases[i]);
+      fprintf(out, (i + 1 < phases.size()) ? ",\n" : "\n");
+   }
+   fprintf(out, " ],\n \"passes\": [\n");
+   for (size_t i = 0; i < passes.size(); i++) {
+      const PassStat &p = passes[i];
+
+      fprintf(out, "  {\"name\": \"%s\", \"wallSeconds\": %.6f, \"nodesBefore\": %zu, \"nodesAfter\": %zu, "
+              "\"code\": \"%s\", \"instrsBefore\": %zu, \"instrsAfter\": %zu}", p.name, p.wall, p.nodesBefore,
+              p.nodesAfter, p.ir ? "ir" : "tm", p.instrsBefore, p.instrsAfter);
+      fprintf(out, (i + 1 < passes.size()) ? ",\n" : "\n");
+   }
+   fprintf(out, " ],\n \"total\": ");
+   printJsonPhase(out, total);
+   fprintf(out, "\n}\n");
+}
@@ -0,0 +1,75 @@
+#ifndef _TIMEREPORT_H_
+#define _TIMEREPORT_H_
+
+/*
+ * @author Lance Townsend
+ *
+ * @brief Time, peak memory and arena allocations for each phase of a
+ * compile (bC --time-report), and the time and change in tree nodes and
+ * TM instructions of each pass. Nothing is measured unless the report
+ * has been enabled.
+ *
+ */
+
+#include <vector>
+#include <stdio.h>
+#include <stddef.h>
+
+class Arena;
+
+class TimeReport {
+private:
+    struct Phase {
+        const char *name;                  // name of the compiler phase
+        double wall;                       // elapsed seconds
+        double cpu;                        // seconds of cpu on the compiling thread, < 0 if not measured
+        long rss;                          // growth of the peak resident set in KB, < 0 if not measured
+        size_t allocs;                     // arena allocations made
+        size_t bytes;                      // arena bytes handed out
+    };
+
+    struct Sample {
+        double wall;                       // monotonic clock in seconds
+        double cpu;                        // thread cpu clock in seconds
+        long rss;                          // peak resident set in KB
+        size_t allocs;                     // arena allocations so far
+        size_t bytes;                      // arena bytes so far
+    };
+
+    struct PassStat {
+        const char *name;                  // name of the pass
+        double wall;                       // elapsed seconds
+        size_t nodesBefore, nodesAfter;    // tree nodes before and after the pass
+        bool ir;                           // the instructions counted are IR rather than TM
+        size_t instrsBefore, instrsAfter;  // instructions before and after the pass
+    };
+
+    bool enabled;                          // measure anything at all
+    Arena *arena;                          // arena the allocations are counted in
+    std::vector<Phase> phases;             // finished phases
+    const char *phaseName;                 // phase being measured, NULL if none
+    Sample start;                          // when the phase being measured started
+    Sample first;                          // when the first phase started
+    Phase lex;                             // time spent in the scanner during the phase
+    std::vector<PassStat> passes;          // passes run by the pass manager
+
+    void sample(Sample &s);                // read the clocks and counters
+    Phase finishTotal();                   // end the current phase and total everything
+    void printPhase(FILE *out, const Phase &p, double totalWall);
+    void printJsonPhase(FILE *out, const Phase &p);
+    void printPasses(FILE *out);
+
+public:
+    TimeReport(Arena *arena);
+    void enable();                         // start measuring
+    bool isEnabled() { return enabled; }
+    void phase(const char *name);          // end the current phase and start measuring name
+    void finish();                         // end the current phase
+    void addLex(double wall, size_t allocs, size_t bytes);  // scanner time inside the current phase
+    void addPass(const char *name, double wall, size_t nodesBefore, size_t nodesAfter,
+                 bool ir, size_t instrsBefore, size_t instrsAfter);  // a pass finished
+    void print(FILE *out);                 // print a table of the phases
+    void printJson(FILE *out, const char *fileName);  // print the phases as a JSON object
+};
+
+#endif
@@ -11,7 +11,7 @@
 // various "kinds" in the enums that follow
 
 // Kinds of Operators
-// these are the token numbers for the operators same as in flex
+// these are the token numbers for the operators same as in the scanner
 typedef int OpKind;  
 
 // Kinds of Statements
@@ -32,8 +32,8 @@ enum ExpKind {AssignK, CallK, ConstantK, IdK, OpK};
 // Type of variables
 enum ExpType {Void, Integer, Boolean, Char, UndefinedType};
 
-// expected types for operator: 3 unary + 4 binary
-enum ExpectType {OneInt, OneBool, OneArray, IntInt, BoolBool, Equal, ArrayInt};
+// expected types for operator: 3 unary + 4 binary, NoCheck for the rest
+enum ExpectType {OneInt, OneBool, OneArray, IntInt, BoolBool, Equal, ArrayInt, NoCheck};
 
 // expected return types for operator
 enum ReturnType {RetInt, RetBool, RetLHS};
@@ -50,6 +50,7 @@ struct TreeNode
     // connectivity in the tree
     struct TreeNode *child[MAXCHILDREN];   // children of the node
     struct TreeNode *sibling;              // siblings for the node
+    struct TreeNode *lastSibling;          // tail of the sibling list this node heads (addSibling)
     int nodeNum;                           // unique node number for DOT PLOTS
 
     // what kind of node
@@ -80,6 +81,8 @@ struct TreeNode
 
     // extra stuff inferred about the node
     VarKind varKind;                       // global, local, localStatic, parameter
+    struct TreeNode *decl;                 // declaration an IdK or CallK refers to, NULL if undeclared
+    bool isResolved;                       // has decl been looked up yet?
     int offset;                            // offset for address of object
     int size;                              // used for size of array
 };
@@ -7,7 +7,9 @@
  */
 
 #include <string.h>
+#include <vector>
 #include "treeUtils.h"
+#include "compilerContext.h"
 #include "semantics.h"
 #include "parser.tab.h"
 
@@ -15,7 +17,6 @@
 
 // GLOBALS
 char *largerTokens[LASTTERM+1];
-char expTypeToStrBuffer[80];
 
 // function prototypes
 char *expToStr(ExpType type, bool isStatic, bool isArray);
@@ -29,9 +30,9 @@ TreeNode* addSibling(TreeNode* t, TreeNode* s);
 void setType(ExpType eType, TreeNode* tree, bool isStatic);
 static void printSpaces(FILE *listing, int depth);
 char *expToStr(ExpType type, bool isStatic, bool isArray);
-void printTreeNode(FILE *listing, TreeNode *tree, bool showExpType, bool showAlloc);
-void printTreeRec(FILE *listing, int depth, int siblingCnt, TreeNode *tree, bool showExpType, bool showAlloc);
-void printTree(FILE *listing, TreeNode *tree, bool showExpType, bool showAlloc);
+void printTreeNode(FILE *listing, TreeNode *tree);
+void printTreeRec(FILE *listing, int depth, int siblingCnt, TreeNode *tree);
+void printTree(FILE *listing, TreeNode *tree);
 char *varKindToString(int kind);
 void showAllocation(FILE *out, TreeNode *tnode);
 
@@ -54,6 +55,7 @@ void initTokenStrings() {
    largerTokens[DIVASS] = (char *)"/=";
    largerTokens[DO] = (char *)"do";
    largerTokens[ELSE] = (char *)"else";
+   largerTokens[EQ] = (char *)"==";
    largerTokens[FOR] = (char *)"for";
    largerTokens[GEQ] = (char *)">=";
    largerTokens[ID] = (char *)"id";
@@ -78,10 +80,22 @@ void initTokenStrings() {
    largerTokens[WHILE] = (char *)"while";
    largerTokens[LASTTERM] = (char *)"lastterm";
 
+   // operators that are a single character are their own token number
+   largerTokens['%'] = (char *)"%";
+   largerTokens['*'] = (char *)"*";
+   largerTokens['+'] = (char *)"+";
+   largerTokens['-'] = (char *)"-";
+   largerTokens['/'] = (char *)"/";
+   largerTokens['<'] = (char *)"<";
+   largerTokens['='] = (char *)"=";
+   largerTokens['>'] = (char *)">";
+   largerTokens['?'] = (char *)"?";
+   largerTokens['['] = (char *)"[";
+
 }
 
 /*
- * @brief Creates a new node and initializes its children
+ * @brief Creates a new node in the compile arena and initializes its children
  *
  * @param c0, c1, c2 - child nodes to add to new node
  * @param token - data about the node to be initialized
@@ -89,7 +103,7 @@ void initTokenStrings() {
  * @return new node created
  */
 TreeNode* initNewNode(TreeNode *c0, TreeNode *c1, TreeNode *c2, TokenData *token) {
-   TreeNode *newNode = new TreeNode;
+   TreeNode *newNode = ctx->arena.make<TreeNode>();
 
    newNode->child[0] = c0;
    newNode->child[1] = c1;
@@ -110,6 +124,8 @@ TreeNode* initNewNode(TreeNode *c0, TreeNode *c1, TreeNode *c2, TokenData *token
    newNode->isConst = false;
    newNode->isUsed = false;
    newNode->isAssigned = false;
+   newNode->decl = NULL;
+   newNode->isResolved = false;
    newNode->size = 1;
 
    return newNode;
@@ -175,7 +191,9 @@ TreeNode *newExpNode(ExpKind kind, TokenData *token, TreeNode *c0, TreeNode *c1,
 }
 
 /*
- * @brief add a sibling to the node
+ * @brief add a sibling to the node. The head of the list remembers
+ * its last node so the left recursive lists in the grammar are built
+ * in linear time instead of walking the whole list on every append.
  *
  * @param t - node to add the sibling to 
  * @param s - sibling to be added to t
@@ -192,11 +210,13 @@ TreeNode* addSibling(TreeNode* t, TreeNode* s) {
       return s;
    }
 
-   TreeNode *tmp = t;
+   // start from the remembered tail, s may itself have been a list
+   TreeNode *tmp = (t->lastSibling != NULL) ? t->lastSibling : t;
    while (tmp->sibling != NULL) {
       tmp = tmp->sibling;
    }
    tmp->sibling = s;
+   t->lastSibling = (s->lastSibling != NULL) ? s->lastSibling : s;
    return t;
 }
 
@@ -227,35 +247,40 @@ static void printSpaces(FILE *listing, int depth)
 }
 
 /*
- * @brief Turn the expression type into a string
+ * @brief name of a type as messages show it, "type int"
  *
- * @return expression type as a string
+ * @return the name, a constant string
  */
-char *expToStr(ExpType type, bool isStatic, bool isArray) {
-   char *typeName;
+const char *typeName(ExpType type) {
    switch (type) {
       case Void:
-         typeName = (char *)"type void";
-         break;
+         return "type void";
       case Integer:
-         typeName = (char *)"type int";
-         break;
+         return "type int";
       case Boolean:
-         typeName = (char *)"type bool";
-         break;
+         return "type bool";
       case Char:
-         typeName = (char *)"type char";
-         break;
+         return "type char";
       case UndefinedType:
-         typeName = (char *)"type UndefinedType";
-         break;
+         return "type UndefinedType";
    }
 
+   return "type UndefinedType";
+}
+
+/*
+ * @brief Turn the expression type into a string
+ *
+ * @return expression type as a string
+ */
+char *expToStr(ExpType type, bool isStatic, bool isArray) {
+   char expTypeToStrBuffer[80];
+
    snprintf(expTypeToStrBuffer, 80, "%s%s%s", 
          (isStatic ? "static " : ""),
-         (isArray ? "array of " : ""), typeName);
+         (isArray ? "array of " : ""), typeName(type));
 
-   return strdup(expTypeToStrBuffer); // memory leak
+   return ctx->arena.copyString(expTypeToStrBuffer);
 }
 
 /*
@@ -263,7 +288,7 @@ char *expToStr(ExpType type, bool isStatic, bool isArray) {
  *
  * @return void
  */
-void printTreeNode(FILE *listing, TreeNode *tree, bool showExpType, bool showAlloc) {
+void printTreeNode(FILE *listing, TreeNode *tree) {
    if (tree == NULL) {
       fprintf(listing, "DEBUG: Cannot print NULL tree\ttreeUtils.cpp::printTreeNode");
       return;
@@ -343,45 +368,71 @@ void printTreeNode(FILE *listing, TreeNode *tree, bool showExpType, bool showAll
 }
 
 /*
- * @brief Recursively print out the AST
+ * @brief Print out the AST. The nodes whose children are still being
+ * printed are kept on an explicit stack and a sibling replaces the node
+ * before it, so deep trees and long lists cannot run out of C stack.
  *
  * @param listing - stream to output to
  * @param depth - depth of the node currently being visited
  * @param siblingCnt - count of siblings
  * @param tree - tree node to print out
- * @param showExpType, showAlloc - debugging parameters
  *
  * @return void
  */
-void printTreeRec(FILE *listing, int depth, int siblingCnt, TreeNode *tree, bool showExpType, bool showAlloc)
+void printTreeRec(FILE *listing, int depth, int siblingCnt, TreeNode *tree)
 {
+   struct Level {
+      TreeNode *tree;                     // node whose children are being printed
+      int depth;                          // its depth
+      int siblingCnt;                     // its number in its list of siblings
+      int childCnt;                       // next child to look at
+   };
+   std::vector<Level> stack;
+
    if (tree == NULL) {
       return;
    }
 
-   int childCnt;
-   if (tree!=NULL) {
-      // print self
-      printTreeNode(listing, tree, showExpType, showAlloc);
-      fprintf(listing, "\n");
-
-      // print children
-      for (childCnt = 0; childCnt<MAXCHILDREN; childCnt++) {
-         if (tree->child[childCnt]) {
-            printSpaces(listing, depth);
-            fprintf(listing, "Child: %d  ", childCnt);
-            printTreeRec(listing, depth+1, 1, tree->child[childCnt], showExpType, showAlloc);
-         }
+   // print self
+   printTreeNode(listing, tree);
+   fprintf(listing, "\n");
+   stack.push_back(Level{tree, depth, siblingCnt, 0});
+
+   while (!stack.empty()) {
+      Level &level = stack.back();
+      int childCnt = level.childCnt;
+
+      // print the next child
+      while (childCnt < MAXCHILDREN && level.tree->child[childCnt] == NULL) {
+         childCnt++;
       }
-   }
-   // print sibling
-   tree = tree->sibling;
-   if (tree!=NULL) {
-      if (depth) {
-         printSpaces(listing, depth-1);
-         fprintf(listing, "Sibling: %d  ", siblingCnt);
+      if (childCnt < MAXCHILDREN) {
+         TreeNode *child = level.tree->child[childCnt];
+         int childDepth = level.depth + 1;
+
+         level.childCnt = childCnt + 1;
+         printSpaces(listing, level.depth);
+         fprintf(listing, "Child: %d  ", childCnt);
+         printTreeNode(listing, child);
+         fprintf(listing, "\n");
+         stack.push_back(Level{child, childDepth, 1, 0});
+         continue;
+      }
+
+      // print sibling
+      tree = level.tree->sibling;
+      depth = level.depth;
+      siblingCnt = level.siblingCnt;
+      stack.pop_back();
+      if (tree != NULL) {
+         if (depth) {
+            printSpaces(listing, depth-1);
+            fprintf(listing, "Sibling: %d  ", siblingCnt);
+         }
+         printTreeNode(listing, tree);
+         fprintf(listing, "\n");
+         stack.push_back(Level{tree, depth, siblingCnt+1, 0});
       }
-      printTreeRec(listing, depth, siblingCnt+1, tree, showExpType, showAlloc);
    }
    fflush(listing);
 }
@@ -391,17 +442,16 @@ void printTreeRec(FILE *listing, int depth, int siblingCnt, TreeNode *tree, bool
  *
  * @param listing - stream to output to
  * @param tree - tree node to print out
- * @param showExpType, showAlloc - debugging parameters
  *
  * @return void
  */
-void printTree(FILE *listing, TreeNode *tree, bool showExpType, bool showAlloc)
+void printTree(FILE *listing, TreeNode *tree)
 {
    if(tree == NULL){
-      printf("NULL tree");
+      fprintf(listing, "NULL tree");
       return;
    }
-   printTreeRec(listing, 1, 1, tree, showExpType, showAlloc);
+   printTreeRec(listing, 1, 1, tree);
 }
 
 /*
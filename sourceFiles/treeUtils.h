@@ -28,15 +28,16 @@ TreeNode *newExpNode(ExpKind kind,
 
 // Turn the expression type into a string
 char *expToStr(ExpType type, bool isStatic, bool isArray);
+const char *typeName(ExpType type);
 
 // Return a string containing the name of the variable kind
 char *varKindToString(int kind);
 
 // Print out the tree node
-void printTreeNode(FILE *out, TreeNode *syntaxTree, bool showExpType, bool showAlloc);
+void printTreeNode(FILE *out, TreeNode *syntaxTree);
 
 // Print out the AST
-void printTree(FILE *out, TreeNode *syntaxTree, bool showExpType, bool showAlloc);
+void printTree(FILE *out, TreeNode *syntaxTree);
 
 // Initializes token strings for easy conversion
 void initTokenStrings();
@@ -1,67 +1,33 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
+#include "compilerContext.h"
 #include "yyerror.h"
 
 // // // // // // // // // // // // // // // // // // // // 
 //
 // Error message printing
 //
-// Must make messages look nice.  For example:
-// msg = "syntax error, unexpected ',', expecting BOOL or CHAR or INT or ID."
-// becomes (xx marks important data):
-//  0 syntax
-//  1 error,
-//  2 unexpected
-//  3 ',',    xx
-//  4 expecting
-//  5 BOOL    xx
-//  6 or
-//  7 CHAR    xx
-//  8 or
-//  9 INT     xx
-// 10 or
-// 11 ID.     xx
-
-// assumes a string with breakchar separating each element.
-// breakchars will be replaced by null chars: '\0'
-// array of pointers to strings is then returned in
-// the array strs which must be allocated by the user!
-// the number of strings found is returned as a value of
-// the function.  This number is always at least 1.
-// The array is terminated by a NULL so there must be
-// enough room for all the string pointers plus one for the
-// sentinal marker.
-static int split(char *s, char *strs[], char breakchar)
-{
-    int num;
-    
-    strs[0] = s;
-    num = 1;
-    for (char *p = s; *p; p++) {
-        if (*p==breakchar) {
-            strs[num++] = p+1;
-            *p = '\0';
-        }
-    }
-    strs[num] = NULL;
-    
-    return num;
-}
+// Must make messages look nice.  For example Bison's names for
+// the tokens in
+//    unexpected ',', expecting BOOL or CHAR or INT or ID
+// become
+//    unexpected ',', expecting "bool" or "char" or "int" or identifier.
+// with the expected tokens sorted.  The nice name of every token is
+// worked out once by initErrorProcessing so nothing is split or looked
+// up when an error is reported.
 
-
-// trim off the last character
-static void trim(char *s)
-{
-    s[strlen(s)-1] = '\0';
-}
 // map from string to char * for storing nice translation of
 // internal names for tokens.  Preserves (char *) used by
 // bison.
 static std::map<std::string , char *> niceTokenNameMap;    // use an ordered map (not as fast as unordered)
 
+static void initNiceNames();
+
 // WARNING: this routine must be called to initialize mapping of
 // (strings returned as error message) --> (human readable strings)
 //
@@ -104,17 +70,23 @@ void initErrorProcessing() {
     niceTokenNameMap["TO"] = (char *)"\"to\"";
     niceTokenNameMap["WHILE"] = (char *)"\"while\"";
     niceTokenNameMap["$end"] = (char *)"end of input";
+    niceTokenNameMap["end of file"] = (char *)"end of input";
+
+    initNiceNames();
 }
 
 
+// nice name of each of Bison's symbols and whether the text of the
+// token is shown after it, indexed by symbol number
+static std::vector<const char *> niceNames;
+static std::vector<bool> showsToken;
+
 // looks of pretty printed words for tokens that are
 // not already in single quotes.  It uses the niceTokenNameMap table.
-static char *niceTokenStr(char *tokenName ) {
+static const char *niceTokenStr(const char *tokenName) {
     if (tokenName[0] == '\'') return tokenName;
     if (niceTokenNameMap.find(tokenName) == niceTokenNameMap.end()) {
-        printf("ERROR(SYSTEM): niceTokenStr fails to find string '%s'\n", tokenName); 
-        fflush(stdout);
-        exit(1);
+        return tokenName;   // never expected or unexpected, e.g. FIRSTOP
     }
     return niceTokenNameMap[tokenName];
 }
@@ -123,72 +95,73 @@ static char *niceTokenStr(char *tokenName ) {
 // Is this a message that we need to elaborate with the current parsed token.
 // This elaboration is some what of a crap shoot since the token could
 // be already overwritten with a look ahead token.   But probably not.
-static bool elaborate(char *s)
+static bool elaborate(const char *s)
 {
     return (strstr(s, "constant") || strstr(s, "identifier"));
 }
 
 
-// A tiny sort routine for SMALL NUMBERS of
-// of char * elements.  num is the total length
-// of the array but only every step elements will
-// be sorted.  The "up" flag is direction of sort.
-// For example:
-//    tinySort(str, i, 2, direction);      // sorts even number elements in array
-//    tinySort(str+1, i-1, 2, direction);  // sorts odd number elements in array
-//    tinySort(str, i, 1, direction);      // sorts all elements in array
-//
-static void tinySort(char *base[], int num, int step, bool up)
+// translate the name of every symbol once
+static void initNiceNames()
 {
-    for (int i=step; i<num; i+=step) {
-        for (int j=0; j<i; j+=step) {
-            if (up ^ (strcmp(base[i], base[j])>0)) {
-                char *tmp;
-                tmp = base[i]; base[i] = base[j]; base[j] = tmp;
-            }
-        }
+    int num = numParserSymbols();
+
+    niceNames.resize(num);
+    showsToken.resize(num);
+    for (int i=0; i<num; i++) {
+        niceNames[i] = niceTokenStr(parserSymbolName(i));
+        showsToken[i] = elaborate(niceNames[i]);
     }
 }
 
 
-// This is the yyerror called by the bison parser for errors.
-// It only does errors and not warnings.   
-void yyerror(const char *msg)
+// Called by the parser (yyreport_syntax_error in parser.y) with the
+// unexpected token and the expected ones as Bison symbol numbers.
+void syntaxError(int unexpected, const int *expected, int numExpected)
 {
-    char *space;
-    char *strs[100];
-    int numstrs;
+    std::vector<const char *> names;
 
-    // make a copy of msg string
-    space = strdup(msg);
-
-    // split out components
-    numstrs = split(space, strs, ' ');
-    if (numstrs>4) trim(strs[3]);
-
-    // translate components
-    for (int i=3; i<numstrs; i+=2) {
-        strs[i] = niceTokenStr(strs[i]);
+    // no lookahead token to complain about
+    if (unexpected < 0 || unexpected >= (int)niceNames.size()) {
+        bc::diagnose(bc::SyntaxError, ctx->line);
+        return;
     }
 
-    // print components
-    printf("SYNTAX ERROR(%d): unexpected %s", line, strs[3]);
-    if (elaborate(strs[3])) {
-        if (lastToken[0]=='\'' || lastToken[0]=='"') printf(" %s", lastToken); 
-        else printf(" \"%s\"", lastToken);
+    // print sorted list of expected
+    for (int i=0; i<numExpected; i++) {
+        names.push_back(niceNames[expected[i]]);
     }
+    std::sort(names.begin(), names.end(), [](const char *a, const char *b) { return strcmp(a, b) < 0; });
 
-    if (numstrs>4) printf(",");
+    // the text of the token is shown after the names of constants
+    // and identifiers
+    std::vector<bc::DiagArg> args;
+    bool elaborated = showsToken[unexpected];
 
-    // print sorted list of expected
-    tinySort(strs+5, numstrs-5, 2, true); 
-    for (int i=4; i<numstrs; i++) {
-        printf(" %s", strs[i]);
+    args.push_back(niceNames[unexpected]);
+    if (elaborated) args.push_back(ctx->lastToken);
+    args.insert(args.end(), names.begin(), names.end());
+
+    if (numExpected == 0) {
+        bc::diagnose(elaborated ? bc::UnexpectedToken : bc::Unexpected, ctx->line, args.data(), args.size());
     }
-    printf(".\n");
-    fflush(stdout);   // force a dump of the error
+    else {
+        bc::diagnose(elaborated ? bc::UnexpectedTokenExpecting : bc::UnexpectedExpecting, ctx->line, args.data(), args.size());
+    }
+}
+
 
-    numErrors++;      // count the number of errors
+// This is the yyerror called by the bison parser for errors other than
+// syntax errors, which go to syntaxError.  It only does errors and not
+// warnings.
+void yyerror(void *, const char *msg)
+{
+    // the parser ran out of stack (YYMAXDEPTH in parser.y), there is
+    // no token to point at
+    if (strcmp(msg, "memory exhausted") == 0) {
+        bc::diagnose(bc::NestedTooDeeply, ctx->line);
+        return;
+    }
 
-    free(space);
+    bc::diagnose(bc::InternalError, ctx->line, {msg});
 }
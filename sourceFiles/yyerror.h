@@ -1,15 +1,18 @@
 #ifndef _YYERROR_H_
 #define _YYERROR_H_
 
-// write a nice error message
-#define YYERROR_VERBOSE
+// NOTE: the line number and last token come from the compiler context
+// (ctx->line and ctx->lastToken), errors are reported with bc::diagnose
 
-// NOTE: make sure these variables interface with your code!!!
-extern int line;        // line number of last token scanned in your scanner (.l)
-extern char *lastToken; // last token scanned in your scanner (connect to your .l)
-extern int numErrors;   // number of errors
+void initErrorProcessing();    // WARNING: MUST be called before any errors occur (bc::initTables does this)!
+void yyerror(void *scanner, const char *msg); // error routine called by the pure Bison parser
 
-void initErrorProcessing();    // WARNING: MUST be called before any errors occur (near top of main)!
-void yyerror(const char *msg); // error routine called by Bison
+// report a syntax error, the tokens are Bison's symbol numbers and
+// unexpected is negative when the parser has no lookahead
+void syntaxError(int unexpected, const int *expected, int numExpected);
+
+// Bison's own names for its symbols, from parser.y
+int numParserSymbols();
+const char *parserSymbolName(int symbol);
 
 #endif
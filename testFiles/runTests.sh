@@ -0,0 +1,75 @@
+#!/bin/bash
+#
+# Regression tests of the compiler, run by make check.
+#
+#   runTests.sh [bC]
+#
+# Every program in regress/ is compiled at each -O level and run on the
+# TM simulator with the inputs in its .in file, if it has one, and what
+# it outputs is compared with its .out file. The other programs here
+# that compile without errors are run the same way and what they output
+# at each level compared with what they output at -O0. The last level
+# is every IR pass with the codegen that keeps no value in a register.
+#
+
+dir=$(cd "$(dirname "$0")" && pwd)
+bc=${1:-$dir/../sourceFiles/bC}
+levels=${LEVELS:-"-O0 -O1 -O2 --passes=intrinsics,forloop,licm,inline,codegen"}
+export TMLIMIT=${TMLIMIT:-2000000}
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+passed=0
+failed=0
+
+# compile a program with the options given and run it, the output goes
+# to $work/out and what went wrong to $work/err
+runProgram() {
+   local src=$1 opts=$2 inputs=
+
+   [ -f "${src%.bC}.in" ] && inputs=$(cat "${src%.bC}.in")
+   : > "$work/err"
+   "$bc" $opts "$src" > "$work/p.tm" 2>> "$work/err" || return 1
+   if ! grep -q "^Number of errors: 0" "$work/p.tm"; then
+      grep "ERROR" "$work/p.tm" >> "$work/err"
+      return 1
+   fi
+   python3 "$dir/tm.py" "$work/p.tm" $inputs > "$work/out" 2>> "$work/err"
+}
+
+# record the result of one test
+check() {
+   local name=$1 ok=$2
+
+   if [ "$ok" = yes ]; then
+      passed=$((passed + 1))
+   else
+      failed=$((failed + 1))
+      echo "FAIL $name"
+      sed 's/^/   /' "$work/err" | grep -v "^   steps" | head -5
+   fi
+}
+
+for src in "$dir"/regress/*.bC; do
+   for opts in $levels; do
+      ok=no
+      if runProgram "$src" "$opts" && cmp -s "$work/out" "${src%.bC}.out"; then
+         ok=yes
+      elif [ -s "$work/out" ] || [ ! -s "$work/err" ]; then
+         echo "output was: $(head -c 200 "$work/out")" >> "$work/err"
+      fi
+      check "regress/$(basename "$src") $opts" $ok
+   done
+done
+
+for src in "$dir"/*.bC; do
+   runProgram "$src" -O0 || continue
+   mv "$work/out" "$work/expected"
+   for opts in $levels; do
+      ok=no
+      runProgram "$src" "$opts" && cmp -s "$work/out" "$work/expected" && ok=yes
+      check "$(basename "$src") $opts" $ok
+   done
+done
+
+echo "$passed passed, $failed failed"
+[ $failed -eq 0 ]
@@ -0,0 +1,50 @@
+#!/bin/bash
+#
+# Checks that two builds of the scanner make the same tokens.
+#
+#   scanDiff.sh bC bC
+#
+# The two compilers are for instance an SSE2 and an AVX2 build, or one
+# from before a change to the scanner and one after. The -T tokens of
+# every program in testFiles and of the stress inputs of bench/gen.py
+# must be the same, the diff of the first few that are not is printed.
+#
+
+dir=$(cd "$(dirname "$0")" && pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+passed=0
+failed=0
+
+if [ $# -ne 2 ]; then
+   echo "usage: scanDiff.sh bC bC"
+   exit 2
+fi
+a=$1
+b=$2
+
+# stress inputs, long tokens, bad characters and block boundaries
+mkdir "$work/in"
+for seed in 1 2 3 4 5; do
+   python3 "$dir/../bench/gen.py" scan $((seed * 40)) $seed > "$work/in/scan$seed.bC"
+done
+printf 'int x' > "$work/in/noNewline.bC"
+printf '' > "$work/in/empty.bC"
+printf '"never closed\n' > "$work/in/openString.bC"
+
+for f in "$dir"/*.bC "$dir"/regress/*.bC "$work"/in/*.bC; do
+   "$a" -T "$f" > "$work/a" 2> /dev/null
+   "$b" -T "$f" > "$work/b" 2> /dev/null
+   if cmp -s "$work/a" "$work/b"; then
+      passed=$((passed + 1))
+   else
+      failed=$((failed + 1))
+      if [ $failed -le 3 ]; then
+         echo "DIFF $(basename "$f")"
+         diff "$work/a" "$work/b" | head -10 | sed 's/^/   /'
+      fi
+   fi
+done
+
+echo "$passed same, $failed differ"
+[ $failed -eq 0 ]
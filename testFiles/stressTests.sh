@@ -0,0 +1,58 @@
+#!/bin/bash
+#
+# Stress tests of the compiler, run by make check.
+#
+#   stressTests.sh [bC]
+#
+# For each N in SIZES (default 5000 20000) bench/gen.py nest makes a
+# main nesting if, while, blocks and parentheses N deep and then N
+# loops one after another. It is compiled at each level in LEVELS
+# (default -O0 and -O2) and must compile without errors in at most
+# TIME_LIMIT (default 10) seconds and MB_LIMIT (default 1024)
+# megabytes. These compile in a second or two, a pass whose work grows
+# with the square of the nesting or of the loops takes minutes.
+#
+
+dir=$(cd "$(dirname "$0")" && pwd)
+bc=${1:-$dir/../sourceFiles/bC}
+sizes=${SIZES:-"5000 20000"}
+levels=${LEVELS:-"-O0 -O2"}
+seconds=${TIME_LIMIT:-10}
+mb=${MB_LIMIT:-1024}
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+passed=0
+failed=0
+
+# compile a program, print the wall seconds and the megabytes it took,
+# stopping it past the time limit
+measure() {
+   python3 - "$seconds" "$work/p.tm" "$@" <<'END'
+import resource, subprocess, sys, time
+limit, out = float(sys.argv[1]), open(sys.argv[2], 'w')
+start = time.time()
+try:
+    subprocess.run(sys.argv[3:], stdout=out, stderr=subprocess.DEVNULL, timeout=limit)
+except subprocess.TimeoutExpired:
+    pass
+used = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss // 1024
+print('%.2f %d' % (time.time() - start, used))
+END
+}
+
+for n in $sizes; do
+   python3 "$dir/../bench/gen.py" nest $n > "$work/nest.bC"
+   for opts in $levels; do
+      result=($(measure "$bc" $opts "$work/nest.bC"))
+      if grep -q "^Number of errors: 0" "$work/p.tm" &&
+            awk -v t=${result[0]} -v m=${result[1]} -v ts=$seconds -v ms=$mb 'BEGIN {exit !(t <= ts && m <= ms)}'; then
+         passed=$((passed + 1))
+      else
+         failed=$((failed + 1))
+         echo "FAIL nest $n $opts: ${result[0]} s, ${result[1]} MB, limits $seconds s and $mb MB"
+      fi
+   done
+done
+
+echo "$passed passed, $failed failed"
+[ $failed -eq 0 ]
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+#
+# A small simulator of the TM machine, enough of it to run the code bC
+# emits and check what the programs output.
+#
+#   tm.py file.tm [input ...]
+#
+# The inputs are the values read by input(), inputb() and inputc() in
+# turn, 0 once they run out. OUT prints the number and a space, OUTB T
+# or F and a space, OUTC the character and OUTNL a newline. The number
+# of instructions run goes to stderr as "steps N". The run stops with
+# status 1 on a bad instruction or address, a division by zero or after
+# TMLIMIT instructions (default 10000000).
+#
+
+import os
+import re
+import sys
+
+DMEM = 10000                               # words of data memory
+RM_OPS = ('LD', 'LDA', 'LDC', 'ST', 'JMP', 'JZR', 'JNZ')
+
+
+def load(path):
+    imem = {}
+    lits = []
+    for line in open(path, errors='replace'):
+        if line.startswith('*'):
+            continue
+        m = re.match(r'\s*(\d+):\s+LIT\s+"(.*)"\s*$', line)
+        if m:
+            lits.append((int(m.group(1)), m.group(2)))
+            continue
+        m = re.match(r'\s*(\d+):\s+(\w+)\s+(-?\d+),(-?\d+)\((-?\d+)\)', line)
+        if m:
+            imem[int(m.group(1))] = (m.group(2), int(m.group(3)), int(m.group(4)), int(m.group(5)))
+            continue
+        m = re.match(r'\s*(\d+):\s+(\w+)\s+(-?\d+),(-?\d+),(-?\d+)', line)
+        if m:
+            imem[int(m.group(1))] = (m.group(2), int(m.group(3)), int(m.group(4)), int(m.group(5)))
+    return imem, lits
+
+
+def unescape(s):
+    out = []
+    i = 0
+    while i < len(s):
+        if s[i] == '\\' and i + 1 < len(s):
+            out.append({'n': '\n', '0': '\0', 't': '\t'}.get(s[i + 1], s[i + 1]))
+            i += 2
+        else:
+            out.append(s[i])
+            i += 1
+    return ''.join(out)
+
+
+def run(path, inputs, limit):
+    imem, lits = load(path)
+    d = [0] * (DMEM + 1)
+    for addr, s in lits:
+        s = unescape(s)
+        base = DMEM - addr
+        d[base + 1] = len(s)
+        for i, ch in enumerate(s):
+            d[base - i] = ord(ch)
+    reg = [0] * 8
+    reg[0] = DMEM
+    out = []
+    steps = 0
+    rnd = 12345
+
+    while True:
+        pc = reg[7]
+        if pc not in imem:
+            return out, steps, 'bad pc %d' % pc
+        op, r, s, t = imem[pc]
+        reg[7] = pc + 1
+        steps += 1
+        if steps > limit:
+            return out, steps, 'limit'
+        try:
+            if op in RM_OPS:
+                a = s + reg[t]
+                if op in ('LD', 'ST') and not 0 <= a <= DMEM:
+                    return out, steps, 'bad address %d' % a
+            else:
+                S, T = reg[s], reg[t]
+
+            # register-memory instructions
+            if op == 'LD':
+                reg[r] = d[a]
+            elif op == 'LDA':
+                reg[r] = a
+            elif op == 'LDC':
+                reg[r] = s
+            elif op == 'ST':
+                d[a] = reg[r]
+            elif op == 'JMP':
+                reg[7] = a
+            elif op == 'JZR':
+                if reg[r] == 0:
+                    reg[7] = a
+            elif op == 'JNZ':
+                if reg[r] != 0:
+                    reg[7] = a
+            # register-only instructions
+            elif op == 'HALT':
+                return out, steps, 'ok'
+            elif op in ('IN', 'INB', 'INC'):
+                reg[r] = inputs.pop(0) if inputs else 0
+            elif op == 'OUT':
+                out.append('%d ' % reg[r])
+            elif op == 'OUTB':
+                out.append('T ' if reg[r] else 'F ')
+            elif op == 'OUTC':
+                out.append(chr(reg[r] & 0x10ffff))
+            elif op == 'OUTNL':
+                out.append('\n')
+            elif op == 'ADD':
+                reg[r] = S + T
+            elif op == 'SUB':
+                reg[r] = S - T
+            elif op == 'MUL':
+                reg[r] = S * T
+            elif op in ('DIV', 'MOD'):
+                if T == 0:
+                    return out, steps, 'division by zero'
+                q, m = abs(S) // abs(T), abs(S) % abs(T)
+                if op == 'DIV':
+                    reg[r] = q if (S >= 0) == (T >= 0) else -q
+                else:
+                    reg[r] = m if S >= 0 else -m
+            elif op == 'AND':
+                reg[r] = S & T
+            elif op == 'OR':
+                reg[r] = S | T
+            elif op == 'XOR':
+                reg[r] = S ^ T
+            elif op == 'NOT':
+                reg[r] = ~S
+            elif op == 'NEG':
+                reg[r] = -S
+            elif op == 'SWP':
+                if reg[r] > reg[s]:
+                    reg[r], reg[s] = reg[s], reg[r]
+            elif op == 'RND':
+                rnd = (rnd * 1103515245 + 12345) % (1 << 31)
+                reg[r] = rnd % abs(S) if S != 0 else 0
+            elif op == 'TLT':
+                reg[r] = int(S < T)
+            elif op == 'TLE':
+                reg[r] = int(S <= T)
+            elif op == 'TEQ':
+                reg[r] = int(S == T)
+            elif op == 'TNE':
+                reg[r] = int(S != T)
+            elif op == 'TGE':
+                reg[r] = int(S >= T)
+            elif op == 'TGT':
+                reg[r] = int(S > T)
+            elif op == 'SLT':
+                # the for loop test, the sign of the step is in r
+                reg[r] = int(S <= T) if reg[r] > 0 else int(S >= T)
+            elif op == 'MOV':
+                for i in range(max(0, T)):
+                    d[reg[r] - i] = d[S - i]
+            else:
+                return out, steps, 'bad instruction ' + op
+        except IndexError:
+            return out, steps, 'bad address'
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2:
+        sys.exit('usage: tm.py file.tm [input ...]')
+    out, steps, status = run(sys.argv[1], [int(x) for x in sys.argv[2:]],
+                             int(os.environ.get('TMLIMIT', '10000000')))
+    sys.stdout.write(''.join(out))
+    sys.stderr.write('steps %d\n' % steps)
+    if status != 'ok':
+        sys.stderr.write('tm: %s at step %d\n' % (status, steps))
+        sys.exit(1)